@@ -1850,6 +1850,7 @@ void Application::initTypes(void)
     App ::GeoFeature                ::init();
     App ::FeatureTest               ::init();
     App ::FeatureTestException      ::init();
+    App ::FeatureTestConcurrent     ::init();
     App ::FeaturePython             ::init();
     App ::GeometryPython            ::init();
     App ::Document                  ::init();
@@ -66,6 +66,13 @@ recompute path. Also, it enables more complicated dependencies beyond trees.
 # include <climits>
 # include <bitset>
 # include <random>
+# include <deque>
+# include <mutex>
+# include <condition_variable>
+# include <chrono>
+# include <thread>
+# include <fstream>
+# include <atomic>
 #endif
 
 #include <boost/algorithm/string.hpp>
@@ -90,6 +97,9 @@ recompute path. Also, it enables more complicated dependencies beyond trees.
 
 #include <QCoreApplication>
 #include <QCryptographicHash>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
 
 #include "Document.h"
 #include "Application.h"
@@ -156,16 +166,38 @@ typedef Traits::edge_descriptor Edge;
 typedef std::vector <size_t> Node;
 typedef std::vector <size_t> Path;
 
+// Notifications raised by an object while it is recomputed on a worker thread
+// of the parallel recompute. They are replayed on the main thread once the
+// object is done.
+static thread_local std::vector<std::function<void()> > *_RecomputeNotifications;
+
+// Check if the calling thread holds the GIL
+static bool _hasGIL()
+{
+#if PY_VERSION_HEX >= 0x03040000
+    return PyGILState_Check() != 0;
+#else
+    PyThreadState *state = PyGILState_GetThisThreadState();
+    return state && state == _PyThreadState_Current;
+#endif
+}
+
 namespace App {
 
 static bool _IsRestoring;
 static bool _IsRelabeling;
+// set if the dependency order must be rebuilt, see Document::_addDependencyOrder()
+static std::atomic<bool> _DepOrderDirty;
 // Pimpl class
 struct DocumentP
 {
     // Array to preserve the creation order of created objects
     std::vector<DocumentObject*> objectArray;
     std::unordered_set<App::DocumentObject*> touchedObjs;
+    // objects that may have to be recomputed, see Document::_getRecomputeList()
+    std::unordered_set<App::DocumentObject*> recomputeObjs;
+    // number of objects queued by the last recompute
+    size_t recomputeListSize;
     std::unordered_map<std::string,DocumentObject*> objectMap;
     std::unordered_map<long,DocumentObject*> objectIdMap;
     std::unordered_map<std::string, bool> partialLoadObjects;
@@ -178,7 +210,7 @@ struct DocumentP
     bool committing;
     std::bitset<32> StatusBits;
     int iUndoMode;
-    unsigned int UndoMemSize;
+    std::size_t UndoMemSize;
     unsigned int UndoMaxStackSize;
 #ifdef USE_OLD_DAG
     DependencyList DepList;
@@ -187,6 +219,16 @@ struct DocumentP
 #endif //USE_OLD_DAG
     std::multimap<const App::DocumentObject*, 
         std::unique_ptr<App::DocumentObjectExecReturn> > _RecomputeLog;
+    // guards the recompute log and undo transaction while objects are
+    // recomputed on worker threads
+    std::recursive_mutex recomputeMutex;
+    bool parallelRecompute;
+    // recompute profile, see Document::getRecomputeProfile()
+    bool profileRecompute;
+    std::chrono::steady_clock::time_point profileStart;
+    std::vector<Document::RecomputeRecord> recomputeProfile;
+    std::vector<App::DocumentObject*> profileObjects;
+    std::map<std::thread::id,int> profileThreads;
 
     DocumentP() {
         static std::random_device _RD;
@@ -208,6 +250,9 @@ struct DocumentP
         iUndoMode = 0;
         UndoMemSize = 0;
         UndoMaxStackSize = 20;
+        parallelRecompute = false;
+        profileRecompute = false;
+        recomputeListSize = 0;
     }
 
     void addRecomputeLog(const char *why, App::DocumentObject *obj) {
@@ -223,6 +268,9 @@ struct DocumentP
             delete returnCode;
             return;
         }
+        std::unique_lock<std::recursive_mutex> lock(recomputeMutex, std::defer_lock);
+        if(parallelRecompute)
+            lock.lock();
         _RecomputeLog.emplace(returnCode->Which, std::unique_ptr<DocumentObjectExecReturn>(returnCode));
         returnCode->Which->setStatus(ObjectStatus::Error,true);
     }
@@ -241,6 +289,50 @@ struct DocumentP
         return (--range.second)->second->Why.c_str();
     }
 
+    // Sort the recompute profile by start time and mark the longest chain of
+    // dependent executions. Must be called before any object is deleted.
+    void markCriticalPath() {
+        std::vector<size_t> order(recomputeProfile.size());
+        for(size_t i=0; i<order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return recomputeProfile[a].start < recomputeProfile[b].start;
+        });
+        std::vector<Document::RecomputeRecord> records;
+        std::vector<App::DocumentObject*> objs;
+        records.reserve(order.size());
+        objs.reserve(order.size());
+        for(auto i : order) {
+            records.push_back(std::move(recomputeProfile[i]));
+            objs.push_back(profileObjects[i]);
+        }
+
+        // A dependency always finishes before its dependent starts, so the
+        // start time order is also a topological order.
+        std::unordered_map<App::DocumentObject*, size_t> indices;
+        std::vector<double> finish(records.size());
+        std::vector<int> previous(records.size(),-1);
+        int last = -1;
+        for(size_t i=0; i<records.size(); ++i) {
+            finish[i] = records[i].duration;
+            for(auto dep : objs[i]->getOutList()) {
+                auto it = indices.find(dep);
+                if(it!=indices.end() && finish[it->second]+records[i].duration > finish[i]) {
+                    finish[i] = finish[it->second] + records[i].duration;
+                    previous[i] = (int)it->second;
+                }
+            }
+            indices[objs[i]] = i;
+            if(last<0 || finish[i] > finish[last])
+                last = (int)i;
+        }
+        for(; last>=0; last=previous[last])
+            records[last].critical = true;
+
+        recomputeProfile = std::move(records);
+        profileObjects.clear();
+    }
+
     static
     void findAllPathsAt(const std::vector <Node> &all_nodes, size_t id,
                         std::vector <Path> &all_paths, Path tmp);
@@ -950,6 +1042,7 @@ bool Document::undo(int id)
         Base::FlagToggler<bool> flag(d->undoing);
         // applying the undo
         mUndoTransactions.back()->apply(*this,false);
+        d->activeUndoTransaction->compact();
 
         // save the redo
         mRedoMap[d->activeUndoTransaction->getID()] = d->activeUndoTransaction;
@@ -990,6 +1083,7 @@ bool Document::redo(int id)
         // do the redo
         Base::FlagToggler<bool> flag(d->undoing);
         mRedoTransactions.back()->apply(*this,true);
+        d->activeUndoTransaction->compact();
 
         mUndoMap[d->activeUndoTransaction->getID()] = d->activeUndoTransaction;
         mUndoTransactions.push_back(d->activeUndoTransaction);
@@ -1184,6 +1278,7 @@ void Document::_commitTransaction(bool notify)
         Base::FlagToggler<> flag(d->committing);
         Application::TransactionSignaller signaller(false,true);
         int id = d->activeUndoTransaction->getID();
+        d->activeUndoTransaction->compact();
         mUndoTransactions.push_back(d->activeUndoTransaction);
         d->activeUndoTransaction = 0;
         // check the stack for the limits
@@ -1192,6 +1287,16 @@ void Document::_commitTransaction(bool notify)
             delete mUndoTransactions.front();
             mUndoTransactions.pop_front();
         }
+        if(d->UndoMemSize) {
+            // keep at least the transaction just committed
+            std::size_t size = getUndoMemSize();
+            while(mUndoTransactions.size() > 1 && size > d->UndoMemSize) {
+                size -= std::min<std::size_t>(size, mUndoTransactions.front()->getMemSize());
+                mUndoMap.erase(mUndoTransactions.front()->getID());
+                delete mUndoTransactions.front();
+                mUndoTransactions.pop_front();
+            }
+        }
         signalCommitTransaction(*this);
 
         if(notify)
@@ -1292,6 +1397,7 @@ void Document::clearDocument()
     this->d->objectArray.clear();
     this->d->objectMap.clear();
     this->d->objectIdMap.clear();
+    this->d->recomputeObjs.clear();
     this->d->lastObjectId = 0;
 }
 
@@ -1376,12 +1482,17 @@ int Document::getUndoMode(void) const
     return d->iUndoMode;
 }
 
-unsigned int Document::getUndoMemSize (void) const
+std::size_t Document::getUndoMemSize (void) const
 {
-    return d->UndoMemSize;
+    std::size_t size = 0;
+    for (auto transaction : mUndoTransactions)
+        size += transaction->getMemSize();
+    for (auto transaction : mRedoTransactions)
+        size += transaction->getMemSize();
+    return size;
 }
 
-void Document::setUndoLimit(unsigned int UndoMemSize)
+void Document::setUndoLimit(std::size_t UndoMemSize)
 {
     d->UndoMemSize = UndoMemSize;
 }
@@ -1449,20 +1560,67 @@ void Document::onChanged(const Property* prop)
 
 void Document::onBeforeChangeProperty(const TransactionalObject *Who, const Property *What)
 {
-    if(Who->isDerivedFrom(App::DocumentObject::getClassTypeId()))
-        signalBeforeChangeObject(*static_cast<const App::DocumentObject*>(Who), *What);
+    if(Who->isDerivedFrom(App::DocumentObject::getClassTypeId())) {
+        auto obj = static_cast<const App::DocumentObject*>(Who);
+        if(isParallelRecomputeThread()) {
+            // The observers may only be called on the main thread, so they
+            // get this notification after the change is done. See
+            // DocumentObject::allowConcurrentRecompute().
+            deferRecomputeNotification([this,obj,What]() {
+                signalBeforeChangeObject(*obj, *What);
+            });
+        } else
+            signalBeforeChangeObject(*obj, *What);
+    }
     if(!d->rollback && !_IsRelabeling) {
+        // The undo information must be recorded before the property changes,
+        // so it cannot be deferred like the notification above.
+        std::unique_lock<std::recursive_mutex> lock(d->recomputeMutex, std::defer_lock);
+        if(d->parallelRecompute)
+            lock.lock();
         _checkTransaction(0,What,__LINE__);
         if (d->activeUndoTransaction)
             d->activeUndoTransaction->addObjectChange(Who,What);
+        else if (What->isDerivedFrom(PropertyLists::getClassTypeId())) {
+            // The undo and redo steps may only keep the changed elements of a
+            // list, which can only be restored while the list holds the value
+            // they have been made against. So, before the list is changed
+            // without being recorded, they are replaced by full copies.
+            for (auto stack : {&mUndoTransactions, &mRedoTransactions}) {
+                auto it = std::find_if(stack->begin(), stack->end(),
+                        [=](Transaction *t) { return t->hasDelta(Who,What); });
+                if (it == stack->end())
+                    continue;
+                std::unique_ptr<Property> value(What->Copy());
+                for (auto rit = stack->rbegin(); rit != stack->rend(); ++rit)
+                    (*rit)->expandDelta(Who,What,*value);
+            }
+        }
     }
 }
 
 void Document::onChangedProperty(const DocumentObject *Who, const Property *What)
 {
+    if(isParallelRecomputeThread()) {
+        deferRecomputeNotification([this,Who,What]() {
+            signalChangedObject(*Who, *What);
+        });
+        return;
+    }
     signalChangedObject(*Who, *What);
 }
 
+bool Document::isParallelRecomputeThread()
+{
+    return _RecomputeNotifications != 0;
+}
+
+void Document::deferRecomputeNotification(std::function<void()> &&notify)
+{
+    assert(_RecomputeNotifications);
+    _RecomputeNotifications->push_back(std::move(notify));
+}
+
 void Document::setTransactionMode(int iMode)
 {
     d->iTransactionMode = iMode;
@@ -2157,7 +2315,7 @@ unsigned int Document::getMemSize (void) const
     size += PropertyContainer::getMemSize();
 
     // Undo Redo size
-    size += getUndoMemSize();
+    size += static_cast<unsigned int>(getUndoMemSize());
 
     return size;
 }
@@ -2393,6 +2551,7 @@ void Document::restore (const char *filename,
     d->objectArray.clear();
     d->objectMap.clear();
     d->objectIdMap.clear();
+    d->recomputeObjs.clear();
     d->lastObjectId = 0;
 
     if(signal) {
@@ -2768,6 +2927,204 @@ static void _buildDependencyList(const std::vector<App::DocumentObject*> &object
     }
 }
 
+// The dependency order is a global order of all objects in which any object
+// comes after the objects it depends on. It is updated incrementally on each
+// new link using the algorithm of Pearce and Kelly, which only reorders the
+// objects placed between the two linked objects. Removing a link never breaks
+// the order. The order is rebuilt from scratch on the next query after it has
+// been marked dirty, e.g. while restoring a document.
+void Document::_addDependencyOrder(DocumentObject *obj, DocumentObject *dep)
+{
+    if(_DepOrderDirty || dep->_depOrder < obj->_depOrder)
+        return;
+
+    // Objects are restored in an arbitrary order, and the links changed on a
+    // worker thread of the parallel recompute must not touch other objects.
+    if(_IsRestoring || _RecomputeNotifications || obj == dep) {
+        _DepOrderDirty = true;
+        return;
+    }
+
+    unsigned long lower = obj->_depOrder;
+    unsigned long upper = dep->_depOrder;
+    std::unordered_set<DocumentObject*> visited;
+    std::vector<DocumentObject*> stack;
+
+    // objects depending on obj that are currently ordered before dep
+    std::vector<DocumentObject*> forward;
+    visited.insert(obj);
+    stack.push_back(obj);
+    while(stack.size()) {
+        auto o = stack.back();
+        stack.pop_back();
+        forward.push_back(o);
+        for(auto in : o->getInList()) {
+            if(in == dep) {
+                // cyclic dependency, leave it to the full graph
+                _DepOrderDirty = true;
+                return;
+            }
+            if(in->_depOrder < upper && visited.insert(in).second)
+                stack.push_back(in);
+        }
+    }
+
+    // objects dep depends on that are currently ordered after obj
+    std::vector<DocumentObject*> backward;
+    visited.insert(dep);
+    stack.push_back(dep);
+    while(stack.size()) {
+        auto o = stack.back();
+        stack.pop_back();
+        backward.push_back(o);
+        for(auto out : o->getOutList()) {
+            if(out && out->_depOrder > lower && visited.insert(out).second)
+                stack.push_back(out);
+        }
+    }
+
+    // Reuse the order of both sets, with all of the backward set placed
+    // before the forward set and the relative order inside each set kept.
+    auto cmp = [](const DocumentObject *a, const DocumentObject *b) {
+        return a->_depOrder < b->_depOrder;
+    };
+    std::sort(forward.begin(),forward.end(),cmp);
+    std::sort(backward.begin(),backward.end(),cmp);
+    std::vector<unsigned long> orders;
+    orders.reserve(forward.size()+backward.size());
+    for(auto o : backward)
+        orders.push_back(o->_depOrder);
+    for(auto o : forward)
+        orders.push_back(o->_depOrder);
+    std::sort(orders.begin(),orders.end());
+    auto it = orders.begin();
+    for(auto o : backward)
+        o->_depOrder = *it++;
+    for(auto o : forward)
+        o->_depOrder = *it++;
+}
+
+void Document::_rebuildDependencyOrder()
+{
+    _DepOrderDirty = false;
+
+    // depth first post order of the out lists of all objects, which places
+    // the dependencies of an object before it
+    std::vector<DocumentObject*> objs;
+    std::vector<unsigned long> orders;
+    std::unordered_set<DocumentObject*> visited;
+    std::vector<std::pair<DocumentObject*,size_t> > stack;
+    for(auto doc : GetApplication().getDocuments()) {
+        for(auto obj : doc->d->objectArray) {
+            if(!visited.insert(obj).second)
+                continue;
+            stack.emplace_back(obj,0);
+            while(stack.size()) {
+                auto o = stack.back().first;
+                auto &outList = o->getOutList();
+                if(stack.back().second < outList.size()) {
+                    auto dep = outList[stack.back().second++];
+                    if(dep && dep->getNameInDocument() && visited.insert(dep).second)
+                        stack.emplace_back(dep,0);
+                    continue;
+                }
+                stack.pop_back();
+                objs.push_back(o);
+                orders.push_back(o->_depOrder);
+            }
+        }
+    }
+    std::sort(orders.begin(),orders.end());
+    for(size_t i=0; i<objs.size(); ++i)
+        objs[i]->_depOrder = orders[i];
+}
+
+bool Document::_sortDependencyList(std::vector<App::DocumentObject*> &objs)
+{
+    for(int retry=0;;++retry) {
+        if(_DepOrderDirty)
+            _rebuildDependencyOrder();
+
+        // The order is checked against the out lists, as not all kinds of
+        // links may report the change, and to detect cyclic dependencies.
+        bool valid = true;
+        for(auto obj : objs) {
+            for(auto dep : obj->getOutList()) {
+                if(dep && dep->getNameInDocument() && dep->_depOrder >= obj->_depOrder) {
+                    valid = false;
+                    break;
+                }
+            }
+            if(!valid)
+                break;
+        }
+        if(valid)
+            break;
+        _DepOrderDirty = true;
+        if(retry)
+            return false;
+    }
+
+    std::sort(objs.begin(),objs.end(),
+        [](const DocumentObject *a, const DocumentObject *b) {
+            return a->_depOrder < b->_depOrder;
+        });
+    return true;
+}
+
+bool Document::_getRecomputeList(std::vector<App::DocumentObject*> &objs, int options) const
+{
+    // Objects of other documents that this document depends on are only
+    // collected by the full dependency graph.
+    if(!(options & DepNoXLinked)) {
+        auto outList = PropertyXLink::getDocumentOutList(const_cast<Document*>(this));
+        auto it = outList.find(const_cast<Document*>(this));
+        if(it != outList.end()) {
+            for(auto doc : it->second) {
+                if(doc != this)
+                    return false;
+            }
+        }
+    }
+
+    std::unordered_set<App::DocumentObject*> objSet(objs.begin(),objs.end());
+    for(auto it=d->recomputeObjs.begin(); it!=d->recomputeObjs.end();) {
+        auto obj = *it;
+        if(!obj->isTouched() && !obj->mustRecompute()) {
+            it = d->recomputeObjs.erase(it);
+            continue;
+        }
+        ++it;
+        if(!objSet.insert(obj).second)
+            continue;
+        objs.push_back(obj);
+        for(size_t i=objs.size()-1; i<objs.size(); ++i) {
+            for(auto in : objs[i]->getInList()) {
+                if(in->getDocument() == this && in->getNameInDocument()
+                        && objSet.insert(in).second)
+                    objs.push_back(in);
+            }
+        }
+    }
+    return _sortDependencyList(objs);
+}
+
+void Document::_setRecomputeObject(DocumentObject *obj, bool on)
+{
+    std::unique_lock<std::recursive_mutex> lock(d->recomputeMutex, std::defer_lock);
+    if(d->parallelRecompute)
+        lock.lock();
+    if(!on)
+        d->recomputeObjs.erase(obj);
+    else {
+        // Objects that are not (or no longer) part of the document, e.g. kept
+        // by the undo stack, are not tracked.
+        auto it = d->objectIdMap.find(obj->getID());
+        if(it!=d->objectIdMap.end() && it->second==obj)
+            d->recomputeObjs.insert(obj);
+    }
+}
+
 std::vector<App::DocumentObject*> Document::getDependencyList(
     const std::vector<App::DocumentObject*>& objectArray, int options)
 {
@@ -3128,7 +3485,16 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
     }
     std::reverse(topoSortedObjects.begin(),topoSortedObjects.end());
 #else
-    auto topoSortedObjects = getDependencyList(objs.empty()?d->objectArray:objs,DepSort|options);
+    // A full recompute only visits the objects that must be recomputed and
+    // their dependent objects.
+    std::vector<App::DocumentObject*> topoSortedObjects;
+    bool partialList = false;
+    if(objs.empty() && _getRecomputeList(topoSortedObjects,options)) {
+        partialList = true;
+        FC_LOG("Recompute " << topoSortedObjects.size() << " of "
+                << d->objectArray.size() << " objects");
+    } else
+        topoSortedObjects = getDependencyList(objs.empty()?d->objectArray:objs,DepSort|options);
 #endif
     for(auto obj : topoSortedObjects)
         obj->setStatus(ObjectStatus::PendingRecompute,true);
@@ -3137,6 +3503,24 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
             "User parameter:BaseApp/Preferences/Document");
     bool canAbort = hGrp->GetBool("CanAbortRecompute",true);
 
+    d->recomputeProfile.clear();
+    d->profileObjects.clear();
+    d->profileThreads.clear();
+    d->profileRecompute = hGrp->GetBool("RecomputeProfile",false);
+    if(d->profileRecompute) {
+        d->profileThreads[std::this_thread::get_id()] = 0;
+        d->profileStart = std::chrono::steady_clock::now();
+    }
+
+    // Parallel recompute is opt-in, because it requires the features to be
+    // thread safe. See DocumentObject::allowConcurrentRecompute().
+    int threads = 0;
+    if(hGrp->GetBool("ParallelRecompute",false)) {
+        threads = hGrp->GetInt("RecomputeThreads",0);
+        if(threads <= 0)
+            threads = QThread::idealThreadCount();
+    }
+
     std::set<App::DocumentObject *> filter;
     size_t idx = 0;
 
@@ -3149,6 +3533,13 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
             if(canAbort)
                 seq.reset(new Base::SequencerLauncher("Recompute...", topoSortedObjects.size()));
             FC_LOG("Recompute pass " << passes);
+            if(threads > 1) {
+                bool aborted = false;
+                objectCount += _recomputeParallel(topoSortedObjects,idx,filter,
+                                                  hasError,aborted,seq.get(),threads);
+                if(aborted)
+                    passes = 2;
+            }
             for (;idx<topoSortedObjects.size();(seq?seq->next(true):true),++idx) {
                 auto obj = topoSortedObjects[idx];
                 if(!obj->getNameInDocument() || filter.find(obj)!=filter.end())
@@ -3181,6 +3572,33 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
                         inObjIt->enforceRecompute();
                 }
             }
+            // An object may touch other objects while executing. If those are
+            // not in the list yet, add them and their dependent objects, so
+            // that the check below lets the next pass recompute them.
+            if(partialList) {
+                std::unordered_set<App::DocumentObject*> listed(
+                        topoSortedObjects.begin(),topoSortedObjects.end());
+                bool touched = false;
+                for(auto obj : d->recomputeObjs) {
+                    if(!listed.count(obj) && obj->isTouched()) {
+                        touched = true;
+                        break;
+                    }
+                }
+                if(touched) {
+                    if(_getRecomputeList(topoSortedObjects,options)) {
+                        FC_LOG("Objects touched during recompute, recompute "
+                                << topoSortedObjects.size() << " objects");
+                    } else {
+                        FC_LOG("Objects touched during recompute, use the full list");
+                        partialList = false;
+                        topoSortedObjects = getDependencyList(d->objectArray,DepSort|options);
+                    }
+                    for(auto obj : topoSortedObjects)
+                        obj->setStatus(ObjectStatus::PendingRecompute,true);
+                    idx = topoSortedObjects.size();
+                }
+            }
             // check if all objects are recomputed but still thouched 
             for (size_t i=0;i<topoSortedObjects.size();++i) {
                 auto obj = topoSortedObjects[i];
@@ -3205,6 +3623,12 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
 
     FC_TIME_LOG(t2, "Recompute");
 
+    if(d->profileRecompute) {
+        d->profileRecompute = false;
+        d->markCriticalPath();
+    }
+
+    d->recomputeListSize = topoSortedObjects.size();
     for(auto obj : topoSortedObjects) {
         if(!obj->getNameInDocument())
             continue;
@@ -3398,11 +3822,264 @@ const char * Document::getErrorDescription(const App::DocumentObject*Obj) const
     return d->findRecomputeLog(Obj);
 }
 
+namespace App {
+// Records a profile entry for the execution of an object if enabled
+class RecomputeProfiler
+{
+public:
+    RecomputeProfiler(DocumentP *d, DocumentObject *obj)
+        : d(d), obj(obj), memory(0)
+    {
+        if(!d->profileRecompute)
+            return;
+        for(auto prop : obj->getPropertyList()) {
+            if(prop->isTouched()) {
+                if(reason.size())
+                    reason += ", ";
+                reason += prop->getName();
+            }
+        }
+        if(reason.empty())
+            reason = obj->testStatus(ObjectStatus::Enforce)?"Enforce":"MustExecute";
+        memory = (long)obj->getMemSize();
+        start = std::chrono::steady_clock::now();
+    }
+
+    ~RecomputeProfiler() {
+        if(!d->profileRecompute)
+            return;
+        auto end = std::chrono::steady_clock::now();
+        Document::RecomputeRecord record;
+        record.object = obj->getFullName();
+        record.reason = std::move(reason);
+        record.start = std::chrono::duration<double>(start - d->profileStart).count();
+        record.duration = std::chrono::duration<double>(end - start).count();
+        record.memory = (long)obj->getMemSize() - memory;
+        record.error = obj->testStatus(ObjectStatus::Error);
+        record.critical = false;
+
+        std::unique_lock<std::recursive_mutex> lock(d->recomputeMutex, std::defer_lock);
+        if(d->parallelRecompute)
+            lock.lock();
+        auto res = d->profileThreads.emplace(std::this_thread::get_id(),(int)d->profileThreads.size());
+        record.thread = res.first->second;
+        d->recomputeProfile.push_back(std::move(record));
+        d->profileObjects.push_back(obj);
+    }
+
+private:
+    DocumentP *d;
+    DocumentObject *obj;
+    std::string reason;
+    long memory;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Thread pool job of the parallel recompute
+class RecomputeJob : public QRunnable
+{
+public:
+    RecomputeJob(std::function<void()> &&func)
+        : func(std::move(func))
+    {
+        setAutoDelete(true);
+    }
+    virtual void run() override {
+        func();
+    }
+
+private:
+    std::function<void()> func;
+};
+} // namespace App
+
+/*!
+  Recomputes the objects of \a objs starting at \a idx in the same way as the
+  serial loop in recompute(), but dispatches an object to the thread pool as
+  soon as all of its dependencies inside the queue are done. Only objects that
+  return true in DocumentObject::allowConcurrentRecompute() are run on worker
+  threads, all others are recomputed on the calling thread. Any notification
+  raised on a worker thread is replayed on the calling thread once the object
+  is done, followed by the same post recompute handling as in the serial case.
+  On return \a idx is set to the end of \a objs.
+ */
+int Document::_recomputeParallel(const std::vector<App::DocumentObject*> &objs, size_t &idx,
+        std::set<App::DocumentObject*> &filter, bool *hasError, bool &aborted,
+        Base::SequencerLauncher *seq, int threads)
+{
+    int objectCount = 0;
+    size_t count = objs.size() - idx;
+
+    // Only dependencies inside the queue are counted, any other object is
+    // either done or not going to be recomputed. Links pointing forward in
+    // the sorted queue (i.e. cyclic ones) are ignored to keep the serial order.
+    std::unordered_map<App::DocumentObject*, size_t> indices;
+    for(size_t i=0; i<count; ++i)
+        indices.emplace(objs[idx+i],i);
+    std::vector<int> pending(count,0);
+    std::vector<std::vector<size_t> > dependents(count);
+    std::set<size_t> ready;
+    for(size_t i=0; i<count; ++i) {
+        auto obj = objs[idx+i];
+        if(obj->getNameInDocument()) {
+            std::set<size_t> deps;
+            for(auto dep : obj->getOutList()) {
+                auto it = indices.find(dep);
+                if(it!=indices.end() && it->second<i && deps.insert(it->second).second) {
+                    ++pending[i];
+                    dependents[it->second].push_back(i);
+                }
+            }
+        }
+        if(!pending[i])
+            ready.insert(i);
+    }
+
+    struct Result {
+        size_t index;
+        int res;
+        std::vector<std::function<void()> > notifications;
+    };
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<Result> results;
+    size_t finished = 0;
+    int running = 0;
+
+    auto finish = [&](size_t i) {
+        ++finished;
+        for(auto j : dependents[i]) {
+            if(--pending[j] == 0)
+                ready.insert(j);
+        }
+        if(seq)
+            seq->next(true);
+    };
+
+    auto postRecompute = [&](size_t i, int res, bool doRecompute) {
+        auto obj = objs[idx+i];
+        if(res) {
+            if(hasError)
+                *hasError = true;
+            if(res < 0) {
+                aborted = true;
+                return;
+            }
+            // if something happened filter all object in its
+            // inListRecursive from the queue then proceed
+            obj->getInListEx(filter,true);
+            filter.insert(obj);
+            return;
+        }
+        if(obj->isTouched() || doRecompute) {
+            signalRecomputedObject(*obj);
+            obj->purgeTouched();
+            // set all dependent object touched to force recompute
+            for (auto inObjIt : obj->getInList())
+                inObjIt->enforceRecompute();
+        }
+    };
+
+    auto waitResults = [&]() {
+        std::deque<Result> done;
+        {
+            // The workers may need the GIL, so release it while waiting in
+            // case this thread holds it
+            std::unique_ptr<Base::PyGILStateRelease> unlock;
+            if(_hasGIL())
+                unlock.reset(new Base::PyGILStateRelease);
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&results]() {return !results.empty();});
+            done.swap(results);
+        }
+        running -= (int)done.size();
+        for(auto &result : done) {
+            for(auto &notify : result.notifications)
+                notify();
+        }
+        return done;
+    };
+
+    d->parallelRecompute = true;
+    try {
+        while(finished < count) {
+            while(!aborted && ready.size()) {
+                size_t i = *ready.begin();
+                auto obj = objs[idx+i];
+                bool concurrent = obj->getNameInDocument() && obj->allowConcurrentRecompute();
+                if(concurrent && running >= threads)
+                    break;
+                ready.erase(ready.begin());
+                if(!obj->getNameInDocument() || filter.find(obj)!=filter.end()) {
+                    finish(i);
+                    continue;
+                }
+                // ask the object if it should be recomputed
+                if(!obj->mustRecompute()) {
+                    postRecompute(i,0,false);
+                    finish(i);
+                    continue;
+                }
+                ++objectCount;
+                if(!concurrent) {
+                    postRecompute(i,_recomputeFeature(obj),true);
+                    finish(i);
+                    continue;
+                }
+                ++running;
+                QThreadPool::globalInstance()->start(new RecomputeJob([&,i,obj]() {
+                    Result result;
+                    result.index = i;
+                    _RecomputeNotifications = &result.notifications;
+                    // console messages are replayed in order with the other notifications
+                    Base::ConsoleSingleton::ThreadHandler console =
+                        [](Base::ConsoleSingleton::FreeCAD_ConsoleMsgType type, const char *msg) {
+                            std::string text(msg);
+                            deferRecomputeNotification([type,text]() {
+                                Base::Console().Notify(type,text.c_str());
+                            });
+                        };
+                    Base::ConsoleSingleton::SetThreadHandler(&console);
+                    try {
+                        result.res = _recomputeFeature(obj);
+                    } catch (...) {
+                        d->addRecomputeLog("Unknown exception!",obj);
+                        result.res = 1;
+                    }
+                    Base::ConsoleSingleton::SetThreadHandler(0);
+                    _RecomputeNotifications = 0;
+                    std::lock_guard<std::mutex> lock(mutex);
+                    results.push_back(std::move(result));
+                    cond.notify_one();
+                }));
+            }
+            if(!running)
+                break;
+            for(auto &result : waitResults()) {
+                postRecompute(result.index,result.res,true);
+                finish(result.index);
+            }
+        }
+    } catch (...) {
+        // The jobs refer to this stack frame, so drain them before leaving
+        while(running)
+            waitResults();
+        d->parallelRecompute = false;
+        idx = objs.size();
+        throw;
+    }
+    d->parallelRecompute = false;
+    idx = objs.size();
+    return objectCount;
+}
+
 // call the recompute of the Feature and handle the exceptions and errors.
 int Document::_recomputeFeature(DocumentObject* Feat)
 {
     FC_LOG("Recomputing " << Feat->getFullName());
 
+    RecomputeProfiler profiler(d,Feat);
+
     DocumentObjectExecReturn  *returnCode = 0;
     try {
         returnCode = Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteNonOutput);
@@ -3455,6 +4132,70 @@ int Document::_recomputeFeature(DocumentObject* Feat)
     return 0;
 }
 
+const std::vector<Document::RecomputeRecord> &Document::getRecomputeProfile() const
+{
+    return d->recomputeProfile;
+}
+
+size_t Document::getRecomputeListSize() const
+{
+    return d->recomputeListSize;
+}
+
+static void writeJsonString(std::ostream &str, const std::string &s)
+{
+    str << '"';
+    for(auto c : s) {
+        switch(c) {
+        case '"':
+            str << "\\\"";
+            break;
+        case '\\':
+            str << "\\\\";
+            break;
+        default:
+            if((unsigned char)c < 0x20) {
+                char buf[8];
+                snprintf(buf,sizeof(buf),"\\u%04x",(int)c);
+                str << buf;
+            } else
+                str << c;
+        }
+    }
+    str << '"';
+}
+
+bool Document::saveRecomputeProfile(const char *filename) const
+{
+    Base::FileInfo fi(filename);
+    Base::ofstream str(fi, std::ios::out | std::ios::binary);
+    if(!str)
+        return false;
+
+    // Complete events of the Trace Event Format, time stamps are in micro seconds
+    str << "{\"traceEvents\":[";
+    bool first = true;
+    for(auto &record : d->recomputeProfile) {
+        if(!first)
+            str << ',';
+        first = false;
+        str << "\n{\"name\":";
+        writeJsonString(str,record.object);
+        str << ",\"cat\":\"recompute\",\"ph\":\"X\",\"pid\":1"
+            << ",\"tid\":" << record.thread
+            << ",\"ts\":" << (long long)(record.start*1e6)
+            << ",\"dur\":" << (long long)(record.duration*1e6)
+            << ",\"args\":{\"reason\":";
+        writeJsonString(str,record.reason);
+        str << ",\"memory\":" << record.memory
+            << ",\"error\":" << (record.error?"true":"false")
+            << ",\"critical\":" << (record.critical?"true":"false")
+            << "}}";
+    }
+    str << "\n]}\n";
+    return str.good();
+}
+
 bool Document::recomputeFeature(DocumentObject* Feat, bool recursive)
 {
     // delete recompute log
@@ -3519,6 +4260,7 @@ DocumentObject * Document::addObject(const char* sType, const char* pObjectName,
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    d->recomputeObjs.insert(pcObject);
     // insert in the adjacence list and reference through the ConectionMap
     //_DepConMap[pcObject] = add_vertex(_DepList);
 
@@ -3620,6 +4362,7 @@ std::vector<DocumentObject *> Document::addObjects(const char* sType, const std:
         pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
         // insert in the vector
         d->objectArray.push_back(pcObject);
+        d->recomputeObjs.insert(pcObject);
 
         pcObject->Label.setValue(ObjectName);
 
@@ -3684,6 +4427,7 @@ void Document::addObject(DocumentObject* pcObject, const char* pObjectName)
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    d->recomputeObjs.insert(pcObject);
 
     pcObject->Label.setValue( ObjectName );
 
@@ -3711,6 +4455,7 @@ void Document::_addObject(DocumentObject* pcObject, const char* pObjectName)
     if(!pcObject->_Id) pcObject->_Id = ++d->lastObjectId;
     d->objectIdMap[pcObject->_Id] = pcObject;
     d->objectArray.push_back(pcObject);
+    d->recomputeObjs.insert(pcObject);
     // cache the pointer to the name string in the Object (for performance of DocumentObject::getNameInDocument())
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
 
@@ -3840,6 +4585,7 @@ void Document::removeObject(const char* sName)
             break;
         }
     }
+    d->recomputeObjs.erase(pos->second);
 
     pos->second->setStatus(ObjectStatus::Remove, false); // Unset the bit to be on the safe side
     d->objectIdMap.erase(pos->second->_Id);
@@ -3913,6 +4659,7 @@ void Document::_removeObject(DocumentObject* pcObject)
             break;
         }
     }
+    d->recomputeObjs.erase(pcObject);
 
     // for a rollback delete the object
     if (d->rollback) {
@@ -33,6 +33,7 @@
 #include "PropertyLinks.h"
 
 #include <map>
+#include <set>
 #include <vector>
 #include <stack>
 #include <functional>
@@ -41,6 +42,7 @@
 
 namespace Base {
     class Writer;
+    class SequencerLauncher;
 }
 
 namespace App
@@ -337,6 +339,43 @@ public:
     bool testStatus(Status pos) const;
     /// set the status bits
     void setStatus(Status pos, bool on);
+    /// Profile record of an object executed by the last recompute()
+    struct RecomputeRecord {
+        /// full name of the object
+        std::string object;
+        /// names of the touched properties, or why else the object was recomputed
+        std::string reason;
+        /// start time in seconds since the start of the recompute
+        double start;
+        /// wall time of the execution in seconds
+        double duration;
+        /// change of the memory size of the object's properties in bytes
+        long memory;
+        /// 0 for the main thread, or the index of the recompute worker thread
+        int thread;
+        /// whether the execution failed
+        bool error;
+        /// whether the object lies on the critical path of the recompute
+        bool critical;
+    };
+    /** Return the profile of the last recompute
+     *
+     * The profile is only recorded if the Document preference
+     * 'RecomputeProfile' is set. The records are sorted by start time.
+     */
+    const std::vector<RecomputeRecord> &getRecomputeProfile() const;
+    /// Return the number of objects queued by the last recompute()
+    size_t getRecomputeListSize() const;
+    /// Save the profile of the last recompute in Chrome trace event format
+    bool saveRecomputeProfile(const char *filename) const;
+    /// check if the calling thread is recomputing an object for a parallel recompute
+    static bool isParallelRecomputeThread();
+    /** Queue a notification raised by an object recomputed on a worker thread
+     *
+     * The notification is replayed on the main thread once the object is
+     * done. Must only be called if isParallelRecomputeThread() returns true.
+     */
+    static void deferRecomputeNotification(std::function<void()> &&notify);
     //@}
 
 
@@ -386,9 +425,9 @@ public:
     /// If no transaction is open true is returned.
     bool isTransactionEmpty() const;
     /// Set the Undo limit in Byte!
-    void setUndoLimit(unsigned int UndoMemSize=0);
+    void setUndoLimit(std::size_t UndoMemSize=0);
     /// Returns the actual memory consumption of the Undo redo stuff.
-    unsigned int getUndoMemSize (void) const;
+    std::size_t getUndoMemSize (void) const;
     /// Set the Undo limit as stack size
     void setMaxUndoStackSize(unsigned int UndoMaxStackSize=20);
     /// Set the Undo limit as stack size
@@ -520,11 +559,35 @@ protected:
     /// helper which Recompute only this feature
     /// @return 0 if succeeded, 1 if failed, -1 if aborted by user.
     int _recomputeFeature(DocumentObject* Feat);
+    /// helper of recompute() which schedules independent objects onto a thread pool
+    int _recomputeParallel(const std::vector<App::DocumentObject*> &objs, size_t &idx,
+            std::set<App::DocumentObject*> &filter, bool *hasError, bool &aborted,
+            Base::SequencerLauncher *seq, int threads);
     void _clearRedos();
 
     /// refresh the internal dependency graph
     void _rebuildDependencyList(
         const std::vector<App::DocumentObject*> &objs = std::vector<App::DocumentObject*>());
+    /// update the dependency order for a new link from \a obj to \a dep
+    static void _addDependencyOrder(DocumentObject *obj, DocumentObject *dep);
+    /// rebuild the dependency order of all objects from their out lists
+    static void _rebuildDependencyOrder();
+    /** sort the objects by the dependency order
+     * @return false if the order is not consistent with the out lists of the
+     * objects, e.g. because of cyclic dependencies.
+     */
+    static bool _sortDependencyList(std::vector<App::DocumentObject*> &objs);
+    /** get the objects that must be recomputed and all their dependent objects
+     * in dependency order
+     *
+     * Only the objects tracked by _setRecomputeObject() are checked. Objects
+     * already in \a objs are kept in the sorted list.
+     * @return false if the list cannot be obtained from the dependency order,
+     * in which case the full dependency graph must be used.
+     */
+    bool _getRecomputeList(std::vector<App::DocumentObject*> &objs, int options) const;
+    /// track an object that may have to be recomputed, called on touch and purgeTouched
+    void _setRecomputeObject(DocumentObject *obj, bool on);
 
     std::string getTransientDirectoryName(const std::string& uuid, const std::string& filename) const;
 
@@ -24,6 +24,8 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <atomic>
+# include <mutex>
 #endif
 
 #include <Base/Writer.h>
@@ -56,12 +58,19 @@ PROPERTY_SOURCE(App::DocumentObject, App::TransactionalObject)
 
 DocumentObjectExecReturn *DocumentObject::StdReturn = 0;
 
+// new objects are ordered last in the dependency order
+static std::atomic<unsigned long> _DepOrderCounter;
+
+// Guards the back links, which may be changed by objects recomputed on the
+// worker threads of the parallel recompute
+static std::recursive_mutex _BackLinkMutex;
+
 //===========================================================================
 // DocumentObject
 //===========================================================================
 
 DocumentObject::DocumentObject(void)
-    : ExpressionEngine(),_pDoc(0),pcNameInDocument(0),_Id(0)
+    : ExpressionEngine(),_pDoc(0),pcNameInDocument(0),_Id(0),_depOrder(++_DepOrderCounter)
 {
     // define Label of type 'Output' to avoid being marked as touched after relabeling
     ADD_PROPERTY_TYPE(Label,("Unnamed"),"Base",Prop_Output,"User name of the object (UTF8)");
@@ -143,8 +152,16 @@ void DocumentObject::touch(bool noRecompute)
     if(!noRecompute)
         StatusBits.set(ObjectStatus::Enforce);
     StatusBits.set(ObjectStatus::Touch);
-    if (_pDoc)
-        _pDoc->signalTouchedObject(*this);
+    if (_pDoc) {
+        _pDoc->_setRecomputeObject(this,true);
+        if(Document::isParallelRecomputeThread()) {
+            Document::deferRecomputeNotification([this]() {
+                if (_pDoc)
+                    _pDoc->signalTouchedObject(*this);
+            });
+        } else
+            _pDoc->signalTouchedObject(*this);
+    }
 }
 
 /**
@@ -156,6 +173,15 @@ bool DocumentObject::isTouched() const
     return ExpressionEngine.isTouched() || StatusBits.test(ObjectStatus::Touch);
 }
 
+void DocumentObject::purgeTouched()
+{
+    StatusBits.reset(ObjectStatus::Touch);
+    StatusBits.reset(ObjectStatus::Enforce);
+    setPropertyStatus(0,false);
+    if (_pDoc)
+        _pDoc->_setRecomputeObject(this,false);
+}
+
 /**
  * @brief Enforces this document object to be recomputed.
  * This can be useful to recompute the feature without
@@ -678,6 +704,12 @@ void DocumentObject::onBeforeChange(const Property* prop)
     if (_pDoc)
         onBeforeChangeProperty(_pDoc, prop);
 
+    if(Document::isParallelRecomputeThread()) {
+        Document::deferRecomputeNotification([this,prop]() {
+            signalBeforeChange(*this,*prop);
+        });
+        return;
+    }
     signalBeforeChange(*this,*prop);
 }
 
@@ -725,10 +757,19 @@ void DocumentObject::onChanged(const Property* prop)
     //call the parent for appropriate handling
     TransactionalObject::onChanged(prop);
 
-    // Now signal the view provider
-    if (_pDoc)
+    // Now signal the view provider. Any change may require a recompute,
+    // e.g. of a touched expression, so let the document check this object.
+    if (_pDoc) {
+        _pDoc->_setRecomputeObject(this,true);
         _pDoc->onChangedProperty(this,prop);
+    }
 
+    if(Document::isParallelRecomputeThread()) {
+        Document::deferRecomputeNotification([this,prop]() {
+            signalChanged(*this,*prop);
+        });
+        return;
+    }
     signalChanged(*this,*prop);
 }
 
@@ -954,6 +995,7 @@ void App::DocumentObject::_removeBackLink(DocumentObject* rmvObj)
 #ifndef USE_OLD_DAG
     //do not use erase-remove idom, as this erases ALL entries that match. we only want to remove a
     //single one.
+    std::lock_guard<std::recursive_mutex> lock(_BackLinkMutex);
     auto it = std::find(_inList.begin(), _inList.end(), rmvObj);
     if(it != _inList.end())
         _inList.erase(it);
@@ -969,7 +1011,9 @@ void App::DocumentObject::_addBackLink(DocumentObject* newObj)
     //removal: If a link loses this object it removes the backlink. If we would have added it only once
     //this removal would clear the object from the inlist, even though there may be other link properties 
     //from this object that link to us.
+    std::lock_guard<std::recursive_mutex> lock(_BackLinkMutex);
     _inList.push_back(newObj);
+    Document::_addDependencyOrder(newObj,this);
 #else
     (void)newObj;
 #endif //USE_OLD_DAG    
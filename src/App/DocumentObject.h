@@ -143,11 +143,7 @@ public:
     /// Test if this document object must be recomputed
     bool mustRecompute(void) const;
     /// reset this document object touched
-    void purgeTouched(void) {
-        StatusBits.reset(ObjectStatus::Touch);
-        StatusBits.reset(ObjectStatus::Enforce);
-        setPropertyStatus(0,false);
-    }
+    void purgeTouched(void);
     /// set this feature to error
     bool isError(void) const {return  StatusBits.test(ObjectStatus::Error);}
     bool isValid(void) const {return !StatusBits.test(ObjectStatus::Error);}
@@ -508,6 +504,18 @@ public:
     virtual bool adjustRelativeLinks(const std::set<App::DocumentObject*> &inList,
             std::set<App::DocumentObject*> *visited=0);
 
+    /** Whether the object can be recomputed on a worker thread
+     *
+     * Used by Document::recompute() when parallel recompute is enabled. The
+     * execute() of such an object must not access anything other than itself
+     * and its dependencies, and must not call into Python. Notifications of
+     * property changes and console messages are deferred to the main thread
+     * by the document. Therefore signalBeforeChangeObject is only emitted
+     * once the change is done, and such an object and its observers must not
+     * rely on the old value being present at that time.
+     */
+    virtual bool allowConcurrentRecompute() const {return false;}
+
     /** allow partial loading of dependent objects
      *
      * @return Returns 0 means do not support partial loading. 1 means allow
@@ -617,6 +625,9 @@ private:
     mutable std::vector<App::DocumentObject *> _outList;
     mutable std::unordered_map<const char *, App::DocumentObject*, CStringHasher, CStringHasher> _outListMap;
     mutable bool _outListCached = false;
+    // position in the dependency order maintained by the document, any
+    // object is ordered after the objects it depends on
+    unsigned long _depOrder;
 };
 
 } //namespace App
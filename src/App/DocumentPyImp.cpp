@@ -491,6 +491,44 @@ PyObject*  DocumentPy::recompute(PyObject * args)
     } PY_CATCH;
 }
 
+PyObject*  DocumentPy::getRecomputeProfile(PyObject * args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return NULL;
+    PY_TRY {
+        Py::List ret;
+        for(auto &record : getDocumentPtr()->getRecomputeProfile()) {
+            Py::Dict dict;
+            dict.setItem("object",Py::String(record.object));
+            dict.setItem("reason",Py::String(record.reason));
+            dict.setItem("start",Py::Float(record.start));
+            dict.setItem("duration",Py::Float(record.duration));
+            dict.setItem("memory",Py::Long(record.memory));
+            dict.setItem("thread",Py::Int(record.thread));
+            dict.setItem("error",Py::Boolean(record.error));
+            dict.setItem("critical",Py::Boolean(record.critical));
+            ret.append(dict);
+        }
+        return Py::new_reference_to(ret);
+    } PY_CATCH;
+}
+
+PyObject*  DocumentPy::saveRecomputeProfile(PyObject * args)
+{
+    char* fn;
+    if (!PyArg_ParseTuple(args, "et", "utf-8", &fn))
+        return NULL;
+    std::string utf8Name = fn;
+    PyMem_Free(fn);
+    PY_TRY {
+        if(!getDocumentPtr()->saveRecomputeProfile(utf8Name.c_str())) {
+            PyErr_Format(PyExc_IOError, "Failed to write '%s'", utf8Name.c_str());
+            return NULL;
+        }
+        Py_Return;
+    } PY_CATCH;
+}
+
 PyObject*  DocumentPy::getObject(PyObject *args)
 {
     long id = -1;
@@ -690,6 +728,11 @@ void DocumentPy::setRecomputesFrozen(Py::Boolean arg)
     getDocumentPtr()->setStatus(Document::Status::SkipRecompute, arg.isTrue());
 }
 
+Py::Int DocumentPy::getRecomputeListSize(void) const
+{
+    return Py::Int((long)getDocumentPtr()->getRecomputeListSize());
+}
+
 PyObject* DocumentPy::getTempFileName(PyObject *args)
 {
     PyObject *value;
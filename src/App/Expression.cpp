@@ -47,6 +47,7 @@
 #include <stack>
 #include <deque>
 #include <algorithm>
+#include <atomic>
 #include "Expression.h"
 #include <Base/Unit.h>
 #include <App/PropertyUnits.h>
@@ -656,6 +657,112 @@ bool isAnyEqual(const App::any &v1, const App::any &v2) {
     return !!res;
 }
 
+/**
+  * Flat form of a numeric expression. The instructions are stored in post
+  * order and work on a stack of quantities, so that evaluating the expression
+  * neither creates intermediate expressions nor any other heap objects.
+  * Numbers and variables are read through the expression nodes, which are
+  * owned by the same root expression as the program.
+  */
+
+class ExpressionProgram {
+public:
+    enum Opcode {
+        PushQuantity,  /**< Push the quantity of a UnitExpression */
+        PushVariable,  /**< Push the value of a VariableExpression */
+        ApplyOperator, /**< Replace the two top values by the result of operator arg */
+        ApplyFunction, /**< Replace the count top values by the result of function arg */
+        JumpIfFalse,   /**< Pop a condition and continue at arg if it is false */
+        Jump,          /**< Continue at arg */
+    };
+
+    ExpressionProgram() : depth(0) {}
+
+    bool compile(const Expression *expr) {
+        return expr && expr->_compile(*this);
+    }
+
+    std::size_t emit(Opcode opcode, int stackEffect, int arg=0, int count=0, const Expression *expr=0) {
+        Instruction ins = {opcode, arg, count, expr};
+        code.push_back(ins);
+        depth += stackEffect;
+        if (depth > static_cast<int>(stack.size()))
+            stack.resize(depth);
+        return code.size() - 1;
+    }
+
+    void setTarget(std::size_t jump) {
+        code[jump].arg = static_cast<int>(code.size());
+    }
+
+    bool run(Quantity &result, bool cachedOnly) const;
+
+private:
+    struct Instruction {
+        Opcode opcode;
+        int arg;
+        int count;
+        const Expression *expr;
+    };
+
+    std::vector<Instruction> code;
+    mutable std::vector<Quantity> stack;
+    int depth;
+};
+
+/**
+  * Run the program.
+  *
+  * @returns false if a variable does not hold a number, in which case the
+  * expression has to be evaluated with eval() instead.
+  */
+
+bool ExpressionProgram::run(Quantity &result, bool cachedOnly) const
+{
+    std::size_t top = 0;
+    std::size_t pc = 0;
+
+    while (pc < code.size()) {
+        const Instruction &ins = code[pc++];
+
+        switch (ins.opcode) {
+        case PushQuantity:
+            stack[top++] = static_cast<const UnitExpression*>(ins.expr)->getQuantity();
+            break;
+        case PushVariable:
+            if (!static_cast<const VariableExpression*>(ins.expr)->getPropertyQuantity(stack[top], cachedOnly))
+                return false;
+            ++top;
+            break;
+        case ApplyOperator:
+            --top;
+            stack[top - 1] = OperatorExpression::evalOperator(
+                    static_cast<OperatorExpression::Operator>(ins.arg), stack[top - 1], stack[top]);
+            break;
+        case ApplyFunction: {
+            top -= ins.count;
+            const Quantity *args = &stack[top];
+            stack[top] = FunctionExpression::evalFunction(
+                    static_cast<FunctionExpression::Function>(ins.arg), ins.count,
+                    &args[0], ins.count > 1 ? &args[1] : 0, ins.count > 2 ? &args[2] : 0);
+            ++top;
+            break;
+        }
+        case JumpIfFalse:
+            --top;
+            if (!(fabs(stack[top].getValue()) > 0.5))
+                pc = ins.arg;
+            break;
+        case Jump:
+            pc = ins.arg;
+            break;
+        }
+    }
+
+    result = stack[0];
+    return true;
+}
+
 } // namespace App
 
 
@@ -675,6 +782,32 @@ Expression::~Expression()
 {
 }
 
+/**
+  * Evaluate a numeric expression. The expression is compiled into an
+  * ExpressionProgram on the first call, which is then run without creating
+  * intermediate expressions.
+  *
+  * @returns false if the expression is not purely numeric, e.g. because it
+  * contains strings, ranges or aggregates, or one of its variables does not
+  * refer to a number. eval() has to be used in this case.
+  *
+  * If \a cachedOnly is true, only variables whose property has already been
+  * resolved are read, and false is returned for any other. Nothing in the
+  * document is looked up then, which allows to evaluate independent
+  * expressions in parallel.
+  */
+
+bool Expression::evalQuantity(Quantity &result, bool cachedOnly) const
+{
+    if (!compiled) {
+        compiled = true;
+        std::unique_ptr<ExpressionProgram> p(new ExpressionProgram);
+        if (p->compile(this))
+            program = std::move(p);
+    }
+    return program && program->run(result, cachedOnly);
+}
+
 void Expression::visit(ExpressionVisitor &v) {
     _visit(v);
     v.visit(*this);
@@ -987,6 +1120,12 @@ int UnitExpression::priority() const
     return 20;
 }
 
+bool UnitExpression::_compile(ExpressionProgram &program) const
+{
+    program.emit(ExpressionProgram::PushQuantity, 1, 0, 0, this);
+    return true;
+}
+
 //
 // NumberExpression class
 //
@@ -1101,7 +1240,6 @@ Expression * OperatorExpression::eval() const
     NumberExpression * v1;
     std::unique_ptr<Expression> e2(right->eval());
     NumberExpression * v2;
-    Expression * output;
 
     v1 = freecad_dynamic_cast<NumberExpression>(e1.get());
     v2 = freecad_dynamic_cast<NumberExpression>(e2.get());
@@ -1109,71 +1247,90 @@ Expression * OperatorExpression::eval() const
     if (v1 == 0 || v2 == 0)
         throw ExpressionError("Invalid expression");
 
+    Quantity output = evalOperator(op, v1->getQuantity(), v2->getQuantity());
+
+    switch (op) {
+    case EQ:
+    case NEQ:
+    case LT:
+    case GT:
+    case LTE:
+    case GTE:
+        return new BooleanExpression(owner, output.getValue() != 0.0);
+    default:
+        return new NumberExpression(owner, output);
+    }
+}
+
+/**
+  * Apply the operator \a op to the quantities \a v1 and \a v2. Comparisons
+  * return 1 if true and 0 if false. Throws an ExpressionError exception if the
+  * units do not fit.
+  *
+  * @returns The result of the operation.
+  */
+
+Quantity OperatorExpression::evalOperator(Operator op, const Quantity &v1, const Quantity &v2)
+{
     switch (op) {
     case ADD:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for + operator");
-        output = new NumberExpression(owner, v1->getQuantity() + v2->getQuantity());
-        break;
+        return v1 + v2;
     case SUB:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for - operator");
-        output = new NumberExpression(owner, v1->getQuantity()- v2->getQuantity());
-        break;
+        return v1 - v2;
     case MUL:
     case UNIT:
-        output = new NumberExpression(owner, v1->getQuantity() * v2->getQuantity());
-        break;
+        return v1 * v2;
     case DIV:
-        output = new NumberExpression(owner, v1->getQuantity() / v2->getQuantity());
-        break;
+        return v1 / v2;
     case POW:
-        output = new NumberExpression(owner, v1->getQuantity().pow(v2->getQuantity()) );
-        break;
+        return v1.pow(v2);
     case EQ:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the = operator");
-        output = new BooleanExpression(owner, essentiallyEqual(v1->getValue(), v2->getValue()) );
-        break;
+        return Quantity(essentiallyEqual(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case NEQ:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the != operator");
-        output = new BooleanExpression(owner, !essentiallyEqual(v1->getValue(), v2->getValue()) );
-        break;
+        return Quantity(!essentiallyEqual(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case LT:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the < operator");
-        output = new BooleanExpression(owner, definitelyLessThan(v1->getValue(), v2->getValue()) );
-        break;
+        return Quantity(definitelyLessThan(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case GT:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the > operator");
-        output = new BooleanExpression(owner, definitelyGreaterThan(v1->getValue(), v2->getValue()) );
-        break;
+        return Quantity(definitelyGreaterThan(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case LTE:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the <= operator");
-        output = new BooleanExpression(owner, definitelyLessThan(v1->getValue(), v2->getValue()) ||
-                                       essentiallyEqual(v1->getValue(), v2->getValue()));
-        break;
+        return Quantity(definitelyLessThan(v1.getValue(), v2.getValue()) ||
+                        essentiallyEqual(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case GTE:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the >= operator");
-        output = new BooleanExpression(owner, essentiallyEqual(v1->getValue(), v2->getValue()) ||
-                                       definitelyGreaterThan(v1->getValue(), v2->getValue()));
-        break;
+        return Quantity(essentiallyEqual(v1.getValue(), v2.getValue()) ||
+                        definitelyGreaterThan(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case NEG:
-        output = new NumberExpression(owner, -v1->getQuantity() );
-        break;
+        return -v1;
     case POS:
-        output = new NumberExpression(owner, v1->getQuantity() );
-        break;
+        return v1;
     default:
-        output = 0;
         assert(0);
     }
 
-    return output;
+    return Quantity();
+}
+
+bool OperatorExpression::_compile(ExpressionProgram &program) const
+{
+    if (!program.compile(left) || !program.compile(right))
+        return false;
+    program.emit(ExpressionProgram::ApplyOperator, -1, op);
+    return true;
 }
 
 /**
@@ -1674,6 +1831,22 @@ Expression * FunctionExpression::eval() const
     NumberExpression * v1 = freecad_dynamic_cast<NumberExpression>(e1.get());
     NumberExpression * v2 = freecad_dynamic_cast<NumberExpression>(e2.get());
     NumberExpression * v3 = freecad_dynamic_cast<NumberExpression>(e3.get());
+
+    return new NumberExpression(owner, evalFunction(f, args.size(),
+                v1 ? &v1->getQuantity() : 0, v2 ? &v2->getQuantity() : 0, v3 ? &v3->getQuantity() : 0));
+}
+
+/**
+  * Compute the non-aggregate function \a f of \a argc arguments. Missing and
+  * non-numeric arguments are passed as null pointers. Throws an ExpressionError
+  * exception if the arguments are invalid.
+  *
+  * @returns The result of the function.
+  */
+
+Quantity FunctionExpression::evalFunction(Function f, std::size_t argc,
+                                          const Quantity *v1, const Quantity *v2, const Quantity *v3)
+{
     double output;
     Unit unit;
     double scaler = 1;
@@ -1783,7 +1956,7 @@ Expression * FunctionExpression::eval() const
         if (v1->getUnit() != v2->getUnit())
             throw ExpressionError("Units must be equal");
 
-        if (args.size() > 2) {
+        if (argc > 2) {
             if (v3 == 0)
                 throw ExpressionError("Invalid second argument.");
             if (v2->getUnit() != v3->getUnit())
@@ -1876,7 +2049,22 @@ Expression * FunctionExpression::eval() const
         assert(0);
     }
 
-    return new NumberExpression(owner, Quantity(scaler * output, unit));
+    return Quantity(scaler * output, unit);
+}
+
+bool FunctionExpression::_compile(ExpressionProgram &program) const
+{
+    // aggregates collect ranges and skip non-numeric arguments
+    if (f > AGGREGATES || args.empty() || args.size() > 3)
+        return false;
+
+    for (auto it = args.begin(); it != args.end(); ++it) {
+        if (!program.compile(*it))
+            return false;
+    }
+    program.emit(ExpressionProgram::ApplyFunction, 1 - static_cast<int>(args.size()), f,
+                 static_cast<int>(args.size()));
+    return true;
 }
 
 /**
@@ -2148,6 +2336,112 @@ Expression * VariableExpression::eval() const
     throw ExpressionError("Property is of invalid type.");
 }
 
+/* Resolved properties are cached by VariableExpression::getPropertyQuantity()
+ * until a document, an object or a dynamic property is added, removed or
+ * renamed, or an undo/redo is performed.
+ */
+static std::atomic<unsigned long> _ResolveEpoch(1);
+
+static void invalidateResolvedProperties()
+{
+    // bumped by the main thread, read by recompute worker threads
+    _ResolveEpoch.fetch_add(1, std::memory_order_release);
+}
+
+static bool connectResolveSignals()
+{
+    Application &app = GetApplication();
+    app.signalNewDocument.connect([](const Document &, bool) { invalidateResolvedProperties(); });
+    app.signalDeleteDocument.connect([](const Document &) { invalidateResolvedProperties(); });
+    app.signalRelabelDocument.connect([](const Document &) { invalidateResolvedProperties(); });
+    app.signalRenameDocument.connect([](const Document &) { invalidateResolvedProperties(); });
+    app.signalFinishRestoreDocument.connect([](const Document &) { invalidateResolvedProperties(); });
+    app.signalNewObject.connect([](const DocumentObject &) { invalidateResolvedProperties(); });
+    app.signalDeletedObject.connect([](const DocumentObject &) { invalidateResolvedProperties(); });
+    app.signalRelabelObject.connect([](const DocumentObject &) { invalidateResolvedProperties(); });
+    app.signalAppendDynamicProperty.connect([](const Property &) { invalidateResolvedProperties(); });
+    app.signalRemoveDynamicProperty.connect([](const Property &) { invalidateResolvedProperties(); });
+    app.signalUndo.connect([]() { invalidateResolvedProperties(); });
+    app.signalRedo.connect([]() { invalidateResolvedProperties(); });
+    return true;
+}
+
+static unsigned long resolveEpoch()
+{
+    // connected once, even if first called from several threads
+    static bool connected = connectResolveSignals();
+    (void)connected;
+    return _ResolveEpoch.load(std::memory_order_acquire);
+}
+
+static bool propertyToQuantity(const Property *prop, Quantity &result)
+{
+    if (prop->isDerivedFrom(PropertyQuantity::getClassTypeId()))
+        result = static_cast<const PropertyQuantity*>(prop)->getQuantityValue();
+    else if (prop->isDerivedFrom(PropertyFloat::getClassTypeId()))
+        result = Quantity(static_cast<const PropertyFloat*>(prop)->getValue());
+    else if (prop->isDerivedFrom(PropertyInteger::getClassTypeId()))
+        result = Quantity(static_cast<const PropertyInteger*>(prop)->getValue());
+    else if (prop->isDerivedFrom(PropertyBool::getClassTypeId()))
+        result = Quantity(static_cast<const PropertyBool*>(prop)->getValue() ? 1.0 : 0.0);
+    else
+        return false;
+    return true;
+}
+
+/**
+  * Get the value of the referenced property as a quantity, the same way as
+  * eval() does for numbers. Plain numeric properties that are referenced
+  * without sub-path are cached after being resolved, and read directly.
+  *
+  * @returns false if the property does not hold a number, or if \a cachedOnly
+  * is true and the property is not cached.
+  */
+
+bool VariableExpression::getPropertyQuantity(Quantity &result, bool cachedOnly) const
+{
+    unsigned long epoch = resolveEpoch();
+    if (cacheEpoch == epoch && cachedProperty)
+        return propertyToQuantity(cachedProperty, result);
+    if (cachedOnly)
+        return false;
+
+    int ptype = 0;
+    const Property * prop = var.getProperty(&ptype);
+    if (!prop)
+        throw Expression::Exception(var.resolveErrorString().c_str());
+
+    PropertyContainer * parent = prop->getContainer();
+    if (!parent->isDerivedFrom(App::DocumentObject::getClassTypeId()))
+        throw ExpressionError("Property must belong to a document object.");
+
+    // pseudo properties, sub-objects and sub-paths are resolved every time
+    if (!ptype && var.getSubObjectName().empty() && var.verify(*prop, true)
+               && propertyToQuantity(prop, result))
+    {
+        cachedProperty = prop;
+        cacheEpoch = epoch;
+        return true;
+    }
+
+    boost::any value = prop->getPathValue(var);
+    double dvalue;
+
+    if (value.type() == typeid(Quantity))
+        result = boost::any_cast<Quantity>(value);
+    else if (anyToDouble(dvalue, value))
+        result = Quantity(dvalue);
+    else
+        return false;
+    return true;
+}
+
+bool VariableExpression::_compile(ExpressionProgram &program) const
+{
+    program.emit(ExpressionProgram::PushVariable, 1, 0, 0, this);
+    return true;
+}
+
 std::string VariableExpression::toString(bool persistent) const {
     if(persistent)
         return var.toPersistentString();
@@ -2204,29 +2498,34 @@ void VariableExpression::_getIdentifiers(std::set<App::ObjectIdentifier> &deps)
 bool VariableExpression::_relabeledDocument(const std::string &oldName,
         const std::string &newName, ExpressionVisitor &v)
 {
+    cacheEpoch = 0;
     return var.relabeledDocument(v, oldName, newName);
 }
 
 bool VariableExpression::_adjustLinks(
         const std::set<App::DocumentObject *> &inList, ExpressionVisitor &v) 
 {
+    cacheEpoch = 0;
     return var.adjustLinks(v,inList);
 }
 
 void VariableExpression::_importSubNames(const ObjectIdentifier::SubNameMap &subNameMap) 
 {
+    cacheEpoch = 0;
     var.importSubNames(subNameMap);
 }
 
 void VariableExpression::_updateLabelReference(
         App::DocumentObject *obj, const std::string &ref, const char *newLabel)
 {
+    cacheEpoch = 0;
     var.updateLabelReference(obj,ref,newLabel);
 }
 
 bool VariableExpression::_updateElementReference(
         App::DocumentObject *feature, bool reverse, ExpressionVisitor &v) 
 {
+    cacheEpoch = 0;
     return var.updateElementReference(v,feature,reverse);
 }
 
@@ -2238,6 +2537,7 @@ bool VariableExpression::_renameObjectIdentifier(
     auto it = paths.find(oldPath);
     if (it != paths.end()) {
         v.aboutToChange();
+        cacheEpoch = 0;
         if(path.getOwner())
             var = it->second.relativeTo(path);
         else
@@ -2273,6 +2573,7 @@ void VariableExpression::_moveCells(const CellAddress &address,
     int thisCol = addr.col();
     if (thisRow >= address.row() || thisCol >= address.col()) {
         v.aboutToChange();
+        cacheEpoch = 0;
         addr.setRow(thisRow + rowCount);
         addr.setCol(thisCol + colCount);
         comp = ObjectIdentifier::SimpleComponent(addr.toString());
@@ -2289,6 +2590,7 @@ void VariableExpression::_offsetCells(int rowOffset, int colOffset, ExpressionVi
         return;
 
     v.aboutToChange();
+    cacheEpoch = 0;
     if(!addr.isAbsoluteCol())
         addr.setCol(addr.col()+colOffset);
     if(!addr.isAbsoluteRow())
@@ -2299,6 +2601,7 @@ void VariableExpression::_offsetCells(int rowOffset, int colOffset, ExpressionVi
 void VariableExpression::setPath(const ObjectIdentifier &path)
 {
      var = path;
+     cacheEpoch = 0;
 }
 
 //
@@ -2442,6 +2745,22 @@ Expression *ConditionalExpression::eval() const
         return falseExpr->eval();
 }
 
+bool ConditionalExpression::_compile(ExpressionProgram &program) const
+{
+    if (!program.compile(condition))
+        return false;
+    std::size_t jumpToFalse = program.emit(ExpressionProgram::JumpIfFalse, -1);
+    if (!program.compile(trueExpr))
+        return false;
+    // only one of the branches leaves its value on the stack
+    std::size_t jumpToEnd = program.emit(ExpressionProgram::Jump, -1);
+    program.setTarget(jumpToFalse);
+    if (!program.compile(falseExpr))
+        return false;
+    program.setTarget(jumpToEnd);
+    return true;
+}
+
 Expression *ConditionalExpression::simplify() const
 {
     std::unique_ptr<Expression> e(condition->simplify());
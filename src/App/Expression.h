@@ -45,6 +45,7 @@ namespace App  {
 
 class DocumentObject;
 class Expression;
+class ExpressionProgram;
 class Document;
 
 typedef std::unique_ptr<Expression> ExpressionPtr;
@@ -127,6 +128,8 @@ public:
 
     virtual Expression * eval() const = 0;
 
+    bool evalQuantity(Base::Quantity &result, bool cachedOnly=false) const;
+
     virtual std::string toString(bool persistent=false) const = 0;
 
     static Expression * parse(const App::DocumentObject * owner, const std::string& buffer);
@@ -170,9 +173,11 @@ public:
     bool isSame(const Expression &other) const;
 
     friend ExpressionVisitor;
+    friend ExpressionProgram;
 
 protected:
     virtual Expression *_copy() const = 0;
+    virtual bool _compile(ExpressionProgram &) const {return false;}
     virtual void _getDeps(ExpressionDeps &) const  {}
     virtual void _getDepObjects(std::set<App::DocumentObject*> &, std::vector<std::string> *) const  {}
     virtual void _getIdentifiers(std::set<App::ObjectIdentifier> &) const  {}
@@ -197,6 +202,10 @@ protected:
 protected:
     App::DocumentObject * owner; /**< The document object used to access unqualified variables (i.e local scope) */
 
+private:
+    mutable std::unique_ptr<ExpressionProgram> program; /**< Compiled form used by evalQuantity() */
+    mutable bool compiled = false;
+
 public:
     std::string comment;
 };
@@ -235,6 +244,9 @@ public:
 
     boost::any getValueAsAny() const { return quantity.getUnit().isEmpty() ? boost::any(quantity.getValue()) : boost::any(quantity); }
 
+protected:
+    virtual bool _compile(ExpressionProgram &) const;
+
 protected:
     Base::Quantity quantity;
     std::string unitStr; /**< The unit string from the original parsed string */
@@ -342,7 +354,10 @@ public:
 
     Expression * getRight() const { return right; }
 
+    static Base::Quantity evalOperator(Operator op, const Base::Quantity &v1, const Base::Quantity &v2);
+
 protected:
+    virtual bool _compile(ExpressionProgram &) const;
 
     virtual bool isCommutative() const;
 
@@ -377,6 +392,7 @@ public:
     virtual void _visit(ExpressionVisitor & v);
 
 protected:
+    virtual bool _compile(ExpressionProgram &) const;
 
     Expression * condition;  /**< Condition */
     Expression * trueExpr;  /**< Expression if abs(condition) is > 0.5 */
@@ -451,7 +467,11 @@ public:
 
     virtual void _visit(ExpressionVisitor & v);
 
+    static Base::Quantity evalFunction(Function f, std::size_t argc, const Base::Quantity *v1,
+                                       const Base::Quantity *v2, const Base::Quantity *v3);
+
 protected:
+    virtual bool _compile(ExpressionProgram &) const;
     Expression *evalAggregate() const;
 
     Function f;        /**< Function to execute */
@@ -493,7 +513,10 @@ public:
 
     const App::Property *getProperty() const;
 
+    bool getPropertyQuantity(Base::Quantity &result, bool cachedOnly=false) const;
+
 protected:
+    virtual bool _compile(ExpressionProgram &) const;
     virtual void _getDeps(ExpressionDeps &) const;
     virtual void _getDepObjects(std::set<App::DocumentObject*> &, std::vector<std::string> *) const;
     virtual void _getIdentifiers(std::set<App::ObjectIdentifier> &) const;
@@ -513,6 +536,10 @@ protected:
 protected:
 
     ObjectIdentifier var; /**< Variable name  */
+
+private:
+    mutable const App::Property *cachedProperty = 0; /**< Resolved property, valid as long as cacheEpoch is current */
+    mutable unsigned long cacheEpoch = 0;
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -279,6 +279,11 @@ public:
         return FeatureT::canLoadPartial();
     }
 
+    /// Python features must be recomputed on the main thread
+    virtual bool allowConcurrentRecompute() const override {
+        return false;
+    }
+
     PyObject *getPyObject(void) override {
         if (FeatureT::PythonObject.is(Py::_None())) {
             // ref counter is set to 1
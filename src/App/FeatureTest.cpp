@@ -29,6 +29,7 @@
 #include <Base/Console.h>
 #include <Base/Exception.h>
 #include <Base/Unit.h>
+#include "Document.h"
 #include "FeatureTest.h"
 #include "Material.h"
 #include "Material.h"
@@ -200,3 +201,19 @@ DocumentObjectExecReturn *FeatureTestException::execute(void)
 
     return 0;
 }
+
+// ----------------------------------------------------------------------------
+
+PROPERTY_SOURCE(App::FeatureTestConcurrent, App::FeatureTest)
+
+
+FeatureTestConcurrent::FeatureTestConcurrent()
+{
+  ADD_PROPERTY(ExecOnWorker,(false));
+}
+
+DocumentObjectExecReturn *FeatureTestConcurrent::execute(void)
+{
+    ExecOnWorker.setValue(Document::isParallelRecomputeThread());
+    return FeatureTest::execute();
+}
@@ -135,6 +135,21 @@ public:
   }
 };
 
+/// The feature to test the parallel recompute
+class FeatureTestConcurrent :public FeatureTest
+{
+  PROPERTY_HEADER(App::FeatureTestConcurrent);
+
+public:
+  FeatureTestConcurrent();
+
+  /// set on recompute if the feature is executed on a worker thread
+  App::PropertyBool ExecOnWorker;
+
+  virtual DocumentObjectExecReturn *execute(void);
+  virtual bool allowConcurrentRecompute() const {return true;}
+};
+
 
 
 } //namespace App
@@ -70,6 +70,9 @@
 #include <stack>
 #include <sstream>
 #include <queue>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
 #include <bitset>
 #include <exception>
 #include <random>
@@ -33,6 +33,8 @@
 #else
 #include <boost_any_1_55.hpp>
 #endif
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <bitset>
 
@@ -416,6 +418,17 @@ protected:
     std::set<int> _touchList;
 };
 
+/** Changed elements of a property list.
+ * Holds the elements of a former value of a list that differ from the current
+ * value, see PropertyLists::getDelta().
+ */
+class AppExport PropertyListDelta
+{
+public:
+    virtual ~PropertyListDelta() {}
+    virtual unsigned int getMemSize (void) const = 0;
+};
+
 /** Base class of all property lists.
  * The PropertyLists class is the base class for properties which can contain
  * multiple values, not only a single value.
@@ -436,6 +449,23 @@ public:
     inline void setOrderRelevant(bool on) { this->setStatus(Status::Ordered,on); };
     inline bool isOrderRelevant() const { return this->testStatus(Status::Ordered);}
 
+    /** Returns the elements of \a prev, a former copy of this property, that
+     * differ from the current values. This is used to keep undo steps of
+     * large lists small. Returns 0 if not supported or if most of the list
+     * has changed.
+     */
+    virtual PropertyListDelta *getDelta(const Property &prev) const {
+        (void)prev;
+        return 0;
+    }
+    /** Restores the values the delta has been made from, see getDelta().
+     * Returns false and leaves the property unchanged if it no longer holds
+     * the value the delta has been made against.
+     */
+    virtual bool applyDelta(const PropertyListDelta &delta) {
+        (void)delta;
+        return false;
+    }
 };
 
 /** Helper class to implement PropertyLists */
@@ -532,6 +562,62 @@ protected:
 
     virtual T getPyValue(PyObject *item) const = 0;
 
+    struct ListDelta : PropertyListDelta {
+        std::size_t size;
+        std::vector<int> indices;
+        ListT values;
+        // the value the delta has been made against
+        std::size_t postSize;
+        std::uint64_t postHash;
+
+        virtual unsigned int getMemSize (void) const override {
+            return static_cast<unsigned int>(indices.size() * (sizeof(int) + sizeof(T)));
+        }
+    };
+
+    /// Implements getDelta() for element types that can be compared
+    PropertyListDelta *_getDelta(const Property &prev) const {
+        const ListT &prevList = dynamic_cast<const PropertyListsT&>(prev)._lValueList;
+        std::unique_ptr<ListDelta> delta(new ListDelta);
+        delta->size = prevList.size();
+        delta->postSize = _lValueList.size();
+        delta->postHash = _hashValues(_lValueList);
+        for(std::size_t i=0,count=prevList.size();i<count;++i) {
+            if(i < _lValueList.size() && prevList[i] == _lValueList[i])
+                continue;
+            if(2 * delta->indices.size() >= count)
+                return 0;
+            delta->indices.push_back(static_cast<int>(i));
+            delta->values.push_back(prevList[i]);
+        }
+        return delta.release();
+    }
+
+    /// Implements applyDelta() for deltas made by _getDelta()
+    bool _applyDelta(const PropertyListDelta &d) {
+        const ListDelta &delta = static_cast<const ListDelta&>(d);
+        if(_lValueList.size() != delta.postSize || _hashValues(_lValueList) != delta.postHash)
+            return false;
+        atomic_change guard(*this);
+        this->_touchList.clear();
+        _lValueList.resize(delta.size);
+        for(std::size_t i=0,count=delta.indices.size();i<count;++i)
+            _lValueList[delta.indices[i]] = delta.values[i];
+        guard.tryInvoke();
+        return true;
+    }
+
+    /// FNV-1a hash of the bytes of the elements
+    static std::uint64_t _hashValues(const ListT &list) {
+        std::uint64_t hash = 14695981039346656037ULL;
+        const unsigned char *bytes = reinterpret_cast<const unsigned char*>(list.data());
+        for(std::size_t i=0,count=list.size()*sizeof(T);i<count;++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
 protected:
     ListT _lValueList;
 };
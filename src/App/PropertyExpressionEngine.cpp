@@ -552,9 +552,19 @@ DocumentObjectExecReturn *App::PropertyExpressionEngine::execute(ExecuteOption o
         /* Set value of property */
         App::any value;
         try {
-            // Evaluate expression
-            std::unique_ptr<Expression> e(expressions[*it].expression->eval());
-            value = e->getValueAsAny();
+            // Evaluate expression, numeric ones without intermediate expressions
+            const Expression *expr = expressions[*it].expression.get();
+            Base::Quantity q;
+            if (expr->evalQuantity(q)) {
+                if (q.getUnit().isEmpty())
+                    value = q.getValue();
+                else
+                    value = q;
+            }
+            else {
+                std::unique_ptr<Expression> e(expr->eval());
+                value = e->getValueAsAny();
+            }
             if(option == ExecuteOnRestore && prop->testStatus(Property::EvalOnRestore)) {
                 if(isAnyEqual(value, prop->getPathValue(*it)))
                     continue;
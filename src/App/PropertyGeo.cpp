@@ -362,18 +362,20 @@ void PropertyVectorList::SaveDocFile (Base::Writer &writer) const
     Base::OutputStream str(writer.Stream());
     uint32_t uCt = (uint32_t)getSize();
     str << uCt;
+    // a vector consists of three contiguous coordinates
+    static_assert(sizeof(Base::Vector3d) == 3 * sizeof(double), "Unexpected vector layout");
     if (!isSinglePrecision()) {
-        for (std::vector<Base::Vector3d>::const_iterator it = _lValueList.begin(); it != _lValueList.end(); ++it) {
-            str << it->x << it->y << it->z;
-        }
+        str.write(_lValueList.empty() ? 0 : &_lValueList[0].x, 3 * _lValueList.size());
     }
     else {
+        std::vector<float> values;
+        values.reserve(3 * _lValueList.size());
         for (std::vector<Base::Vector3d>::const_iterator it = _lValueList.begin(); it != _lValueList.end(); ++it) {
-            float x = (float)it->x;
-            float y = (float)it->y;
-            float z = (float)it->z;
-            str << x << y << z;
+            values.push_back((float)it->x);
+            values.push_back((float)it->y);
+            values.push_back((float)it->z);
         }
+        str.write(values.data(), values.size());
     }
 }
 
@@ -384,15 +386,13 @@ void PropertyVectorList::RestoreDocFile(Base::Reader &reader)
     str >> uCt;
     std::vector<Base::Vector3d> values(uCt);
     if (!isSinglePrecision()) {
-        for (std::vector<Base::Vector3d>::iterator it = values.begin(); it != values.end(); ++it) {
-            str >> it->x >> it->y >> it->z;
-        }
+        str.read(values.empty() ? 0 : &values[0].x, 3 * values.size());
     }
     else {
-        float x,y,z;
-        for (std::vector<Base::Vector3d>::iterator it = values.begin(); it != values.end(); ++it) {
-            str >> x >> y >> z;
-            it->Set(x, y, z);
+        std::vector<float> floats(3 * uCt);
+        str.read(floats.data(), floats.size());
+        for (std::size_t i = 0; i < values.size(); i++) {
+            values[i].Set(floats[3*i], floats[3*i+1], floats[3*i+2]);
         }
     }
     setValues(values);
@@ -415,6 +415,16 @@ unsigned int PropertyVectorList::getMemSize (void) const
     return static_cast<unsigned int>(_lValueList.size() * sizeof(Base::Vector3d));
 }
 
+PropertyListDelta *PropertyVectorList::getDelta(const Property &prev) const
+{
+    return _getDelta(prev);
+}
+
+bool PropertyVectorList::applyDelta(const PropertyListDelta &delta)
+{
+    return _applyDelta(delta);
+}
+
 //**************************************************************************
 //**************************************************************************
 // PropertyMatrix
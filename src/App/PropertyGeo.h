@@ -224,6 +224,8 @@ public:
     virtual void Paste(const Property &from) override;
 
     virtual unsigned int getMemSize (void) const override;
+    virtual PropertyListDelta *getDelta(const Property &prev) const override;
+    virtual bool applyDelta(const PropertyListDelta &delta) override;
 
 protected:
     Base::Vector3d getPyValue(PyObject *) const override;
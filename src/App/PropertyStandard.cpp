@@ -781,6 +781,16 @@ unsigned int PropertyIntegerList::getMemSize (void) const
     return static_cast<unsigned int>(_lValueList.size() * sizeof(long));
 }
 
+PropertyListDelta *PropertyIntegerList::getDelta(const Property &prev) const
+{
+    return _getDelta(prev);
+}
+
+bool PropertyIntegerList::applyDelta(const PropertyListDelta &delta)
+{
+    return _applyDelta(delta);
+}
+
 
 
 
@@ -1258,15 +1268,11 @@ void PropertyFloatList::SaveDocFile (Base::Writer &writer) const
     uint32_t uCt = (uint32_t)getSize();
     str << uCt;
     if (!isSinglePrecision()) {
-        for (std::vector<double>::const_iterator it = _lValueList.begin(); it != _lValueList.end(); ++it) {
-            str << *it;
-        }
+        str.write(_lValueList.data(), _lValueList.size());
     }
     else {
-        for (std::vector<double>::const_iterator it = _lValueList.begin(); it != _lValueList.end(); ++it) {
-            float v = (float)*it;
-            str << v;
-        }
+        std::vector<float> values(_lValueList.begin(), _lValueList.end());
+        str.write(values.data(), values.size());
     }
 }
 
@@ -1277,16 +1283,12 @@ void PropertyFloatList::RestoreDocFile(Base::Reader &reader)
     str >> uCt;
     std::vector<double> values(uCt);
     if (!isSinglePrecision()) {
-        for (std::vector<double>::iterator it = values.begin(); it != values.end(); ++it) {
-            str >> *it;
-        }
+        str.read(values.data(), values.size());
     }
     else {
-        for (std::vector<double>::iterator it = values.begin(); it != values.end(); ++it) {
-            float val;
-            str >> val;
-            (*it) = val;
-        }
+        std::vector<float> floats(uCt);
+        str.read(floats.data(), floats.size());
+        std::copy(floats.begin(), floats.end(), values.begin());
     }
     setValues(values);
 }
@@ -1308,6 +1310,16 @@ unsigned int PropertyFloatList::getMemSize (void) const
     return static_cast<unsigned int>(_lValueList.size() * sizeof(double));
 }
 
+PropertyListDelta *PropertyFloatList::getDelta(const Property &prev) const
+{
+    return _getDelta(prev);
+}
+
+bool PropertyFloatList::applyDelta(const PropertyListDelta &delta)
+{
+    return _applyDelta(delta);
+}
+
 //**************************************************************************
 //**************************************************************************
 // PropertyString
@@ -330,6 +330,8 @@ public:
     virtual Property *Copy(void) const override;
     virtual void Paste(const Property &from) override;
     virtual unsigned int getMemSize (void) const override;
+    virtual PropertyListDelta *getDelta(const Property &prev) const override;
+    virtual bool applyDelta(const PropertyListDelta &delta) override;
 
 protected:
     long getPyValue(PyObject *item) const override;
@@ -612,6 +614,8 @@ public:
     virtual Property *Copy(void) const override;
     virtual void Paste(const Property &from) override;
     virtual unsigned int getMemSize (void) const override;
+    virtual PropertyListDelta *getDelta(const Property &prev) const override;
+    virtual bool applyDelta(const PropertyListDelta &delta) override;
 
 protected:
     double getPyValue(PyObject *item) const override;
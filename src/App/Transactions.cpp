@@ -111,7 +111,15 @@ int Transaction::getLastID() {
 
 unsigned int Transaction::getMemSize (void) const
 {
-    return 0;
+    unsigned int size = 0;
+    auto &index = _Objects.get<0>();
+    for (auto It = index.begin(); It != index.end(); ++It) {
+        // removed objects are owned by the transaction
+        if (It->second->status == TransactionObject::New && !It->first->isAttachedToDocument())
+            size += It->first->getMemSize();
+        size += It->second->getMemSize();
+    }
+    return size;
 }
 
 void Transaction::Save (Base::Writer &/*writer*/) const
@@ -188,6 +196,42 @@ void Transaction::apply(Document &Doc, bool forward)
     }
 }
 
+/**
+ * Replaces the copies of list properties by the elements that have been
+ * changed since. This must be called when the transaction is closed, i.e.
+ * while the properties still hold the values the transaction has been
+ * recorded up to, so that undo/redo can restore the copies from the deltas.
+ */
+void Transaction::compact(void)
+{
+    auto &index = _Objects.get<0>();
+    for(auto &info : index)
+        info.second->compact(info.first);
+}
+
+bool Transaction::hasDelta(const TransactionalObject *Obj, const Property *Prop) const
+{
+    auto &index = _Objects.get<1>();
+    auto pos = index.find(Obj);
+    if (pos == index.end())
+        return false;
+    auto it = pos->second->_PropChangeMap.find(Prop);
+    return it != pos->second->_PropChangeMap.end() && it->second.delta;
+}
+
+/**
+ * Replaces the changed elements of a list property by a copy of its former
+ * value. \a value must hold the value the transaction has been recorded up
+ * to, and receives the former value. See Document::onBeforeChangeProperty().
+ */
+void Transaction::expandDelta(const TransactionalObject *Obj, const Property *Prop, Property &value)
+{
+    auto &index = _Objects.get<1>();
+    auto pos = index.find(Obj);
+    if (pos != index.end())
+        pos->second->expandDelta(Prop, value);
+}
+
 void Transaction::addObjectNew(TransactionalObject *Obj)
 {
     auto &index = _Objects.get<1>();
@@ -300,7 +344,7 @@ void TransactionObject::applyChn(Document & /*Doc*/, TransactionalObject *pcObj,
             auto &data = v.second;
             auto prop = const_cast<Property*>(v.first);
 
-            if(!data.property) {
+            if(!data.property && !data.delta) {
                 // here means we are undoing/redoing and property add operation
                 pcObj->removeDynamicProperty(v.second.name.c_str());
                 continue;
@@ -322,6 +366,10 @@ void TransactionObject::applyChn(Document & /*Doc*/, TransactionalObject *pcObj,
                 // a new property, the property key inside redo stack will not
                 // match. So we search by name first.
                 prop = pcObj->getDynamicPropertyByName(v.second.name.c_str());
+                if(!prop && data.delta) {
+                    // a delta cannot be applied without the property
+                    continue;
+                }
                 if(!prop) {
                     // Still not found, re-create the property
                     prop = pcObj->addDynamicProperty(
@@ -343,7 +391,15 @@ void TransactionObject::applyChn(Document & /*Doc*/, TransactionalObject *pcObj,
                         << " -> " << prop->getTypeId().getName());
                 continue;
             }
-            prop->Paste(*data.property);
+            if(data.delta) {
+                if(!static_cast<PropertyLists*>(prop)->applyDelta(*data.delta)) {
+                    FC_ERR("Cannot " << (Forward?"redo":"undo")
+                            << " change of property " << prop->getName()
+                            << " because it has been changed since");
+                }
+            }
+            else
+                prop->Paste(*data.property);
         }
     }
 }
@@ -351,7 +407,7 @@ void TransactionObject::applyChn(Document & /*Doc*/, TransactionalObject *pcObj,
 void TransactionObject::setProperty(const Property* pcProp)
 {
     auto &data = _PropChangeMap[pcProp];
-    if(!data.property && data.name.empty()) {
+    if(!data.property && !data.delta && data.name.empty()) {
         static_cast<DynamicProperty::PropData&>(data) = 
             pcProp->getContainer()->getDynamicPropertyData(pcProp);
         data.property = pcProp->Copy();
@@ -379,6 +435,7 @@ void TransactionObject::addOrRemoveProperty(const Property* pcProp, bool add)
         delete data.property;
         data.property = 0;
     }
+    data.delta.reset();
 
     static_cast<DynamicProperty::PropData&>(data) = 
         pcProp->getContainer()->getDynamicPropertyData(pcProp);
@@ -391,9 +448,62 @@ void TransactionObject::addOrRemoveProperty(const Property* pcProp, bool add)
     }
 }
 
+void TransactionObject::compact(const TransactionalObject *pcObj)
+{
+    if (status != Chn)
+        return;
+
+    for(auto &v : _PropChangeMap) {
+        auto &data = v.second;
+        if(!data.property || !data.property->isDerivedFrom(PropertyLists::getClassTypeId()))
+            continue;
+
+        // The property may have been removed or replaced by one of another
+        // type, see applyChn()
+        if(!pcObj->getPropertyName(v.first) || v.first->getTypeId() != data.propertyType)
+            continue;
+
+        PropertyListDelta *delta = static_cast<const PropertyLists*>(v.first)->getDelta(*data.property);
+        if(delta) {
+            data.delta.reset(delta);
+            delete data.property;
+            data.property = 0;
+        }
+    }
+}
+
+void TransactionObject::expandDelta(const Property *pcProp, Property &value)
+{
+    auto it = _PropChangeMap.find(pcProp);
+    if (it == _PropChangeMap.end())
+        return;
+
+    auto &data = it->second;
+    if (data.propertyType != value.getTypeId())
+        return;
+    if (data.delta) {
+        if (!static_cast<PropertyLists&>(value).applyDelta(*data.delta)) {
+            FC_ERR("Cannot restore the former value of property " << pcProp->getName());
+            return;
+        }
+        data.property = value.Copy();
+        data.delta.reset();
+    }
+    else if (data.property) {
+        value.Paste(*data.property);
+    }
+}
+
 unsigned int TransactionObject::getMemSize (void) const
 {
-    return 0;
+    unsigned int size = 0;
+    for(auto &v : _PropChangeMap) {
+        if(v.second.property)
+            size += v.second.property->getMemSize();
+        if(v.second.delta)
+            size += v.second.delta->getMemSize();
+    }
+    return size;
 }
 
 void TransactionObject::Save (Base::Writer &/*writer*/) const
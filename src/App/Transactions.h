@@ -24,6 +24,7 @@
 #ifndef APP_TRANSACTION_H
 #define APP_TRANSACTION_H
 
+#include <memory>
 #include <unordered_map>
 #include <Base/Factory.h>
 #include <Base/Persistence.h>
@@ -34,6 +35,7 @@ namespace App
 
 class Document;
 class Property;
+class PropertyListDelta;
 class Transaction;
 class TransactionObject;
 class TransactionalObject;
@@ -60,6 +62,12 @@ public:
 
     /// apply the content to the document
     void apply(Document &Doc,bool forward);
+    /// replace the copies of changed list properties by their changed elements
+    void compact(void);
+    /// check if the changed elements of a list property are kept instead of a copy
+    bool hasDelta(const TransactionalObject *Obj, const Property *Prop) const;
+    /// replace the changed elements of a list property by a copy
+    void expandDelta(const TransactionalObject *Obj, const Property *Prop, Property &value);
 
     // the utf-8 name of the transaction
     std::string Name;
@@ -118,6 +126,8 @@ public:
 
     void setProperty(const Property* pcProp);
     void addOrRemoveProperty(const Property* pcProp, bool add);
+    void compact(const TransactionalObject *pcObj);
+    void expandDelta(const Property *pcProp, Property &value);
 
     virtual unsigned int getMemSize (void) const;
     virtual void Save (Base::Writer &writer) const;
@@ -131,6 +141,8 @@ protected:
 
     struct PropData : DynamicProperty::PropData {
         Base::Type propertyType;
+        /// changed elements of a list property, replaces the copy in 'property'
+        std::shared_ptr<PropertyListDelta> delta;
     };
     std::unordered_map<const Property*, PropData> _PropChangeMap;
 
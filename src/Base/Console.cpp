@@ -81,20 +81,7 @@ public:
     void customEvent(QEvent* ev) {
         if (ev->type() == QEvent::User) {
             ConsoleEvent* ce = static_cast<ConsoleEvent*>(ev);
-            switch (ce->msgtype) {
-            case ConsoleSingleton::MsgType_Txt:
-                Console().NotifyMessage(ce->msg.c_str());
-                break;
-            case ConsoleSingleton::MsgType_Log:
-                Console().NotifyLog(ce->msg.c_str());
-                break;
-            case ConsoleSingleton::MsgType_Wrn:
-                Console().NotifyWarning(ce->msg.c_str());
-                break;
-            case ConsoleSingleton::MsgType_Err:
-                Console().NotifyError(ce->msg.c_str());
-                break;
-            }
+            Console().Notify(ce->msgtype, ce->msg.c_str());
         }
     }
 
@@ -111,6 +98,10 @@ private:
 
 ConsoleOutput* ConsoleOutput::instance = 0;
 
+// Set by SetThreadHandler() for threads whose messages must not reach the
+// observers directly
+static thread_local ConsoleSingleton::ThreadHandler *_ThreadHandler;
+
 }
 
 //**************************************************************************
@@ -384,6 +375,10 @@ void ConsoleSingleton::DetachObserver(ConsoleObserver *pcObserver)
 
 void ConsoleSingleton::NotifyMessage(const char *sMsg)
 {
+    if (_ThreadHandler) {
+        (*_ThreadHandler)(MsgType_Txt, sMsg);
+        return;
+    }
     for(std::set<ConsoleObserver * >::iterator Iter=_aclObservers.begin();Iter!=_aclObservers.end();++Iter) {
         if((*Iter)->bMsg)
             (*Iter)->Message(sMsg);   // send string to the listener
@@ -392,6 +387,10 @@ void ConsoleSingleton::NotifyMessage(const char *sMsg)
 
 void ConsoleSingleton::NotifyWarning(const char *sMsg)
 {
+    if (_ThreadHandler) {
+        (*_ThreadHandler)(MsgType_Wrn, sMsg);
+        return;
+    }
     for(std::set<ConsoleObserver * >::iterator Iter=_aclObservers.begin();Iter!=_aclObservers.end();++Iter) {
         if((*Iter)->bWrn)
             (*Iter)->Warning(sMsg);   // send string to the listener
@@ -400,6 +399,10 @@ void ConsoleSingleton::NotifyWarning(const char *sMsg)
 
 void ConsoleSingleton::NotifyError(const char *sMsg)
 {
+    if (_ThreadHandler) {
+        (*_ThreadHandler)(MsgType_Err, sMsg);
+        return;
+    }
     for(std::set<ConsoleObserver * >::iterator Iter=_aclObservers.begin();Iter!=_aclObservers.end();++Iter) {
         if((*Iter)->bErr)
             (*Iter)->Error(sMsg);   // send string to the listener
@@ -408,12 +411,39 @@ void ConsoleSingleton::NotifyError(const char *sMsg)
 
 void ConsoleSingleton::NotifyLog(const char *sMsg)
 {
+    if (_ThreadHandler) {
+        (*_ThreadHandler)(MsgType_Log, sMsg);
+        return;
+    }
     for(std::set<ConsoleObserver * >::iterator Iter=_aclObservers.begin();Iter!=_aclObservers.end();++Iter) {
         if((*Iter)->bLog)
             (*Iter)->Log(sMsg);   // send string to the listener
     }
 }
 
+void ConsoleSingleton::Notify(FreeCAD_ConsoleMsgType type, const char *sMsg)
+{
+    switch (type) {
+    case MsgType_Txt:
+        NotifyMessage(sMsg);
+        break;
+    case MsgType_Log:
+        NotifyLog(sMsg);
+        break;
+    case MsgType_Wrn:
+        NotifyWarning(sMsg);
+        break;
+    case MsgType_Err:
+        NotifyError(sMsg);
+        break;
+    }
+}
+
+void ConsoleSingleton::SetThreadHandler(ThreadHandler *handler)
+{
+    _ThreadHandler = handler;
+}
+
 ConsoleObserver *ConsoleSingleton::Get(const char *Name) const
 {
     const char* OName;
@@ -39,6 +39,7 @@
 #include <cstring>
 #include <sstream>
 #include <chrono>
+#include <functional>
 
 //**************************************************************************
 // Logging levels
@@ -558,6 +559,17 @@ public:
     bool IsMsgTypeEnabled(const char* sObs, FreeCAD_ConsoleMsgType type) const;
     void SetConnectionMode(ConnectionMode mode);
 
+    /// Notifies the observers with a message of the given type
+    void Notify(FreeCAD_ConsoleMsgType type, const char *sMsg);
+    typedef std::function<void(FreeCAD_ConsoleMsgType, const char*)> ThreadHandler;
+    /** Redirects the notifications issued on the calling thread
+     *
+     * While a handler is set, the messages of this thread are passed to it
+     * instead of the observers, and the handler has to deliver them later
+     * with Notify(). Pass 0 to notify the observers directly again.
+     */
+    static void SetThreadHandler(ThreadHandler *handler);
+
     int *GetLogLevel(const char *tag, bool create=true);
 
     void SetDefaultLogLevel(int level) {
@@ -68,10 +68,25 @@ void Persistence::SaveDocFile (Writer &/*writer*/) const
 {
 }
 
+bool Persistence::allowConcurrentSave (const Writer &/*writer*/) const
+{
+    return false;
+}
+
 void Persistence::RestoreDocFile(Reader &/*reader*/)
 {
 }
 
+bool Persistence::allowConcurrentRestore (const Reader &/*reader*/) const
+{
+    return false;
+}
+
+std::function<void()> Persistence::stageDocFile(Reader &/*reader*/)
+{
+    return std::function<void()>();
+}
+
 std::string Persistence::encodeAttribute(const std::string& str)
 {
     std::string tmp;
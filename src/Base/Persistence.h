@@ -28,6 +28,7 @@
 
 
 #include <assert.h>
+#include <functional>
 
 #include "BaseClass.h"
 
@@ -116,6 +117,13 @@ public:
      * In this method you can simply stream your content to the file (Base::Writer inheriting from ostream).
      */
     virtual void SaveDocFile (Writer &/*writer*/) const;
+    /** Returns true if SaveDocFile() may be called on a worker thread while
+     * other files are written, which allows to save large documents faster.
+     * SaveDocFile() must then only read this object and \a writer and must not
+     * add files. The passed writer is the one Save() has been called with.
+     * The default implementation returns false.
+     */
+    virtual bool allowConcurrentSave (const Writer &/*writer*/) const;
     /** This method is used to restore large amounts of data from a file
      * In this method you simply stream in your SaveDocFile() saved data.
      * Again you have to apply for the call of this method in the Restore() call:
@@ -146,6 +154,19 @@ public:
      * @see Base::Reader,Base::XMLReader
      */
     virtual void RestoreDocFile(Reader &/*reader*/);
+    /** Returns true if the file of RestoreDocFile() may be read with
+     * stageDocFile() on a worker thread while other files are read, which
+     * allows to open large documents faster.
+     * The default implementation returns false.
+     */
+    virtual bool allowConcurrentRestore (const Reader &/*reader*/) const;
+    /** Reads the file of RestoreDocFile() on a worker thread. This object
+     * must not be changed there, instead the read data is kept by the returned
+     * function which is called on the main thread to apply it. The functions
+     * are called in the order of the files, and \a reader must not be given a
+     * local reader. The default implementation returns an empty function.
+     */
+    virtual std::function<void()> stageDocFile(Reader &/*reader*/);
     /// Encodes an attribute upon saving.
     static std::string encodeAttribute(const std::string&);
 
@@ -30,7 +30,16 @@
 # include <xercesc/sax2/SAX2XMLReader.hpp>
 #endif
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iterator>
 #include <locale>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <QRunnable>
+#include <QThreadPool>
 
 /// Here the FreeCAD includes sorted by Base,App,Gui......
 #include "Reader.h"
@@ -40,6 +49,8 @@
 #include "InputSource.h"
 #include "Console.h"
 #include "Sequencer.h"
+#include "Stream.h"
+#include "Writer.h"
 
 #ifdef _MSC_VER
 #include <zipios++/zipios-config.h>
@@ -302,6 +313,57 @@ void Base::XMLReader::readBinFile(const char* filename)
     to.close();
 }
 
+namespace {
+
+// A file of the archive, read by XMLReader::readFiles() on a worker thread
+struct StagedFile {
+    std::string entryName;
+    std::string data;
+    std::function<void()> apply;
+    bool failed = false;
+    bool done = false;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    void finish() {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        cond.notify_all();
+    }
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [this]() { return done; });
+    }
+};
+
+// Thread pool job of XMLReader::readFiles()
+class StagedFileJob : public QRunnable
+{
+public:
+    StagedFileJob(std::function<void()> &&func)
+        : func(std::move(func))
+    {
+        setAutoDelete(true);
+    }
+    virtual void run() override {
+        func();
+    }
+
+private:
+    std::function<void()> func;
+};
+
+// The jobs read the objects, so they must be finished before leaving readFiles()
+struct StagedFileGuard {
+    std::deque<std::shared_ptr<StagedFile> > &files;
+    ~StagedFileGuard() {
+        for (auto &file : files)
+            file->wait();
+    }
+};
+
+}
+
 void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
 {
     // It's possible that not all objects inside the document could be created, e.g. if a module
@@ -323,6 +385,35 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
     }
     std::vector<FileEntry>::const_iterator it = FileList.begin();
     Base::SequencerLauncher seq("Importing project files...", FileList.size());
+
+    // The files of objects that allow a concurrent restore are inflated into
+    // a buffer and parsed in the thread pool while the next files are read.
+    // The parsed data is applied on this thread in the order of the files, so
+    // all pending files are applied before a file is restored directly. The
+    // number of buffered files is limited to keep the memory usage low.
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const bool concurrent = pool->maxThreadCount() > 1;
+    const std::size_t maxPending = 2 * pool->maxThreadCount();
+    std::deque<std::shared_ptr<StagedFile> > pending;
+    StagedFileGuard guard{pending};
+
+    auto applyPending = [&pending](std::size_t keep) {
+        while (pending.size() > keep) {
+            std::shared_ptr<StagedFile> file = pending.front();
+            file->wait();
+            pending.pop_front();
+            try {
+                if (file->failed)
+                    throw Base::RuntimeError("Failed to read file");
+                if (file->apply)
+                    file->apply();
+            }
+            catch(...) {
+                Base::Console().Error("Reading failed from embedded file: %s\n", file->entryName.c_str());
+            }
+        }
+    };
+
     while (entry->isValid() && it != FileList.end()) {
         std::vector<FileEntry>::const_iterator jt = it;
         // Check if the current entry is registered, otherwise check the next registered files as soon as
@@ -332,19 +423,57 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
         // If this condition is true both file names match and we can read-in the data, otherwise
         // no file name for the current entry in the zip was registered.
         if (jt != FileList.end()) {
-            try {
-                Base::Reader reader(zipstream, jt->FileName, FileVersion);
-                jt->Object->RestoreDocFile(reader);
-                if (reader.getLocalReader())
-                    reader.getLocalReader()->readFiles(zipstream);
+            Base::Reader reader(zipstream, jt->FileName, FileVersion, this);
+            if (concurrent && jt->Object->allowConcurrentRestore(reader)) {
+                applyPending(maxPending - 1);
+                auto file = std::make_shared<StagedFile>();
+                file->entryName = entry->toString();
+                try {
+                    file->data.assign(std::istreambuf_iterator<char>(reader),
+                                      std::istreambuf_iterator<char>());
+                }
+                catch(...) {
+                    file->failed = true;
+                    file->done = true;
+                }
+                pending.push_back(file);
+
+                if (!file->done) {
+                    Base::Persistence *object = jt->Object;
+                    const std::string fileName = jt->FileName;
+                    const int fileVersion = FileVersion;
+                    const XMLReader *owner = this;
+                    pool->start(new StagedFileJob([=]() {
+                        try {
+                            // read the buffered data in place
+                            Base::MemoryIStreambuf buf(file->data.data(), file->data.size());
+                            std::istream str(&buf);
+                            Base::Reader fileReader(str, fileName, fileVersion, owner);
+                            file->apply = object->stageDocFile(fileReader);
+                            std::string().swap(file->data);
+                        }
+                        catch(...) {
+                            file->failed = true;
+                        }
+                        file->finish();
+                    }));
+                }
             }
-            catch(...) {
-                // For any exception we just continue with the next file.
-                // It doesn't matter if the last reader has read more or
-                // less data than the file size would allow.
-                // All what we need to do is to notify the user about the
-                // failure.
-                Base::Console().Error("Reading failed from embedded file: %s\n", entry->toString().c_str());
+            else {
+                applyPending(0);
+                try {
+                    jt->Object->RestoreDocFile(reader);
+                    if (reader.getLocalReader())
+                        reader.getLocalReader()->readFiles(zipstream);
+                }
+                catch(...) {
+                    // For any exception we just continue with the next file.
+                    // It doesn't matter if the last reader has read more or
+                    // less data than the file size would allow.
+                    // All what we need to do is to notify the user about the
+                    // failure.
+                    Base::Console().Error("Reading failed from embedded file: %s\n", entry->toString().c_str());
+                }
             }
             // Go to the next registered file name
             it = jt + 1;
@@ -361,6 +490,8 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
             break;
         }
     }
+
+    applyPending(0);
 }
 
 const char *Base::XMLReader::addFile(const char* Name, Base::Persistence *Object)
@@ -392,6 +523,16 @@ bool Base::XMLReader::isRegistered(Base::Persistence *Object) const
     return false;
 }
 
+Base::Persistence *Base::XMLReader::getFileObject(const char* Name) const
+{
+    for (std::vector<FileEntry>::const_iterator it = FileList.begin(); it != FileList.end(); ++it) {
+        if (it->FileName == Name)
+            return it->Object;
+    }
+
+    return 0;
+}
+
 void Base::XMLReader::addName(const char*, const char*)
 {
 }
@@ -558,8 +699,8 @@ void Base::XMLReader::clearPartialRestoreObject(void)
 
 // ----------------------------------------------------------
 
-Base::Reader::Reader(std::istream& str, const std::string& name, int version)
-  : std::istream(str.rdbuf()), _str(str), _name(name), fileVersion(version)
+Base::Reader::Reader(std::istream& str, const std::string& name, int version, const XMLReader* owner)
+  : std::istream(str.rdbuf()), _str(str), _name(name), fileVersion(version), owner(owner)
 {
 }
 
@@ -591,3 +732,21 @@ std::shared_ptr<Base::XMLReader> Base::Reader::getLocalReader() const
 {
     return(this->localreader);
 }
+
+Base::Persistence *Base::Reader::getFileObject(const char* Name) const
+{
+    return owner ? owner->getFileObject(Name) : 0;
+}
+
+std::string Base::Reader::getSharedFileReference()
+{
+    const std::string prefix = Writer::SharedFilePrefix;
+    if (peek() != prefix[0])
+        return std::string();
+
+    std::string text;
+    std::getline(*this, text);
+    if (text.compare(0, prefix.size(), prefix) != 0)
+        throw Base::FileException("Invalid reference to a shared file", _name.c_str());
+    return text.substr(prefix.size());
+}
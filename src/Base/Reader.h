@@ -185,6 +185,8 @@ public:
     /// get all registered file names
     const std::vector<std::string>& getFilenames() const;
     bool isRegistered(Base::Persistence *Object) const;
+    /// get the object that has registered the file \a Name, or null
+    Base::Persistence *getFileObject(const char* Name) const;
     virtual void addName(const char*, const char*);
     virtual const char* getName(const char*) const;
     virtual bool doNameMapping() const;
@@ -295,18 +297,26 @@ protected:
 class BaseExport Reader : public std::istream
 {
 public:
-    Reader(std::istream&, const std::string&, int version);
+    Reader(std::istream&, const std::string&, int version, const XMLReader* owner = 0);
     ~Reader();
     std::istream& getStream();
     std::string getFileName() const;
     int getFileVersion() const;
     void initLocalReader(std::shared_ptr<Base::XMLReader>);
     std::shared_ptr<Base::XMLReader> getLocalReader() const;
+    /// get the object that has registered the file \a Name with the XMLReader of this file, or null
+    Base::Persistence *getFileObject(const char* Name) const;
+    /** Checks whether the file refers to an earlier shared file with the same content
+     * In this case the reference is read and the name of the earlier file is
+     * returned, otherwise an empty string. See Writer::addSharedFile().
+     */
+    std::string getSharedFileReference();
 
 private:
     std::istream& _str;
     std::string _name;
     int fileVersion;
+    const XMLReader* owner;
     std::shared_ptr<Base::XMLReader> localreader;
 };
 
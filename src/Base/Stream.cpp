@@ -28,6 +28,7 @@
 # include <QByteArray>
 # include <QDataStream>
 # include <QIODevice>
+# include <algorithm>
 # include <cstdlib>
 # include <string>
 # include <cstdio>
@@ -43,6 +44,40 @@
 
 using namespace Base;
 
+namespace {
+
+// The values are swapped in blocks, so that the swapping and writing of a
+// large array doesn't need a full copy of it
+template <class T>
+void writeValues(std::ostream& out, const T* values, std::size_t count, bool swap)
+{
+    if (!swap) {
+        out.write(reinterpret_cast<const char*>(values), count * sizeof(T));
+        return;
+    }
+
+    const std::size_t blockSize = 4096;
+    T block[blockSize];
+    while (count > 0) {
+        std::size_t num = std::min(count, blockSize);
+        std::memcpy(block, values, num * sizeof(T));
+        SwapEndian<T>(block, num);
+        out.write(reinterpret_cast<const char*>(block), num * sizeof(T));
+        values += num;
+        count -= num;
+    }
+}
+
+template <class T>
+void readValues(std::istream& in, T* values, std::size_t count, bool swap)
+{
+    in.read(reinterpret_cast<char*>(values), count * sizeof(T));
+    if (swap)
+        SwapEndian<T>(values, count);
+}
+
+}
+
 Stream::Stream() : _swap(false)
 {
 }
@@ -143,6 +178,54 @@ OutputStream& OutputStream::operator << (double d)
     return *this;
 }
 
+OutputStream& OutputStream::write(const int16_t* s, std::size_t count)
+{
+    writeValues(_out, s, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write(const uint16_t* us, std::size_t count)
+{
+    writeValues(_out, us, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write(const int32_t* i, std::size_t count)
+{
+    writeValues(_out, i, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write(const uint32_t* ui, std::size_t count)
+{
+    writeValues(_out, ui, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write(const int64_t* l, std::size_t count)
+{
+    writeValues(_out, l, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write(const uint64_t* ul, std::size_t count)
+{
+    writeValues(_out, ul, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write(const float* f, std::size_t count)
+{
+    writeValues(_out, f, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write(const double* d, std::size_t count)
+{
+    writeValues(_out, d, count, _swap);
+    return *this;
+}
+
 InputStream::InputStream(std::istream &rin) : _in(rin)
 {
 }
@@ -225,6 +308,54 @@ InputStream& InputStream::operator >> (double& d)
     return *this;
 }
 
+InputStream& InputStream::read(int16_t* s, std::size_t count)
+{
+    readValues(_in, s, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read(uint16_t* us, std::size_t count)
+{
+    readValues(_in, us, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read(int32_t* i, std::size_t count)
+{
+    readValues(_in, i, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read(uint32_t* ui, std::size_t count)
+{
+    readValues(_in, ui, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read(int64_t* l, std::size_t count)
+{
+    readValues(_in, l, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read(uint64_t* ul, std::size_t count)
+{
+    readValues(_in, ul, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read(float* f, std::size_t count)
+{
+    readValues(_in, f, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read(double* d, std::size_t count)
+{
+    readValues(_in, d, count, _swap);
+    return *this;
+}
+
 // ----------------------------------------------------------------------
 
 ByteArrayOStreambuf::ByteArrayOStreambuf(QByteArray& ba) : _buffer(new QBuffer(&ba))
@@ -784,3 +915,43 @@ Streambuf::seekpos(std::streambuf::pos_type pos,
 {
     return seekoff(pos, std::ios_base::beg);
 }
+
+// ----------------------------------------------------------------------
+
+MemoryIStreambuf::MemoryIStreambuf(const char* data, std::size_t size)
+{
+    // the get area covers the whole block so that reading never needs to call underflow()
+    char* beg = const_cast<char*>(data);
+    setg(beg, beg, beg + size);
+}
+
+MemoryIStreambuf::~MemoryIStreambuf()
+{
+}
+
+std::streambuf::pos_type
+MemoryIStreambuf::seekoff(std::streambuf::off_type off,
+                          std::ios_base::seekdir way,
+                          std::ios_base::openmode /*mode*/)
+{
+    off_type pos;
+    if (way == std::ios_base::beg)
+        pos = off;
+    else if (way == std::ios_base::end)
+        pos = (egptr() - eback()) + off;
+    else
+        pos = (gptr() - eback()) + off;
+
+    if (pos < 0 || pos > (egptr() - eback()))
+        return pos_type(off_type(-1));
+
+    setg(eback(), eback() + pos, egptr());
+    return pos_type(pos);
+}
+
+std::streambuf::pos_type
+MemoryIStreambuf::seekpos(std::streambuf::pos_type pos,
+                          std::ios_base::openmode /*mode*/)
+{
+    return seekoff(pos, std::ios_base::beg);
+}
@@ -81,6 +81,21 @@ public:
     OutputStream& operator << (float f);
     OutputStream& operator << (double d);
 
+    /** @name Bulk writing
+     * Writes \a count values of an array at once, which is much faster for
+     * large arrays than writing them one by one.
+     */
+    //@{
+    OutputStream& write(const int16_t* s, std::size_t count);
+    OutputStream& write(const uint16_t* us, std::size_t count);
+    OutputStream& write(const int32_t* i, std::size_t count);
+    OutputStream& write(const uint32_t* ui, std::size_t count);
+    OutputStream& write(const int64_t* l, std::size_t count);
+    OutputStream& write(const uint64_t* ul, std::size_t count);
+    OutputStream& write(const float* f, std::size_t count);
+    OutputStream& write(const double* d, std::size_t count);
+    //@}
+
 private:
     OutputStream (const OutputStream&);
     void operator = (const OutputStream&);
@@ -111,6 +126,21 @@ public:
     InputStream& operator >> (float& f);
     InputStream& operator >> (double& d);
 
+    /** @name Bulk reading
+     * Reads \a count values into an array at once, which is much faster for
+     * large arrays than reading them one by one.
+     */
+    //@{
+    InputStream& read(int16_t* s, std::size_t count);
+    InputStream& read(uint16_t* us, std::size_t count);
+    InputStream& read(int32_t* i, std::size_t count);
+    InputStream& read(uint32_t* ui, std::size_t count);
+    InputStream& read(int64_t* l, std::size_t count);
+    InputStream& read(uint64_t* ul, std::size_t count);
+    InputStream& read(float* f, std::size_t count);
+    InputStream& read(double* d, std::size_t count);
+    //@}
+
     operator bool() const
     {
         // test if _Ipfx succeeded
@@ -293,6 +323,37 @@ private:
     std::string::const_iterator _cur;
 };
 
+/**
+ * This class implements the streambuf interface to read data from a block of
+ * memory, e.g. a memory-mapped file, without copying it first. The memory must
+ * stay valid as long as the stream buffer is used.
+ * This class can only be used for reading but not for writing purposes.
+ */
+class BaseExport MemoryIStreambuf : public std::streambuf
+{
+public:
+    MemoryIStreambuf(const char* data, std::size_t size);
+    ~MemoryIStreambuf();
+
+    /// Gives direct access to the whole memory block
+    const char* data() const
+    { return eback(); }
+    std::size_t size() const
+    { return static_cast<std::size_t>(egptr() - eback()); }
+    /// The current read position relative to data()
+    std::size_t tell() const
+    { return static_cast<std::size_t>(gptr() - eback()); }
+
+protected:
+    virtual pos_type seekoff(std::streambuf::off_type off,
+        std::ios_base::seekdir way,
+        std::ios_base::openmode which =
+            std::ios::in | std::ios::out);
+    virtual pos_type seekpos(std::streambuf::pos_type pos,
+        std::ios_base::openmode which =
+            std::ios::in | std::ios::out);
+};
+
 // ----------------------------------------------------------------------------
 
 class FileInfo;
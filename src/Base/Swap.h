@@ -27,6 +27,8 @@
 #define LOW_ENDIAN	(unsigned short) 0x4949 
 #define HIGH_ENDIAN	(unsigned short) 0x4D4D 
 
+#include <cstddef>
+#include <utility>
 
 namespace Base {
 
@@ -58,6 +60,19 @@ void SwapEndian(T& v)
   v = tmp;
 }
 
+/** Swaps the byte order of \a count values of an array. As the size of the
+ * values is known at compile time the loop can be vectorized.
+ */
+template <class T>
+void SwapEndian(T* v, std::size_t count)
+{
+  char* data = reinterpret_cast<char*>(v);
+  for (std::size_t n = 0; n < count; n++, data += sizeof (T)) {
+    for (std::size_t i = 0; i < sizeof (T) / 2; i++)
+      std::swap(data[i], data[sizeof (T) - i - 1]);
+  }
+}
+
 } // namespace Base
 
 
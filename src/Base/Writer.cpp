@@ -36,8 +36,18 @@
 #include "Tools.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <locale>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <QCryptographicHash>
+#include <QRunnable>
+#include <QThreadPool>
+#include <zlib.h>
 
 using namespace Base;
 using namespace std;
@@ -49,6 +59,8 @@ using namespace zipios;
 //  Writer: Constructors and Destructor
 // ---------------------------------------------------------------------------
 
+const char Writer::SharedFilePrefix[] = "@SharedFile:";
+
 Writer::Writer(void)
   : indent(0),forceXML(false),fileVersion(1)
 {
@@ -170,6 +182,7 @@ std::string Writer::addFile(const char* Name,const Base::Persistence *Object)
     FileEntry temp;
     temp.FileName = getUniqueFileName(Name);
     temp.Object = Object;
+    temp.Shared = false;
   
     FileList.push_back(temp);
 
@@ -179,6 +192,18 @@ std::string Writer::addFile(const char* Name,const Base::Persistence *Object)
     return temp.FileName;
 }
 
+std::string Writer::addSharedFile(const char* Key, const char* Name, const Base::Persistence *Object)
+{
+    auto it = SharedFiles.find(Key);
+    if (it != SharedFiles.end())
+        return it->second;
+
+    std::string name = addFile(Name, Object);
+    FileList.back().Shared = true;
+    SharedFiles[Key] = name;
+    return name;
+}
+
 std::string Writer::getUniqueFileName(const char *Name)
 {
     // name in use?
@@ -240,43 +265,302 @@ void Writer::decInd(void)
 
 // ----------------------------------------------------------------------------
 
-ZipWriter::ZipWriter(const char* FileName) 
-  : ZipStream(FileName)
+static void setupZipStream(std::ostream &str)
 {
 #ifdef _MSC_VER
-    ZipStream.imbue(std::locale::empty());
+    str.imbue(std::locale::empty());
 #else
     //FIXME: Check whether this is correct
-    ZipStream.imbue(std::locale::classic());
+    str.imbue(std::locale::classic());
 #endif
-    ZipStream.precision(std::numeric_limits<double>::digits10 + 1);
-    ZipStream.setf(ios::fixed,ios::floatfield);
+    str.precision(std::numeric_limits<double>::digits10 + 1);
+    str.setf(ios::fixed,ios::floatfield);
+}
+
+namespace Base {
+
+// SHA-1 of the content of a shared file, see Writer::addSharedFile()
+static std::string sharedFileDigest(const std::string &data)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const std::size_t chunk = 1 << 30;
+    for (std::size_t pos = 0; pos < data.size(); pos += chunk)
+        hash.addData(data.data() + pos, static_cast<int>(std::min(chunk, data.size() - pos)));
+    return hash.result().toHex().constData();
+}
+
+// A file of the archive, serialized and compressed by ZipWriter::writeFiles()
+struct ZipEntry {
+    std::string fileName;
+    std::string data;
+    bool shared = false;
+    std::string digest;
+    uLong crc = 0;
+    uLong size = 0;
+    std::vector<std::string> errors;
+    std::exception_ptr exception;
+    bool done = false;
+
+    void compress(int level, bool store) {
+        if (shared && digest.empty())
+            digest = sharedFileDigest(data);
+        // the archive is written without Zip64 extension
+        if (data.size() > 0xffffffffUL)
+            throw Base::FileException("ZipWriter: file exceeds 4 GiB", fileName.c_str());
+        size = static_cast<uLong>(data.size());
+
+        // zlib takes at most uInt bytes per call
+        const std::size_t chunk = 1 << 30;
+        crc = crc32(0, Z_NULL, 0);
+        for (std::size_t pos = 0; pos < data.size(); pos += chunk)
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(data.data() + pos),
+                        static_cast<uInt>(std::min(chunk, data.size() - pos)));
+        if (store)
+            return;
+
+        // raw deflate without zlib header, as ZipOutputStreambuf does
+        z_stream zs;
+        zs.zalloc = Z_NULL;
+        zs.zfree = Z_NULL;
+        zs.opaque = Z_NULL;
+        if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            throw Base::RuntimeError("ZipWriter: failed to initialize compression");
+
+        std::string out;
+        out.resize(deflateBound(&zs, size));
+        std::size_t inLeft = data.size();
+        std::size_t outLeft = out.size();
+        zs.next_in = reinterpret_cast<Bytef*>(&data[0]);
+        zs.avail_in = 0;
+        zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+        zs.avail_out = 0;
+        int err;
+        do {
+            if (zs.avail_in == 0) {
+                zs.avail_in = static_cast<uInt>(std::min(chunk, inLeft));
+                inLeft -= zs.avail_in;
+            }
+            if (zs.avail_out == 0) {
+                zs.avail_out = static_cast<uInt>(std::min(chunk, outLeft));
+                outLeft -= zs.avail_out;
+            }
+            err = deflate(&zs, inLeft ? Z_NO_FLUSH : Z_FINISH);
+        } while (err == Z_OK);
+        out.resize(out.size() - outLeft - zs.avail_out);
+        deflateEnd(&zs);
+        if (err != Z_STREAM_END)
+            throw Base::RuntimeError("ZipWriter: failed to compress file");
+        data.swap(out);
+    }
+};
+
+// Writer to serialize a file into a buffer on a worker thread
+class ZipEntryWriter : public Writer
+{
+public:
+    ZipEntryWriter(const Writer &writer) {
+        setModes(writer.getModes());
+        setFileVersion(writer.getFileVersion());
+        ObjectName = writer.ObjectName;
+        setupZipStream(StrStream);
+    }
+    virtual std::ostream &Stream(void) {return StrStream;}
+    virtual void writeFiles(void) {}
+
+    std::ostringstream StrStream;
+};
+
+// Thread pool job of ZipWriter::writeFiles()
+class ZipEntryJob : public QRunnable
+{
+public:
+    ZipEntryJob(std::function<void()> &&func)
+        : func(std::move(func))
+    {
+        setAutoDelete(true);
+    }
+    virtual void run() override {
+        func();
+    }
+
+private:
+    std::function<void()> func;
+};
+
+} // namespace Base
+
+ZipWriter::ZipWriter(const char* FileName) 
+  : ZipStream(FileName), EntryStream(0)
+{
+    setupZipStream(ZipStream);
 }
 
 ZipWriter::ZipWriter(std::ostream& os) 
-  : ZipStream(os)
+  : ZipStream(os), EntryStream(0)
 {
-#ifdef _MSC_VER
-    ZipStream.imbue(std::locale::empty());
-#else
-    //FIXME: Check whether this is correct
-    ZipStream.imbue(std::locale::classic());
-#endif
-    ZipStream.precision(std::numeric_limits<double>::digits10 + 1);
-    ZipStream.setf(ios::fixed,ios::floatfield);
+    setupZipStream(ZipStream);
 }
 
 void ZipWriter::writeFiles(void)
 {
-    // use a while loop because it is possible that while
-    // processing the files new ones can be added
+    QThreadPool *pool = QThreadPool::globalInstance();
+    if (pool->maxThreadCount() < 2) {
+        // use a while loop because it is possible that while
+        // processing the files new ones can be added
+        size_t index = 0;
+        while (index < FileList.size()) {
+            FileEntry entry = FileList.begin()[index];
+            ZipStream.putNextEntry(entry.FileName);
+            if (!entry.Shared) {
+                entry.Object->SaveDocFile(*this);
+                index++;
+                continue;
+            }
+
+            // a shared file is buffered to compare it with the earlier ones
+            std::ostringstream buffer;
+            setupZipStream(buffer);
+            EntryStream = &buffer;
+            try {
+                entry.Object->SaveDocFile(*this);
+            }
+            catch (...) {
+                EntryStream = 0;
+                throw;
+            }
+            EntryStream = 0;
+            std::string data = buffer.str();
+            std::string other = findSharedFile(sharedFileDigest(data), entry.FileName);
+            if (other.empty())
+                ZipStream.write(data.c_str(), data.size());
+            else
+                ZipStream << SharedFilePrefix << other;
+            index++;
+        }
+        return;
+    }
+
+    // Each file is serialized into its own buffer and compressed in the thread
+    // pool. Objects that do not allow a concurrent save are serialized on this
+    // thread, as they may add further files or access shared data. The files
+    // are appended in the order they have been added, so that the layout of
+    // the archive doesn't change. The number of buffered files is limited to
+    // keep the memory usage low.
+    const std::size_t maxPending = 2 * pool->maxThreadCount();
+    const int level = ZipStream.getLevel();
+    const bool store = ZipStream.getMethod() == zipios::STORED;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<std::shared_ptr<ZipEntry> > pending;
+    std::exception_ptr error;
+
+    auto finish = [&](ZipEntry &entry) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entry.done = true;
+        cond.notify_all();
+    };
+
     size_t index = 0;
-    while (index < FileList.size()) {
-        FileEntry entry = FileList.begin()[index];
-        ZipStream.putNextEntry(entry.FileName);
-        entry.Object->SaveDocFile(*this);
-        index++;
+    for (;;) {
+        while (!error && index < FileList.size() && pending.size() < maxPending) {
+            FileEntry file = FileList.begin()[index++];
+            auto entry = std::make_shared<ZipEntry>();
+            entry->fileName = file.FileName;
+            entry->shared = file.Shared;
+            pending.push_back(entry);
+
+            if (file.Object->allowConcurrentSave(*this)) {
+                auto writer = std::make_shared<ZipEntryWriter>(*this);
+                const Base::Persistence *object = file.Object;
+                pool->start(new ZipEntryJob([=,&finish]() {
+                    try {
+                        object->SaveDocFile(*writer);
+                        entry->data = writer->StrStream.str();
+                        entry->errors = writer->getErrors();
+                        entry->compress(level, store);
+                    }
+                    catch (...) {
+                        entry->exception = std::current_exception();
+                    }
+                    finish(*entry);
+                }));
+                continue;
+            }
+
+            std::ostringstream buffer;
+            setupZipStream(buffer);
+            EntryStream = &buffer;
+            try {
+                file.Object->SaveDocFile(*this);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            EntryStream = 0;
+            if (error) {
+                finish(*entry);
+                break;
+            }
+
+            entry->data = buffer.str();
+            pool->start(new ZipEntryJob([=,&finish]() {
+                try {
+                    entry->compress(level, store);
+                }
+                catch (...) {
+                    entry->exception = std::current_exception();
+                }
+                finish(*entry);
+            }));
+        }
+
+        if (pending.empty())
+            break;
+
+        // The jobs refer to this stack frame, so after an error the remaining
+        // ones are only waited for
+        std::shared_ptr<ZipEntry> entry = pending.front();
+        pending.pop_front();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&]() { return entry->done; });
+        }
+        if (!error)
+            error = entry->exception;
+        if (error)
+            continue;
+
+        try {
+            for (const auto &msg : entry->errors)
+                addError(msg);
+            // the digests are registered in the order of the files, so that a
+            // reference always points to a file that is read before
+            if (entry->shared) {
+                std::string other = findSharedFile(entry->digest, entry->fileName);
+                if (!other.empty()) {
+                    entry->data = SharedFilePrefix + other;
+                    entry->shared = false;
+                    entry->compress(level, store);
+                }
+            }
+            ZipStream.putRawEntry(entry->fileName, entry->data, entry->crc, entry->size);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
     }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+std::string ZipWriter::findSharedFile(const std::string& digest, const std::string& name)
+{
+    auto res = SharedDigests.insert(std::make_pair(digest, name));
+    if (res.second)
+        return std::string();
+    return res.first->second;
 }
 
 ZipWriter::~ZipWriter()
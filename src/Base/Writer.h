@@ -24,6 +24,7 @@
 #define BASE_WRITER_H
 
 
+#include <map>
 #include <set>
 #include <string>
 #include <sstream>
@@ -77,6 +78,15 @@ public:
     //@{
     /// add a write request of a persistent object
     std::string addFile(const char* Name, const Base::Persistence *Object);
+    /** add a write request of a file that can be shared by several objects
+     * Only the first request with the given key adds the file, the others get
+     * its name back. A writer may additionally store a shared file with the
+     * same content as an earlier one as a reference to that file, which the
+     * object has to resolve with Reader::getSharedFileReference().
+     */
+    std::string addSharedFile(const char* Key, const char* Name, const Base::Persistence *Object);
+    /// prefix of a file that refers to an earlier shared file with the same content
+    static const char SharedFilePrefix[];
     /// process the requested file storing
     virtual void writeFiles(void)=0;
     /// get all registered file names
@@ -123,9 +133,11 @@ protected:
     struct FileEntry {
         std::string FileName;
         const Base::Persistence *Object;
+        bool Shared;
     };
     std::vector<FileEntry> FileList;
     std::vector<std::string> FileNames;
+    std::map<std::string, std::string> SharedFiles;
     std::vector<std::string> Errors;
     std::set<std::string> Modes;
 
@@ -150,16 +162,28 @@ public:
     ZipWriter(std::ostream&);
     virtual ~ZipWriter();
 
+    /** Writes the requested files. They are serialized and compressed in
+     * the thread pool, see Persistence::allowConcurrentSave(), and appended
+     * to the archive in the order they have been added.
+     */
     virtual void writeFiles(void);
 
-    virtual std::ostream &Stream(void){return ZipStream;}
+    virtual std::ostream &Stream(void){return EntryStream ? *EntryStream : ZipStream;}
 
     void setComment(const char* str){ZipStream.setComment(str);}
     void setLevel(int level){ZipStream.setLevel( level );}
     void putNextEntry(const char* str){ZipStream.putNextEntry(str);}
 
+private:
+    /// returns the name of an earlier shared file with the same digest or registers this one
+    std::string findSharedFile(const std::string& digest, const std::string& name);
+
 private:
     zipios::ZipOutputStream ZipStream;
+    /// buffer of the file being serialized by writeFiles()
+    std::ostream *EntryStream;
+    /// the digests of the shared files written so far and their names
+    std::map<std::string, std::string> SharedDigests;
 };
 
 /** The StringWriter class 
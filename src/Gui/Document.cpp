@@ -39,6 +39,8 @@
 #endif
 
 #include <cctype>
+#include <cstdint>
+#include <limits>
 
 #include <Base/Console.h>
 #include <Base/Exception.h>
@@ -215,6 +217,10 @@ Document::Document(App::Document* pcDocument,Application * app)
         d->_pcDocument->setUndoMode(1);
         // set the maximum stack size
         d->_pcDocument->setMaxUndoStackSize(hGrp->GetInt("MaxUndoSize",20));
+        // and the maximum memory of the stack in MB, 0 for no limit
+        std::uint64_t limit = hGrp->GetUnsigned("MaxUndoMemSize",0);
+        limit = std::min<std::uint64_t>(limit * 1024 * 1024, std::numeric_limits<std::size_t>::max());
+        d->_pcDocument->setUndoLimit(static_cast<std::size_t>(limit));
     }
 
     d->_changeViewTouchDocument = hGrp->GetBool("ChangeViewProviderTouchDocument", true);
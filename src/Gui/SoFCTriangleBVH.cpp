@@ -0,0 +1,292 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+#endif
+
+#include <Inventor/SoPrimitiveVertex.h>
+#include <Inventor/actions/SoRayPickAction.h>
+#include <Inventor/bundles/SoTextureCoordinateBundle.h>
+#include <Inventor/details/SoFaceDetail.h>
+#include <Inventor/details/SoPointDetail.h>
+#include <Inventor/elements/SoCoordinateElement.h>
+#include <Inventor/fields/SoMFInt32.h>
+#include <Inventor/sensors/SoFieldSensor.h>
+
+#include "SoFCTriangleBVH.h"
+
+using namespace Gui;
+
+namespace {
+// maximum number of triangles in a leaf
+const int LeafSize = 8;
+}
+
+SoFCTriangleBVH::SoFCTriangleBVH(SoMFInt32 *coordIndex)
+  : coordIndex(coordIndex)
+  , coordNodeId(0)
+  , numCoords(0)
+  , modified(true)
+{
+    sensor = new SoFieldSensor(coordIndexChanged, this);
+    // invalidate right away, a pick may follow before the sensor queue is processed
+    sensor->setPriority(0);
+    sensor->attach(coordIndex);
+}
+
+SoFCTriangleBVH::~SoFCTriangleBVH()
+{
+    delete sensor;
+}
+
+void SoFCTriangleBVH::coordIndexChanged(void *data, SoSensor *)
+{
+    static_cast<SoFCTriangleBVH*>(data)->modified = true;
+}
+
+bool SoFCTriangleBVH::update(const SoCoordinateElement *coords)
+{
+    if (!coords)
+        return false;
+    if (modified || coords->getNodeId() != coordNodeId || coords->getNum() != numCoords) {
+        build(coords);
+        modified = false;
+        coordNodeId = coords->getNodeId();
+        numCoords = coords->getNum();
+    }
+    return !nodes.empty();
+}
+
+void SoFCTriangleBVH::build(const SoCoordinateElement *coords)
+{
+    nodes.clear();
+    triangles.clear();
+
+    // a trailing -1 may be omitted
+    int num = coordIndex->getNum();
+    int count = (num + 1) / 4;
+    if (count < MinTriangles || (num + 1) % 4 > 1)
+        return;
+
+    const int32_t *indices = coordIndex->getValues(0);
+    int maxIndex = coords->getNum();
+    std::vector<SbBox3f> boxes(count);
+    std::vector<SbVec3f> centers(count);
+    SbBox3f bound;
+    for (int i=0; i<count; i++) {
+        const int32_t *tria = indices + 4*i;
+        if (tria[0] < 0 || tria[1] < 0 || tria[2] < 0 ||
+            tria[0] >= maxIndex || tria[1] >= maxIndex || tria[2] >= maxIndex ||
+            (4*i+3 < num && tria[3] >= 0))
+            return; // no triangle list
+        SbBox3f &box = boxes[i];
+        box.extendBy(coords->get3(tria[0]));
+        box.extendBy(coords->get3(tria[1]));
+        box.extendBy(coords->get3(tria[2]));
+        centers[i] = box.getCenter();
+        bound.extendBy(box);
+    }
+
+    // enlarge the boxes a bit so that flat boxes and rays hitting an edge are not missed
+    float dx, dy, dz;
+    bound.getSize(dx, dy, dz);
+    float eps = std::max(std::max(dx, dy), dz) * 1e-6f;
+    SbVec3f offset(eps, eps, eps);
+    for (auto &box : boxes)
+        box.setBounds(box.getMin() - offset, box.getMax() + offset);
+
+    triangles.resize(count);
+    for (int i=0; i<count; i++)
+        triangles[i] = i;
+    nodes.reserve(2 * count / LeafSize + 1);
+    buildNode(0, count, boxes, centers);
+}
+
+void SoFCTriangleBVH::buildNode(int first, int count, const std::vector<SbBox3f> &boxes,
+                                const std::vector<SbVec3f> &centers)
+{
+    int index = static_cast<int>(nodes.size());
+    nodes.emplace_back();
+
+    SbBox3f box, centerBox;
+    for (int i=first; i<first+count; i++) {
+        box.extendBy(boxes[triangles[i]]);
+        centerBox.extendBy(centers[triangles[i]]);
+    }
+    nodes[index].box = box;
+    nodes[index].first = first;
+
+    float dx, dy, dz;
+    centerBox.getSize(dx, dy, dz);
+    if (count <= LeafSize || std::max(std::max(dx, dy), dz) <= 0.0f) {
+        nodes[index].count = count;
+        nodes[index].right = -1;
+        return;
+    }
+
+    // split at the median along the longest axis of the triangle centers
+    int axis = (dx >= dy && dx >= dz) ? 0 : (dy >= dz ? 1 : 2);
+    int half = count / 2;
+    std::nth_element(triangles.begin() + first, triangles.begin() + first + half,
+                     triangles.begin() + first + count, [&](int a, int b) {
+        return centers[a][axis] < centers[b][axis];
+    });
+
+    nodes[index].count = 0;
+    buildNode(first, half, boxes, centers);
+    nodes[index].right = static_cast<int>(nodes.size());
+    buildNode(first + half, count - half, boxes, centers);
+}
+
+void SoFCTriangleBVH::rayPick(SoRayPickAction *action, std::vector<int> &indices) const
+{
+    indices.clear();
+    if (nodes.empty())
+        return;
+
+    std::vector<int> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node &node = nodes[index];
+        if (!action->intersect(node.box, FALSE))
+            continue;
+        if (node.count > 0) {
+            indices.insert(indices.end(), triangles.begin() + node.first,
+                           triangles.begin() + node.first + node.count);
+        }
+        else {
+            stack.push_back(node.right);
+            stack.push_back(index + 1);
+        }
+    }
+
+    // keep the order of the triangles as generated by the face set
+    std::sort(indices.begin(), indices.end());
+}
+
+void SoFCTriangleBVH::generateTriangles(const std::vector<int> &triangles, const TriangleData &data,
+                                        SoFaceDetail &faceDetail,
+                                        const std::function<void(SoPrimitiveVertex*)> &shapeVertex)
+{
+    // In a plain triangle list the bindings of a triangle follow from its index
+    SoPrimitiveVertex vertex;
+    SoPointDetail pointDetail;
+    vertex.setDetail(&pointDetail);
+
+    SbVec3f dummynormal(0,0,1);
+    const SbVec3f *currnormal = data.normals ? data.normals : &dummynormal;
+    vertex.setNormal(*currnormal);
+
+    // the triangles are sorted, so the parts are found by a single pass
+    int part = 0;
+    int partStart = 0;
+    auto partCount = [&](int index) {
+        return index < data.numParts ? data.partIndex[index] : -1;
+    };
+
+    for (int trinr : triangles) {
+        if (data.partIndex) {
+            int count = partCount(part);
+            while (count == 0 || (count > 0 && trinr >= partStart + count)) {
+                partStart += count;
+                count = partCount(++part);
+            }
+        }
+        else {
+            part = trinr;
+        }
+
+        int matnr = -1;
+        if (data.mbind == PerPart)
+            matnr = part;
+        else if (data.mbind == PerPartIndexed)
+            matnr = data.mindices ? data.mindices[part] : part;
+        else if (data.mbind == PerFace)
+            matnr = trinr;
+        else if (data.mbind == PerFaceIndexed)
+            matnr = data.mindices ? data.mindices[trinr] : trinr;
+        if (matnr >= 0) {
+            pointDetail.setMaterialIndex(matnr);
+            vertex.setMaterialIndex(matnr);
+        }
+
+        int normnr = -1;
+        if (data.nbind == PerPart)
+            normnr = part;
+        else if (data.nbind == PerPartIndexed)
+            normnr = data.nindices ? data.nindices[part] : part;
+        else if (data.nbind == PerFace)
+            normnr = trinr;
+        else if (data.nbind == PerFaceIndexed)
+            normnr = data.nindices ? data.nindices[trinr] : trinr;
+        if (normnr >= 0) {
+            pointDetail.setNormalIndex(normnr);
+            currnormal = &data.normals[normnr];
+            vertex.setNormal(*currnormal);
+        }
+
+        faceDetail.setFaceIndex(trinr);
+        for (int i=0; i<3; i++) {
+            int vi = 4*trinr + i; // position in the index arrays
+            int vnr = 3*trinr + i; // number of the vertex
+            int32_t idx = data.cindices[vi];
+            if (data.mbind == PerVertex) {
+                pointDetail.setMaterialIndex(vnr);
+                vertex.setMaterialIndex(vnr);
+            }
+            else if (data.mbind == PerVertexIndexed) {
+                pointDetail.setMaterialIndex(data.mindices[vi]);
+                vertex.setMaterialIndex(data.mindices[vi]);
+            }
+            if (data.nbind == PerVertex) {
+                pointDetail.setNormalIndex(vnr);
+                currnormal = &data.normals[vnr];
+                vertex.setNormal(*currnormal);
+            }
+            else if (data.nbind == PerVertexIndexed) {
+                pointDetail.setNormalIndex(data.nindices[vi]);
+                currnormal = &data.normals[data.nindices[vi]];
+                vertex.setNormal(*currnormal);
+            }
+            if (data.tb) {
+                int texnr = data.tindices ? data.tindices[vi] : vnr;
+                if (data.tb->isFunction()) {
+                    vertex.setTextureCoords(data.tb->get(data.coords->get3(idx), *currnormal));
+                    if (data.tb->needIndices())
+                        pointDetail.setTextureCoordIndex(texnr);
+                }
+                else {
+                    pointDetail.setTextureCoordIndex(texnr);
+                    vertex.setTextureCoords(data.tb->get(texnr));
+                }
+            }
+            vertex.setPoint(data.coords->get3(idx));
+            pointDetail.setCoordinateIndex(idx);
+            shapeVertex(&vertex);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef GUI_SOFCTRIANGLEBVH_H
+#define GUI_SOFCTRIANGLEBVH_H
+
+#include <functional>
+#include <vector>
+#include <Inventor/SbBox3f.h>
+
+class SoCoordinateElement;
+class SoFaceDetail;
+class SoFieldSensor;
+class SoMFInt32;
+class SoPrimitiveVertex;
+class SoRayPickAction;
+class SoSensor;
+class SoTextureCoordinateBundle;
+
+namespace Gui {
+
+/**
+ * Bounding volume hierarchy over the triangles of an indexed face set. It is used
+ * by face set nodes to ray pick only the triangles whose bounding box is hit
+ * instead of generating and testing every triangle on each mouse move.
+ *
+ * The coordinate indices must form a plain triangle list, i.e. v1,v2,v3,-1 per
+ * triangle. The tree is built on the first pick and rebuilt after the coordinate
+ * indices or the coordinates have changed.
+ */
+class GuiExport SoFCTriangleBVH
+{
+public:
+    /// The tree watches \a coordIndex for changes
+    SoFCTriangleBVH(SoMFInt32 *coordIndex);
+    ~SoFCTriangleBVH();
+
+    /** Builds the tree for \a coords if needed. Returns false if the face set
+     * is too small to need a tree or not a triangle list.
+     */
+    bool update(const SoCoordinateElement *coords);
+    /// Collects the sorted indices of the triangles whose bounding box is hit by the pick ray
+    void rayPick(SoRayPickAction *action, std::vector<int> &indices) const;
+
+    /// Face sets with less triangles are picked without a tree
+    static const int MinTriangles = 2048;
+
+    /// Binding of materials and normals, in the order of SoIndexedFaceSet
+    enum Binding {
+        Overall = 0,
+        PerPart,
+        PerPartIndexed,
+        PerFace,
+        PerFaceIndexed,
+        PerVertex,
+        PerVertexIndexed
+    };
+
+    /// Vertex data of a face set, see generateTriangles()
+    struct TriangleData {
+        const SoCoordinateElement *coords;
+        const SbVec3f *normals;
+        const int32_t *cindices;
+        const int32_t *nindices;
+        const int32_t *tindices;     // null if the texture coordinates are not indexed
+        const int32_t *mindices;
+        Binding mbind;
+        Binding nbind;
+        SoTextureCoordinateBundle *tb; // null without textures
+        const int32_t *partIndex;    // triangles per part, null if each triangle is a part
+        int numParts;
+    };
+
+    /** Generates the sorted \a triangles of a triangle list with the same vertices
+     * and details as the full traversal of the face set. The face set begins the
+     * shape with \a faceDetail and passes each vertex to its shapeVertex().
+     */
+    static void generateTriangles(const std::vector<int> &triangles, const TriangleData &data,
+                                  SoFaceDetail &faceDetail,
+                                  const std::function<void(SoPrimitiveVertex*)> &shapeVertex);
+
+private:
+    struct Node {
+        SbBox3f box;
+        int first;  // first triangle of a leaf
+        int count;  // number of triangles of a leaf, 0 for inner nodes
+        int right;  // right child of an inner node, the left child follows the node
+    };
+
+    void build(const SoCoordinateElement *coords);
+    void buildNode(int first, int count, const std::vector<SbBox3f> &boxes,
+                   const std::vector<SbVec3f> &centers);
+    static void coordIndexChanged(void *data, SoSensor *);
+
+    SoMFInt32 *coordIndex;
+    SoFieldSensor *sensor;
+    std::vector<Node> nodes;
+    std::vector<int> triangles;
+    uint32_t coordNodeId;
+    int numCoords;
+    bool modified;
+};
+
+} // namespace Gui
+
+#endif // GUI_SOFCTRIANGLEBVH_H
@@ -940,6 +940,7 @@ void TreeWidget::showEvent(QShowEvent *ev) {
     _updateStatus();
 #endif
     QTreeWidget::showEvent(ev);
+    updateVisibleStatus();
 }
 
 void TreeWidget::onCreateGroup()
@@ -2218,8 +2219,10 @@ void TreeWidget::slotTouchedObject(const App::DocumentObject &obj) {
 void TreeWidget::slotShowHidden(const Gui::Document& Doc)
 {
     auto it = DocumentMap.find(&Doc);
-    if (it != DocumentMap.end())
+    if (it != DocumentMap.end()) {
         it->second->updateItemsVisibility(it->second,it->second->showHidden());
+        updateVisibleStatus();
+    }
 }
 
 void TreeWidget::slotRelabelDocument(const Gui::Document& Doc)
@@ -2248,6 +2251,7 @@ void TreeWidget::slotActiveDocument(const Gui::Document& Doc)
         // this must be done as last step
         it->second->setFont(0, f);
     }
+    updateVisibleStatus();
 }
 
 struct UpdateDisabler {
@@ -2370,9 +2374,7 @@ void TreeWidget::onUpdateStatus(void)
 
     FC_LOG("update item status");
     TimingInit();
-    for (auto pos = DocumentMap.begin();pos!=DocumentMap.end();++pos) {
-        pos->second->testStatus();
-    }
+    updateVisibleStatus();
     TimingPrint();
 
     // Checking for just restored documents
@@ -2522,9 +2524,9 @@ void TreeWidget::onPreSelectTimer() {
 void TreeWidget::onItemCollapsed(QTreeWidgetItem * item)
 {
     // object item collapsed
-    if (item && item->type() == TreeWidget::ObjectType) {
+    if (item && item->type() == TreeWidget::ObjectType)
         static_cast<DocumentObjectItem*>(item)->setExpandedStatus(false);
-    }
+    updateVisibleStatus();
 }
 
 void TreeWidget::onItemExpanded(QTreeWidgetItem * item)
@@ -2535,6 +2537,40 @@ void TreeWidget::onItemExpanded(QTreeWidgetItem * item)
         objItem->setExpandedStatus(true);
         objItem->getOwnerDocument()->populateItem(objItem,false,false);
     }
+    updateVisibleStatus();
+}
+
+void TreeWidget::scrollContentsBy(int dx, int dy)
+{
+    QTreeWidget::scrollContentsBy(dx,dy);
+    if(dy)
+        updateVisibleStatus();
+}
+
+void TreeWidget::resizeEvent(QResizeEvent *ev)
+{
+    QTreeWidget::resizeEvent(ev);
+    updateVisibleStatus();
+}
+
+void TreeWidget::updateVisibleStatus()
+{
+    // Only check the status of the rows inside the viewport. Rows that are
+    // scrolled or folded out of view are checked once they are shown again,
+    // so that the cost of a status update does not grow with the number of
+    // objects in the document. Items of the same object share their icons,
+    // like in DocumentObjectData::testStatus().
+    std::unordered_map<DocumentObjectData*,std::pair<QIcon,QIcon> > icons;
+    int height = viewport()->height();
+    for(auto item=itemAt(0,0);item;item=itemBelow(item)) {
+        if(visualItemRect(item).top() >= height)
+            break;
+        if(item->type() != ObjectType)
+            continue;
+        auto objItem = static_cast<DocumentObjectItem*>(item);
+        auto &icon = icons[objItem->myData.get()];
+        objItem->testStatus(false,icon.first,icon.second);
+    }
 }
 
 void TreeWidget::scrollItemToTop()
@@ -3230,6 +3266,7 @@ void TreeWidget::_slotDeleteObject(const Gui::ViewProviderDocumentObject& view,
         bool lock = blockConnection(true);
         for(auto cit=items.begin(),citNext=cit;cit!=items.end();cit=citNext) {
             ++citNext;
+            docItem->SelectedItems.erase(*cit);
             (*cit)->myOwner = 0;
             delete *cit;
         }
@@ -3331,6 +3368,7 @@ void DocumentItem::populateItem(DocumentObjectItem *item, bool refresh, bool del
     item->populated = true;
     bool checkHidden = !showHidden();
     bool updated = false;
+    bool hiddenChanged = false;
 
     int i=-1;
     // iterate through the claimed children, and try to synchronize them with the 
@@ -3356,8 +3394,10 @@ void DocumentItem::populateItem(DocumentObjectItem *item, bool refresh, bool del
                 item->removeChild(ci);
                 item->insertChild(i,ci);
                 assert(ci->parent()==item);
-                if(checkHidden)
+                if(checkHidden) {
                     updateItemsVisibility(ci,false);
+                    hiddenChanged = true;
+                }
             }
 
             // Check if the item just changed its policy of whether to remove
@@ -3412,8 +3452,10 @@ void DocumentItem::populateItem(DocumentObjectItem *item, bool refresh, bool del
             this->removeChild(childItem);
             item->insertChild(i,childItem);
             assert(childItem->parent()==item);
-            if(checkHidden)
+            if(checkHidden) {
                 updateItemsVisibility(childItem,false);
+                hiddenChanged = true;
+            }
         }
     }
 
@@ -3429,8 +3471,10 @@ void DocumentItem::populateItem(DocumentObjectItem *item, bool refresh, bool del
                 else
                     this->addChild(childItem);
                 assert(childItem->parent()==this);
-                if(checkHidden)
+                if(checkHidden) {
                     updateItemsVisibility(childItem,false);
+                    hiddenChanged = true;
+                }
                 childItem->myData->rootItem = childItem;
                 continue;
             }
@@ -3440,6 +3484,8 @@ void DocumentItem::populateItem(DocumentObjectItem *item, bool refresh, bool del
         delete ci;
         getTree()->blockConnection(lock);
     }
+    if(hiddenChanged)
+        getTree()->updateVisibleStatus();
     if(updated) 
         getTree()->_updateStatus();
 }
@@ -3885,19 +3931,33 @@ void DocumentItem::clearSelection(DocumentObjectItem *exclude)
 {
     // Block signals here otherwise we get a recursion and quadratic runtime
     bool ok = treeWidget()->blockSignals(true);
-    FOREACH_ITEM_ALL(item);
-        if(item==exclude) {
-            if(item->selected>0)
-                item->selected = -1;
-            else
-                item->selected = 0;
-            updateItemSelection(item);
-        }else{
-            item->selected = 0;
-            item->mySubs.clear();
-            item->setSelected(false);
-        }
-    END_FOREACH_ITEM;
+
+    // Only visit the selected items instead of all items of the document
+    for(auto ti : treeWidget()->selectedItems()) {
+        if(ti->type() != TreeWidget::ObjectType)
+            continue;
+        auto item = static_cast<DocumentObjectItem*>(ti);
+        if(item->myOwner == this)
+            SelectedItems.insert(item);
+    }
+    std::unordered_set<DocumentObjectItem*> items;
+    items.swap(SelectedItems);
+    for(auto item : items) {
+        if(item==exclude)
+            continue;
+        item->selected = 0;
+        item->mySubs.clear();
+        item->setSelected(false);
+    }
+    if(exclude && items.count(exclude)) {
+        if(exclude->selected>0)
+            exclude->selected = -1;
+        else
+            exclude->selected = 0;
+        updateItemSelection(exclude);
+        if(exclude->selected)
+            SelectedItems.insert(exclude);
+    }
     treeWidget()->blockSignals(ok);
 }
 
@@ -3930,6 +3990,8 @@ void DocumentItem::updateItemSelection(DocumentObjectItem *item) {
     if(item->selected != -1)
         item->mySubs.clear();
     item->selected = selected;
+    if(selected)
+        SelectedItems.insert(item);
 
     auto obj = item->object()->getObject();
     if(!obj || !obj->getNameInDocument())
@@ -4090,12 +4152,15 @@ DocumentObjectItem *DocumentItem::findItemByObject(
 DocumentObjectItem *DocumentItem::findItem(
         bool sync, DocumentObjectItem *item, const char *subname, bool select) 
 {
-    if(item->isHidden()) 
+    if(item->isHidden()) {
         item->setHidden(false);
+        getTree()->updateVisibleStatus();
+    }
 
     if(!subname || *subname==0) {
         if(select) {
             item->selected+=2;
+            SelectedItems.insert(item);
             item->mySubs.clear();
         }
         return item;
@@ -4111,6 +4176,7 @@ DocumentObjectItem *DocumentItem::findItem(
     else {
         if(select) {
             item->selected+=2;
+            SelectedItems.insert(item);
             if(std::find(item->mySubs.begin(),item->mySubs.end(),subname)==item->mySubs.end())
                 item->mySubs.push_back(subname);
         }
@@ -4125,6 +4191,7 @@ DocumentObjectItem *DocumentItem::findItem(
             TREE_WARN("sub object not found " << item->getName() << '.' << name.c_str());
         if(select) {
             item->selected += 2;
+            SelectedItems.insert(item);
             if(std::find(item->mySubs.begin(),item->mySubs.end(),subname)==item->mySubs.end())
                 item->mySubs.push_back(subname);
         }
@@ -4170,6 +4237,7 @@ DocumentObjectItem *DocumentItem::findItem(
         // Select the current object instead.
         TREE_TRACE("element " << subname << " not found");
         item->selected+=2;
+        SelectedItems.insert(item);
         if(std::find(item->mySubs.begin(),item->mySubs.end(),subname)==item->mySubs.end())
             item->mySubs.push_back(subname);
     }
@@ -4184,7 +4252,9 @@ void DocumentItem::selectItems(bool sync) {
     DocumentObjectItem *first = 0;
     DocumentObjectItem *last = 0;
 
-    FOREACH_ITEM_ALL(item)
+    std::unordered_set<DocumentObjectItem*> items;
+    items.swap(SelectedItems);
+    for(auto item : items) {
         if(item->selected == 1) {
             // this means it is the old selection and is not in the current
             // selection
@@ -4200,9 +4270,10 @@ void DocumentItem::selectItems(bool sync) {
             }
             item->selected = 1;
             item->setSelected(true);
+            SelectedItems.insert(item);
             last = item;
         }
-    END_FOREACH_ITEM;
+    }
 
     if(sync) {
         if(!first)
@@ -4284,6 +4355,7 @@ bool DocumentItem::showItem(DocumentObjectItem *item, bool select, bool force) {
         if(!force)
             return false;
         item->setHidden(false);
+        getTree()->updateVisibleStatus();
     }
     
     if(parent->type()==TreeWidget::ObjectType && 
@@ -4337,6 +4409,9 @@ DocumentObjectItem::~DocumentObjectItem()
     if(myData->rootItem == this)
         myData->rootItem = 0;
 
+    if(myOwner)
+        myOwner->SelectedItems.erase(this);
+
     if(myOwner && myData->items.empty()) {
         auto it = myOwner->_ParentMap.find(object()->getObject());
         if(it!=myOwner->_ParentMap.end() && it->second.size()) {
@@ -25,6 +25,7 @@
 #define GUI_TREE_H
 
 #include <unordered_map>
+#include <unordered_set>
 #include <QTreeWidget>
 #include <QTime>
 #include <QStyledItemDelegate>
@@ -145,6 +146,8 @@ protected:
     bool event(QEvent *e) override;
     void keyPressEvent(QKeyEvent *event) override;
     void mouseDoubleClickEvent(QMouseEvent * event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void resizeEvent(QResizeEvent *) override;
 
 protected:
     void showEvent(QShowEvent *) override;
@@ -201,6 +204,8 @@ private:
     void updateChildren(App::DocumentObject *obj, 
             const std::set<DocumentObjectDataPtr> &data, bool output, bool force);
 
+    void updateVisibleStatus();
+
 private:
     QAction* createGroupAction;
     QAction* relabelObjectAction;
@@ -340,6 +345,8 @@ private:
     std::unordered_map<App::DocumentObject*,DocumentObjectDataPtr> ObjectMap;
     std::unordered_map<App::DocumentObject*, std::set<App::DocumentObject*> > _ParentMap;
     std::vector<App::DocumentObject*> PopulateObjects;
+    // items that are (or are about to be) selected
+    std::unordered_set<DocumentObjectItem*> SelectedItems;
 
     ExpandInfoPtr _ExpandInfo;
     void restoreItemExpansion(const ExpandInfoPtr &, DocumentObjectItem *);
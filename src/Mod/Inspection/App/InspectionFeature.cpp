@@ -22,24 +22,39 @@
 
 
 #include "PreCompiled.h"
+#include <atomic>
+#include <cfloat>
+#include <climits>
+#include <memory>
+
 #include <gp_Pnt.hxx>
+#include <Bnd_Box.hxx>
+#include <BRep_Tool.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepExtrema_DistShapeShape.hxx>
 #include <BRepBuilderAPI_MakeVertex.hxx>
 #include <BRepClass3d_SolidClassifier.hxx>
 #include <BRepGProp_Face.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <Poly_Array1OfTriangle.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Standard_Version.hxx>
+#include <TColgp_Array1OfPnt.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopLoc_Location.hxx>
 #include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
 #include <TopoDS_Vertex.hxx>
 
-#include <QEventLoop>
 #include <QFuture>
-#include <QFutureWatcher>
+#include <QThread>
 #include <QtConcurrentMap>
 
 #include <boost/bind.hpp>
 
 #include <Base/Console.h>
 #include <Base/Exception.h>
-#include <Base/FutureWatcherProgress.h>
 #include <Base/Parameter.h>
 #include <Base/Sequencer.h>
 #include <Base/Tools.h>
@@ -59,10 +74,12 @@
 
 using namespace Inspection;
 
-InspectActualMesh::InspectActualMesh(const Mesh::MeshObject& rMesh) : _iter(rMesh.getKernel())
+InspectActualMesh::InspectActualMesh(const Mesh::MeshObject& rMesh)
+  : _rKernel(rMesh.getKernel())
+  , _clMat(rMesh.getTransform())
 {
-    this->_count = rMesh.countPoints();
-    this->_iter.Transform(rMesh.getTransform());
+    Base::Matrix4D tmp;
+    this->_bApply = (_clMat != tmp);
 }
 
 InspectActualMesh::~InspectActualMesh()
@@ -71,13 +88,15 @@ InspectActualMesh::~InspectActualMesh()
 
 unsigned long InspectActualMesh::countPoints() const
 {
-    return this->_count;
+    return _rKernel.CountPoints();
 }
 
 Base::Vector3f InspectActualMesh::getPoint(unsigned long index)
 {
-    _iter.Set(index);
-    return *_iter;
+    Base::Vector3f point = _rKernel.GetPoint(index);
+    if (_bApply)
+        point = _clMat * point;
+    return point;
 }
 
 // ----------------------------------------------------------------
@@ -124,6 +143,14 @@ Base::Vector3f InspectActualShape::getPoint(unsigned long index)
 
 // ----------------------------------------------------------------
 
+void InspectNominalGeometry::getDistances(const Base::Vector3f* points, unsigned long count, float* distances)
+{
+    for (unsigned long index = 0; index < count; index++)
+        distances[index] = getDistance(points[index]);
+}
+
+// ----------------------------------------------------------------
+
 namespace Inspection {
     class MeshInspectGrid : public MeshCore::MeshGrid
     {
@@ -295,14 +322,16 @@ float InspectNominalMesh::getDistance(const Base::Vector3f& point)
         indices.insert(indices.begin(), inds.begin(), inds.end());
     }
 
+    // use a local copy of the iterator to be thread-safe
+    MeshCore::MeshFacetIterator iter(_iter);
     float fMinDist=FLT_MAX;
     bool positive = true;
     for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
-        _iter.Set(*it);
-        float fDist = _iter->DistanceToPoint(point);
+        iter.Set(*it);
+        float fDist = iter->DistanceToPoint(point);
         if (fabs(fDist) < fabs(fMinDist)) {
             fMinDist = fDist;
-            positive = point.DistanceToPlane(_iter->_aclPoints[0], _iter->GetNormal()) > 0;
+            positive = point.DistanceToPlane(iter->_aclPoints[0], iter->GetNormal()) > 0;
         }
     }
 
@@ -368,14 +397,16 @@ float InspectNominalFastMesh::getDistance(const Base::Vector3f& point)
         _pGrid->GetHull(ulX, ulY, ulZ, ulLevel, indices);
 #endif
 
+    // use a local copy of the iterator to be thread-safe
+    MeshCore::MeshFacetIterator iter(_iter);
     float fMinDist=FLT_MAX;
     bool positive = true;
     for (std::set<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
-        _iter.Set(*it);
-        float fDist = _iter->DistanceToPoint(point);
+        iter.Set(*it);
+        float fDist = iter->DistanceToPoint(point);
         if (fabs(fDist) < fabs(fMinDist)) {
             fMinDist = fDist;
-            positive = point.DistanceToPlane(_iter->_aclPoints[0], _iter->GetNormal()) > 0;
+            positive = point.DistanceToPlane(iter->_aclPoints[0], iter->GetNormal()) > 0;
         }
     }
 
@@ -421,74 +452,245 @@ float InspectNominalPoints::getDistance(const Base::Vector3f& point)
 
 // ----------------------------------------------------------------
 
-InspectNominalShape::InspectNominalShape(const TopoDS_Shape& shape, float /*radius*/)
-    : _rShape(shape)
-    , isSolid(false)
+/* The tessellation of the nominal shape with a spatial grid, it is used to
+ * find the faces near a point. The exact distance is only calculated to these
+ * faces.
+ */
+struct InspectNominalShape::Tessellation
 {
-    distss = new BRepExtrema_DistShapeShape();
-    distss->LoadS1(_rShape);
-
-    // When having a solid then use its shell because otherwise the distance
-    // for inner points will always be zero
-    if (!_rShape.IsNull() && _rShape.ShapeType() == TopAbs_SOLID) {
-        TopExp_Explorer xp;
-        xp.Init(_rShape, TopAbs_SHELL);
-        if (xp.More()) {
-           distss->LoadS1(xp.Current());
-           isSolid = true;
-        }
-
+    std::vector<TopoDS_Face> faces;
+    std::vector<std::size_t> facetToFace;
+    std::vector<std::size_t> untessellated;
+    MeshCore::MeshKernel mesh;
+    MeshCore::MeshFacetGrid* grid;
+    float deflection;
+
+    Tessellation() : grid(0), deflection(0.0f)
+    {
     }
-    //distss->SetDeflection(radius);
-}
-
-InspectNominalShape::~InspectNominalShape()
-{
-    delete distss;
-}
+    ~Tessellation()
+    {
+        delete grid;
+    }
+};
 
-float InspectNominalShape::getDistance(const Base::Vector3f& point)
+/* Calculates the distances of the points of one batch. The OCC algorithms are
+ * expensive to set up and thus kept between the points, which is why an
+ * evaluator must only be used by one thread.
+ */
+class InspectNominalShape::Evaluator
 {
-    gp_Pnt pnt3d(point.x,point.y,point.z);
-    BRepBuilderAPI_MakeVertex mkVert(pnt3d);
-    distss->LoadS2(mkVert.Vertex());
+public:
+    Evaluator(const InspectNominalShape& nominal)
+        : nominal(nominal)
+        , tessellation(*nominal._pTessellation)
+    {
+        if (nominal.isSolid)
+            classifier.Load(nominal._rShape);
+    }
 
-    float fMinDist=FLT_MAX;
-    if (distss->Perform() && distss->NbSolution() > 0) {
-        fMinDist = (float)distss->Value();
-        // the shape is a solid, check if the vertex is inside
-        if (isSolid) {
-            const Standard_Real tol = 0.001;
-            BRepClass3d_SolidClassifier classifier(_rShape);
-            classifier.Perform(pnt3d, tol);
-            if (classifier.State() == TopAbs_IN) {
-                fMinDist = -fMinDist;
+    float getDistance(const Base::Vector3f& point)
+    {
+        gp_Pnt pnt3d(point.x,point.y,point.z);
+
+        // nearest triangle inside the search radius
+        float fMaxDist = nominal._radius + tessellation.deflection;
+        unsigned long facet = ULONG_MAX;
+        if (tessellation.grid)
+            facet = tessellation.grid->SearchNearestFromPoint(point, fMaxDist);
+        if (facet == ULONG_MAX && tessellation.untessellated.empty())
+            return isInside(pnt3d) ? -FLT_MAX : FLT_MAX;
+
+        // The tessellation deviates by up to the deflection from the faces,
+        // so the nearest face is one with a triangle not further away than
+        // the nearest triangle plus twice the deflection
+        std::set<std::size_t> faces(tessellation.untessellated.begin(), tessellation.untessellated.end());
+        float fMinDist = FLT_MAX;
+        bool positive = true;
+        if (facet != ULONG_MAX) {
+            MeshCore::MeshGeomFacet triangle = tessellation.mesh.GetFacet(facet);
+            fMinDist = triangle.DistanceToPoint(point);
+            positive = point.DistanceToPlane(triangle._aclPoints[0], triangle.GetNormal()) > 0;
+
+            float fLimit = fMinDist + 2.0f * tessellation.deflection + FLT_EPSILON;
+            Base::BoundBox3f box(point.x - fLimit, point.y - fLimit, point.z - fLimit,
+                                 point.x + fLimit, point.y + fLimit, point.z + fLimit);
+            std::vector<unsigned long> facets;
+            tessellation.grid->Inside(box, facets);
+            for (std::vector<unsigned long>::iterator it = facets.begin(); it != facets.end(); ++it) {
+                if (tessellation.mesh.GetFacet(*it).DistanceToPoint(point) <= fLimit)
+                    faces.insert(tessellation.facetToFace[*it]);
             }
+        }
 
+        // exact distance to the candidate faces
+        BRepBuilderAPI_MakeVertex mkVert(pnt3d);
+        BRepExtrema_DistShapeShape* nearest = 0;
+        Standard_Real minValue = DBL_MAX;
+        for (std::set<std::size_t>::iterator it = faces.begin(); it != faces.end(); ++it) {
+            BRepExtrema_DistShapeShape& distss = getFaceDistance(*it);
+            distss.LoadS2(mkVert.Vertex());
+            if (distss.Perform() && distss.NbSolution() > 0 && distss.Value() < minValue) {
+                minValue = distss.Value();
+                nearest = &distss;
+            }
         }
-        else if (fMinDist > 0) {
-            // check if the distance was compued from a face
-            for (Standard_Integer index = 1; index <= distss->NbSolution(); index++) {
-                if (distss->SupportTypeShape1(index) == BRepExtrema_IsInFace) {
-                    TopoDS_Shape face = distss->SupportOnShape1(index);
+
+        // keep the approximated distance if the exact one failed
+        if (!nearest)
+            return positive ? fMinDist : -fMinDist;
+
+        fMinDist = (float)minValue;
+        if (fMinDist > 0) {
+            // check if the distance was computed from a face
+            for (Standard_Integer index = 1; index <= nearest->NbSolution(); index++) {
+                if (nearest->SupportTypeShape1(index) == BRepExtrema_IsInFace) {
+                    TopoDS_Shape face = nearest->SupportOnShape1(index);
                     Standard_Real u, v;
-                    distss->ParOnFaceS1(index, u, v);
-                    //gp_Pnt pnt = distss->PointOnShape1(index);
+                    nearest->ParOnFaceS1(index, u, v);
                     BRepGProp_Face props(TopoDS::Face(face));
                     gp_Vec normal;
                     gp_Pnt center;
                     props.Normal(u, v, center, normal);
                     gp_Vec dir(center, pnt3d);
                     Standard_Real scalar = normal.Dot(dir);
-                    if (scalar < 0) {
-                        fMinDist = -fMinDist;
-                    }
-                    break;
+                    return scalar < 0 ? -fMinDist : fMinDist;
                 }
             }
+
+            // the nearest point is on an edge or vertex of a solid
+            if (isInside(pnt3d))
+                fMinDist = -fMinDist;
         }
+
+        return fMinDist;
     }
-    return fMinDist;
+
+private:
+    bool isInside(const gp_Pnt& pnt3d)
+    {
+        if (!nominal.isSolid)
+            return false;
+        const Standard_Real tol = 0.001;
+        classifier.Perform(pnt3d, tol);
+        return classifier.State() == TopAbs_IN;
+    }
+
+    BRepExtrema_DistShapeShape& getFaceDistance(std::size_t index)
+    {
+        std::unique_ptr<BRepExtrema_DistShapeShape>& distss = faceDistances[index];
+        if (!distss) {
+            distss.reset(new BRepExtrema_DistShapeShape());
+            distss->LoadS1(tessellation.faces[index]);
+        }
+        return *distss;
+    }
+
+private:
+    const InspectNominalShape& nominal;
+    const Tessellation& tessellation;
+    BRepClass3d_SolidClassifier classifier;
+    std::map<std::size_t, std::unique_ptr<BRepExtrema_DistShapeShape> > faceDistances;
+};
+
+InspectNominalShape::InspectNominalShape(const TopoDS_Shape& shape, float radius)
+    : _rShape(shape)
+    , _pTessellation(new Tessellation)
+    , _radius(radius)
+    , isSolid(false)
+{
+    if (_rShape.IsNull())
+        return;
+
+    // When having a solid the sign of points near an edge is checked with a
+    // classifier because otherwise the distance for inner points would be
+    // positive
+    if (_rShape.ShapeType() == TopAbs_SOLID) {
+        TopExp_Explorer xp;
+        xp.Init(_rShape, TopAbs_SHELL);
+        isSolid = xp.More();
+    }
+
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part");
+    float deviation = hGrp->GetFloat("MeshDeviation",0.2);
+
+    Bnd_Box bounds;
+    BRepBndLib::Add(_rShape, bounds);
+    bounds.SetGap(0.0);
+    Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+    bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    Standard_Real deflection = ((xMax-xMin) + (yMax-yMin) + (zMax-zMin))/300.0 * deviation;
+    // Mesh a copy, because BRepMesh_IncrementalMesh stores the triangulation
+    // in the faces, which are shared with the shape of the document
+    TopoDS_Shape copy = BRepBuilderAPI_Copy(_rShape).Shape();
+    BRepMesh_IncrementalMesh(copy, deflection);
+    _pTessellation->deflection = (float)deflection;
+
+    MeshCore::MeshPointArray points;
+    MeshCore::MeshFacetArray facets;
+    for (TopExp_Explorer xp(copy, TopAbs_FACE); xp.More(); xp.Next()) {
+        TopoDS_Face face = TopoDS::Face(xp.Current());
+        std::size_t index = _pTessellation->faces.size();
+        _pTessellation->faces.push_back(face);
+
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, loc);
+        if (triangulation.IsNull()) {
+            _pTessellation->untessellated.push_back(index);
+            continue;
+        }
+
+        unsigned long offset = points.size();
+        const TColgp_Array1OfPnt& nodes = triangulation->Nodes();
+        for (int i = 1; i <= nodes.Length(); i++) {
+            gp_Pnt p = nodes(i);
+            p.Transform(loc.Transformation());
+            points.push_back(MeshCore::MeshPoint(Base::Vector3f((float)p.X(),(float)p.Y(),(float)p.Z())));
+        }
+
+        bool flip = (face.Orientation() == TopAbs_REVERSED);
+        const Poly_Array1OfTriangle& triangles = triangulation->Triangles();
+        for (int i = 1; i <= triangles.Length(); i++) {
+            Standard_Integer n1, n2, n3;
+            triangles(i).Get(n1, n2, n3);
+            if (flip)
+                std::swap(n1, n2);
+            facets.push_back(MeshCore::MeshFacet(offset+n1-1, offset+n2-1, offset+n3-1));
+            _pTessellation->facetToFace.push_back(index);
+        }
+    }
+
+    if (facets.empty())
+        return;
+    _pTessellation->mesh.Adopt(points, facets);
+
+    // same grid size as for nominal meshes
+    const MeshCore::MeshKernel& kernel = _pTessellation->mesh;
+    float fMaxGridElements=8000000.0f;
+    Base::BoundBox3f box = kernel.GetBoundBox();
+    float fMinGridLen = (float)pow((box.LengthX()*box.LengthY()*box.LengthZ()/fMaxGridElements), 0.3333f);
+    float fGridLen = 5.0f * MeshCore::MeshAlgorithm(kernel).GetAverageEdgeLength();
+    fGridLen = std::max<float>(fMinGridLen, fGridLen);
+    _pTessellation->grid = new MeshCore::MeshFacetGrid(kernel, fGridLen);
+}
+
+InspectNominalShape::~InspectNominalShape()
+{
+    delete _pTessellation;
+}
+
+float InspectNominalShape::getDistance(const Base::Vector3f& point)
+{
+    Evaluator evaluator(*this);
+    return evaluator.getDistance(point);
+}
+
+void InspectNominalShape::getDistances(const Base::Vector3f* points, unsigned long count, float* distances)
+{
+    Evaluator evaluator(*this);
+    for (unsigned long index = 0; index < count; index++)
+        distances[index] = evaluator.getDistance(points[index]);
 }
 
 // ----------------------------------------------------------------
@@ -641,34 +843,56 @@ unsigned int PropertyDistanceList::getMemSize (void) const
 // helper class to use Qt's concurrent framework
 struct DistanceInspection
 {
+    // number of points inspected by one job
+    static const unsigned long BatchSize = 1024;
 
     DistanceInspection(float radius, InspectActualGeometry*  a,
-                       std::vector<InspectNominalGeometry*> n)
-                    : radius(radius), actual(a), nominal(n)
+                       std::vector<InspectNominalGeometry*> n,
+                       std::vector<float>& v)
+                    : radius(radius), actual(a), nominal(n), vals(v)
+                    , stop(false), done(0)
     {
     }
-    float mapped(unsigned long index)
+    void inspect(unsigned long batch)
     {
-        Base::Vector3f pnt = actual->getPoint(index);
-
-        float fMinDist=FLT_MAX;
+        if (stop)
+            return;
+
+        unsigned long begin = batch * BatchSize;
+        unsigned long count = vals.size() - begin;
+        if (count > BatchSize)
+            count = BatchSize;
+        std::vector<Base::Vector3f> pnts(count);
+        for (unsigned long index = 0; index < count; index++)
+            pnts[index] = actual->getPoint(begin + index);
+
+        float* minDist = &vals[begin];
+        std::fill(minDist, minDist + count, FLT_MAX);
+        std::vector<float> dist(count);
         for (std::vector<InspectNominalGeometry*>::iterator it = nominal.begin(); it != nominal.end(); ++it) {
-            float fDist = (*it)->getDistance(pnt);
-            if (fabs(fDist) < fabs(fMinDist))
-                fMinDist = fDist;
+            (*it)->getDistances(&pnts[0], count, &dist[0]);
+            for (unsigned long index = 0; index < count; index++) {
+                if (fabs(dist[index]) < fabs(minDist[index]))
+                    minDist[index] = dist[index];
+            }
         }
 
-        if (fMinDist > this->radius)
-            fMinDist = FLT_MAX;
-        else if (-fMinDist > this->radius)
-            fMinDist = -FLT_MAX;
+        for (unsigned long index = 0; index < count; index++) {
+            if (minDist[index] > this->radius)
+                minDist[index] = FLT_MAX;
+            else if (-minDist[index] > this->radius)
+                minDist[index] = -FLT_MAX;
+        }
 
-        return fMinDist;
+        ++done;
     }
 
     float radius;
     InspectActualGeometry*  actual;
     std::vector<InspectNominalGeometry*> nominal;
+    std::vector<float>& vals;
+    std::atomic<bool> stop;
+    std::atomic<unsigned long> done;
 };
 
 PROPERTY_SOURCE(Inspection::Feature, App::DocumentObject)
@@ -705,24 +929,25 @@ App::DocumentObjectExecReturn* Feature::execute(void)
     if (!pcActual)
         throw Base::ValueError("No actual geometry to inspect specified");
 
-    InspectActualGeometry* actual = 0;
+    std::unique_ptr<InspectActualGeometry> actual;
     if (pcActual->getTypeId().isDerivedFrom(Mesh::Feature::getClassTypeId())) {
         Mesh::Feature* mesh = static_cast<Mesh::Feature*>(pcActual);
-        actual = new InspectActualMesh(mesh->Mesh.getValue());
+        actual.reset(new InspectActualMesh(mesh->Mesh.getValue()));
     }
     else if (pcActual->getTypeId().isDerivedFrom(Points::Feature::getClassTypeId())) {
         Points::Feature* pts = static_cast<Points::Feature*>(pcActual);
-        actual = new InspectActualPoints(pts->Points.getValue());
+        actual.reset(new InspectActualPoints(pts->Points.getValue()));
     }
     else if (pcActual->getTypeId().isDerivedFrom(Part::Feature::getClassTypeId())) {
         Part::Feature* part = static_cast<Part::Feature*>(pcActual);
-        actual = new InspectActualShape(part->Shape.getShape());
+        actual.reset(new InspectActualShape(part->Shape.getShape()));
     }
     else {
         throw Base::TypeError("Unknown geometric type");
     }
 
     // get a list of nominals
+    std::vector<std::unique_ptr<InspectNominalGeometry> > nominalGeometries;
     std::vector<InspectNominalGeometry*> inspectNominal;
     const std::vector<App::DocumentObject*>& nominals = Nominals.getValues();
     for (std::vector<App::DocumentObject*>::const_iterator it = nominals.begin(); it != nominals.end(); ++it) {
@@ -740,57 +965,61 @@ App::DocumentObjectExecReturn* Feature::execute(void)
             nominal = new InspectNominalShape(part->Shape.getValue(), this->SearchRadius.getValue());
         }
 
-        if (nominal)
+        if (nominal) {
+            nominalGeometries.emplace_back(nominal);
             inspectNominal.push_back(nominal);
+        }
     }
 
-#if 0 // test with some huge data sets
-    Standard::SetReentrant(Standard_True);
-    std::vector<unsigned long> index(actual->countPoints());
-    std::generate(index.begin(), index.end(), Base::iotaGen<unsigned long>(0));
-    DistanceInspection check(this->SearchRadius.getValue(), actual, inspectNominal);
-    QFuture<float> future = QtConcurrent::mapped
-        (index, boost::bind(&DistanceInspection::mapped, &check, _1));
-    //future.waitForFinished(); // blocks the GUI
-    Base::FutureWatcherProgress progress("Inspecting...", actual->countPoints());
-    QFutureWatcher<float> watcher;
-    QObject::connect(&watcher, SIGNAL(progressValueChanged(int)),
-                     &progress, SLOT(progressValueChanged(int)));
-    watcher.setFuture(future);
-
-    // keep it responsive during computation
-    QEventLoop loop;
-    QObject::connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
-    loop.exec();
-
-    std::vector<float> vals;
-    vals.insert(vals.end(), future.begin(), future.end());
-#else
     unsigned long count = actual->countPoints();
     std::stringstream str;
     str << "Inspecting " << this->Label.getValue() << "...";
-    Base::SequencerLauncher seq(str.str().c_str(), count);
 
+    // The points are inspected in batches, so that nominal geometries can
+    // keep expensive state between the points of a batch
     std::vector<float> vals(count);
-    for (unsigned long index = 0; index < count; index++) {
-        Base::Vector3f pnt = actual->getPoint(index);
-
-        float fMinDist=FLT_MAX;
-        for (std::vector<InspectNominalGeometry*>::iterator it = inspectNominal.begin(); it != inspectNominal.end(); ++it) {
-            float fDist = (*it)->getDistance(pnt);
-            if (fabs(fDist) < fabs(fMinDist))
-                fMinDist = fDist;
-        }
-
-        if (fMinDist > this->SearchRadius.getValue())
-            fMinDist = FLT_MAX;
-        else if (-fMinDist > this->SearchRadius.getValue())
-            fMinDist = -FLT_MAX;
-        vals[index] = fMinDist;
-        seq.next();
+    DistanceInspection check(this->SearchRadius.getValue(), actual.get(), inspectNominal, vals);
+    std::vector<unsigned long> batches((count + DistanceInspection::BatchSize - 1) / DistanceInspection::BatchSize);
+    std::generate(batches.begin(), batches.end(), Base::iotaGen<unsigned long>(0));
+    Base::SequencerLauncher seq(str.str().c_str(), batches.size());
+
+    int threads = QThread::idealThreadCount();
+#if OCC_VERSION_HEX < 0x070000
+    // the geometry caches of older OCC versions are not thread-safe
+    for (std::vector<App::DocumentObject*>::const_iterator it = nominals.begin(); it != nominals.end(); ++it) {
+        if ((*it)->getTypeId().isDerivedFrom(Part::Feature::getClassTypeId()))
+            threads = 1;
     }
 #endif
 
+    if (threads < 2 || batches.size() < 2) {
+        for (std::vector<unsigned long>::iterator it = batches.begin(); it != batches.end(); ++it) {
+            check.inspect(*it);
+            seq.next(true);
+        }
+    }
+    else {
+        // The sequencer must only be used by the calling thread, so it polls the
+        // number of finished batches while the workers run
+        QFuture<void> future = QtConcurrent::map
+            (batches, boost::bind(&DistanceInspection::inspect, &check, _1));
+        unsigned long reported = 0;
+        try {
+            while (!future.isFinished()) {
+                for (unsigned long done = check.done; reported < done; reported++)
+                    seq.next(true);
+                QThread::msleep(10);
+            }
+        }
+        catch (...) {
+            check.stop = true;
+            future.cancel();
+            future.waitForFinished();
+            throw;
+        }
+        future.waitForFinished();
+    }
+
     Distances.setValues(vals);
 
     float fRMS = 0;
@@ -810,10 +1039,6 @@ App::DocumentObjectExecReturn* Feature::execute(void)
     Base::Console().Message("RMS value for '%s' with search radius=%.4f is: %.4f\n",
         this->Label.getValue(), this->SearchRadius.getValue(), fRMS);
 
-    delete actual;
-    for (std::vector<InspectNominalGeometry*>::iterator it = inspectNominal.begin(); it != inspectNominal.end(); ++it)
-        delete *it;
-
     return 0;
 }
 
@@ -32,7 +32,6 @@
 #include <Mod/Points/App/Points.h>
 
 class TopoDS_Shape;
-class BRepExtrema_DistShapeShape;
 
 namespace MeshCore {
 class MeshKernel;
@@ -46,7 +45,9 @@ namespace Part   { class TopoShape;  }
 namespace Inspection
 {
 
-/** Delivers the number of points to be checked and returns the appropriate point to an index. */
+/** Delivers the number of points to be checked and returns the appropriate point to an index.
+ * getPoint() is called from several threads at the same time and thus must not modify the object.
+ */
 class InspectionExport InspectActualGeometry
 {
 public:
@@ -66,8 +67,9 @@ public:
     virtual Base::Vector3f getPoint(unsigned long);
 
 private:
-    MeshCore::MeshPointIterator _iter;
-    unsigned long _count;
+    const MeshCore::MeshKernel& _rKernel;
+    Base::Matrix4D _clMat;
+    bool _bApply;
 };
 
 class InspectionExport InspectActualPoints : public InspectActualGeometry
@@ -93,13 +95,18 @@ private:
     std::vector<Base::Vector3d> points;
 };
 
-/** Calculates the shortest distance of the underlying geometry to a given point. */
+/** Calculates the shortest distance of the underlying geometry to a given point.
+ * The distances are calculated from several threads at the same time and thus
+ * getDistance() and getDistances() must not modify the object.
+ */
 class InspectionExport InspectNominalGeometry
 {
 public:
     InspectNominalGeometry() {}
     virtual ~InspectNominalGeometry() {}
     virtual float getDistance(const Base::Vector3f&) = 0;
+    /// Calculates the distances of \a count points at once
+    virtual void getDistances(const Base::Vector3f* points, unsigned long count, float* distances);
 };
 
 class InspectionExport InspectNominalMesh : public InspectNominalGeometry
@@ -147,10 +154,14 @@ public:
     InspectNominalShape(const TopoDS_Shape&, float offset);
     ~InspectNominalShape();
     virtual float getDistance(const Base::Vector3f&);
+    virtual void getDistances(const Base::Vector3f* points, unsigned long count, float* distances);
 
 private:
-    BRepExtrema_DistShapeShape* distss;
+    class Evaluator;
+    struct Tessellation;
     const TopoDS_Shape& _rShape;
+    Tessellation* _pTessellation;
+    float _radius;
     bool isSolid;
 };
 
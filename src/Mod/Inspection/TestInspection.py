@@ -0,0 +1,59 @@
+#**************************************************************************
+#   Copyright (c) 2026 FreeCAD Developers                                 *
+#                                                                         *
+#   This file is part of the FreeCAD CAx development system.              *
+#                                                                         *
+#   This program is free software; you can redistribute it and/or modify  *
+#   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#   as published by the Free Software Foundation; either version 2 of     *
+#   the License, or (at your option) any later version.                   *
+#   for detail see the LICENCE text file.                                 *
+#                                                                         *
+#   FreeCAD is distributed in the hope that it will be useful,            *
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#   GNU Library General Public License for more details.                  *
+#                                                                         *
+#   You should have received a copy of the GNU Library General Public     *
+#   License along with FreeCAD; if not, write to the Free Software        *
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#   USA                                                                   *
+#**************************************************************************
+
+import FreeCAD, unittest, Part, Points
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FreeCAD Inspection module
+#---------------------------------------------------------------------------
+
+
+class InspectionTestCases(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("InspectionTest")
+
+    def testNominalShapeUnchanged(self):
+        # The shape nominal is tessellated for the inspection. This must not
+        # add a triangulation to the shape of the document.
+        numCoarse = len(Part.makeCylinder(1, 2).tessellate(1.0)[1])
+        cyl = self.Doc.addObject("Part::Feature", "Cylinder")
+        cyl.Shape = Part.makeCylinder(1, 2)
+
+        pts = Points.Points()
+        pts.addPoints([FreeCAD.Vector(1, 0, 1), FreeCAD.Vector(0, 0, 3)])
+        actual = self.Doc.addObject("Points::Feature", "Points")
+        actual.Points = pts
+
+        insp = self.Doc.addObject("Inspection::Feature", "Inspection")
+        insp.Actual = actual
+        insp.Nominals = [cyl]
+        insp.SearchRadius = 2.0
+        self.Doc.recompute()
+
+        dist = insp.Distances
+        self.assertEqual(len(dist), 2)
+        self.assertAlmostEqual(dist[0], 0.0, 3)
+        self.assertAlmostEqual(abs(dist[1]), 1.0, 3)
+        self.assertEqual(len(cyl.Shape.tessellate(1.0)[1]), numCoarse)
+
+    def tearDown(self):
+        FreeCAD.closeDocument("InspectionTest")
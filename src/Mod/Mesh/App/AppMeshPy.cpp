@@ -38,6 +38,7 @@
 #include <App/DocumentObjectPy.h>
 #include <App/Property.h>
 #include <Base/PlacementPy.h>
+#include <Base/MatrixPy.h>
 
 #include <Base/GeometryPyCXX.h>
 #include <Base/VectorPy.h>
@@ -84,6 +85,14 @@ public:
             "exportAmfCompressed specifies whether exported AMF files should be\n"
             "compressed.\n"
         );
+        add_varargs_method("convert",&Module::convert,
+            "convert(source, target, [Matrix, cellSize=0.0]) -> int\n"
+            "Converts an STL file into a binary STL, ASCII STL (.ast) or OBJ file\n"
+            "chunk by chunk without loading the whole mesh into memory.\n"
+            "The facets are transformed with the optional matrix and, if cellSize\n"
+            "is positive, decimated by clustering the points into a grid of that\n"
+            "cell size. Returns the number of written facets.\n"
+        );
         add_varargs_method("show",&Module::show,
             "show(shape,[string]) -- Add the mesh to the active document or create one if no document exists."
         );
@@ -378,6 +387,27 @@ private:
         return Py::None();
     }
 
+    Py::Object convert(const Py::Tuple& args)
+    {
+        char* Source;
+        char* Target;
+        PyObject* pyMat = 0;
+        float cellSize = 0.0f;
+        if (!PyArg_ParseTuple(args.ptr(), "etet|O!f", "utf-8", &Source, "utf-8", &Target,
+                              &(Base::MatrixPy::Type), &pyMat, &cellSize))
+            throw Py::Exception();
+
+        std::string EncodedSource = std::string(Source);
+        PyMem_Free(Source);
+        std::string EncodedTarget = std::string(Target);
+        PyMem_Free(Target);
+
+        Base::Matrix4D mat;
+        if (pyMat)
+            mat = static_cast<Base::MatrixPy*>(pyMat)->value();
+        unsigned long count = MeshObject::convert(EncodedSource.c_str(), EncodedTarget.c_str(), mat, cellSize);
+        return Py::Long(count);
+    }
     Py::Object show(const Py::Tuple& args)
     {
         PyObject *pcObj;
@@ -350,6 +350,7 @@ void MeshFastBuilder::Finish ()
         rFacets[i]._aulPoints[2] = indices[3*i + 2];
     }
 
+    indices = QVector<unsigned long>();
     verts.resize(vertex_count);
 
     MeshPointArray rPoints;
@@ -358,5 +359,7 @@ void MeshFastBuilder::Finish ()
         rPoints.push_back(MeshPoint(v->x, v->y, v->z));
     }
 
+    // release the vertices before the neighbourhood gets built to reduce the peak memory
+    verts = QVector<Private::Vertex>();
     _meshKernel.Adopt(rPoints, rFacets, true);
 }
@@ -23,11 +23,18 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
+# include <climits>
+# include <cmath>
 #endif
 
+#include <QtConcurrentMap>
+#include <QThread>
+
 #include "Decimation.h"
 #include "MeshKernel.h"
 #include "Algorithm.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "TopoAlgorithm.h"
 #include <Base/Tools.h>
@@ -36,8 +43,78 @@
 
 using namespace MeshCore;
 
+namespace MeshCore {
+namespace Decimation {
+
+/// Minimum number of facets of a slab so that a split pays off
+static const unsigned long MinFacetsPerPart = 50000;
+
+struct Part
+{
+    std::vector<unsigned long> facets; // global facet indices
+    int target;
+    // result
+    std::vector<unsigned long> globals; // local to global point index
+    Simplify alg;
+};
+
+class PartDecimator
+{
+public:
+    typedef void result_type;
+
+    PartDecimator(const MeshKernel& kernel, const std::vector<char>& locked, double tolerance)
+      : kernel(kernel), locked(locked), tolerance(tolerance)
+    {
+    }
+
+    void operator()(Part& part) const
+    {
+        const MeshPointArray& points = kernel.GetPoints();
+        const MeshFacetArray& facets = kernel.GetFacets();
+
+        std::vector<unsigned long>& globals = part.globals;
+        globals.reserve(part.facets.size());
+        for (std::vector<unsigned long>::const_iterator it = part.facets.begin(); it != part.facets.end(); ++it) {
+            for (int i = 0; i < 3; i++)
+                globals.push_back(facets[*it]._aulPoints[i]);
+        }
+        std::sort(globals.begin(), globals.end());
+        globals.erase(std::unique(globals.begin(), globals.end()), globals.end());
+
+        Simplify& alg = part.alg;
+        alg.vertices.resize(globals.size());
+        for (std::size_t i = 0; i < globals.size(); i++) {
+            Simplify::Vertex& v = alg.vertices[i];
+            v.p = points[globals[i]];
+            v.locked = locked[globals[i]];
+            v.origin = static_cast<int>(i);
+        }
+
+        alg.triangles.resize(part.facets.size());
+        for (std::size_t i = 0; i < part.facets.size(); i++) {
+            const MeshFacet& face = facets[part.facets[i]];
+            for (int j = 0; j < 3; j++) {
+                alg.triangles[i].v[j] = static_cast<int>(std::lower_bound(globals.begin(), globals.end(),
+                                                                          face._aulPoints[j]) - globals.begin());
+            }
+        }
+
+        std::vector<unsigned long>().swap(part.facets);
+        alg.simplify_mesh(part.target, tolerance);
+    }
+
+private:
+    const MeshKernel& kernel;
+    const std::vector<char>& locked;
+    double tolerance;
+};
+
+} // namespace Decimation
+} // namespace MeshCore
+
 MeshSimplify::MeshSimplify(MeshKernel& mesh)
-  : myKernel(mesh)
+  : myKernel(mesh), myFeatureAngle(0.0f), myParts(0)
 {
 }
 
@@ -45,52 +122,212 @@ MeshSimplify::~MeshSimplify()
 {
 }
 
+void MeshSimplify::setFeatureAngle(float angle)
+{
+    myFeatureAngle = angle;
+}
+
+void MeshSimplify::setParts(int parts)
+{
+    myParts = parts;
+}
+
 void MeshSimplify::simplify(float tolerance, float reduction)
 {
-    Simplify alg;
+    unsigned long numFacets = myKernel.CountFacets();
+    unsigned long targetSize = static_cast<unsigned long>(static_cast<float>(numFacets) * (1.0f-reduction));
+    simplifyToSize(static_cast<int>(targetSize), tolerance);
+}
 
-    const MeshPointArray& points = myKernel.GetPoints();
-    for (std::size_t i = 0; i < points.size(); i++) {
-        Simplify::Vertex v;
-        v.p = points[i];
-        alg.vertices.push_back(v);
+void MeshSimplify::simplifyToSize(int targetSize, float tolerance)
+{
+    unsigned long numFacets = myKernel.CountFacets();
+    if (targetSize < 0 || static_cast<unsigned long>(targetSize) >= numFacets)
+        return;
+
+    int numParts = myParts;
+    if (numParts <= 0) {
+        int threads = std::max(1, QThread::idealThreadCount());
+        numParts = static_cast<int>(std::min<unsigned long>(threads, numFacets / Decimation::MinFacetsPerPart));
     }
+    // every slab must keep some facets
+    numParts = static_cast<int>(std::min<unsigned long>(numParts, numFacets / 4));
+    numParts = std::max(1, numParts);
 
+    // With one part this is the plain single-threaded algorithm. Otherwise the
+    // first pass keeps the points on the borders of the slabs and the second
+    // pass with shifted slabs decimates these bands.
+    simplifyParts(static_cast<unsigned long>(targetSize), numParts, tolerance);
+    if (numParts > 1 && myKernel.CountFacets() > static_cast<unsigned long>(targetSize))
+        simplifyParts(static_cast<unsigned long>(targetSize), -numParts, tolerance);
+}
+
+std::vector<char> MeshSimplify::lockedPoints() const
+{
+    std::vector<char> locked(myKernel.CountPoints(), 0);
+    if (myFeatureAngle <= 0.0f)
+        return locked;
+
+    const MeshPointArray& points = myKernel.GetPoints();
     const MeshFacetArray& facets = myKernel.GetFacets();
+    std::vector<Base::Vector3f> normals;
+    normals.reserve(facets.size());
+    for (MeshFacetArray::_TConstIterator it = facets.begin(); it != facets.end(); ++it) {
+        const Base::Vector3f& p0 = points[it->_aulPoints[0]];
+        Base::Vector3f normal = (points[it->_aulPoints[1]] - p0) % (points[it->_aulPoints[2]] - p0);
+        normal.Normalize();
+        normals.push_back(normal);
+    }
+
     for (std::size_t i = 0; i < facets.size(); i++) {
-        Simplify::Triangle t;
-        for (int j = 0; j < 3; j++)
-            t.v[j] = facets[i]._aulPoints[j];
-        alg.triangles.push_back(t);
+        const MeshFacet& face = facets[i];
+        for (int j = 0; j < 3; j++) {
+            unsigned long n = face._aulNeighbours[j];
+            if (n == ULONG_MAX || n < i)
+                continue;
+            if (normals[i].GetAngle(normals[n]) > myFeatureAngle) {
+                locked[face._aulPoints[j]] = 1;
+                locked[face._aulPoints[(j+1)%3]] = 1;
+            }
+        }
     }
 
-    int target_count = static_cast<int>(static_cast<float>(facets.size()) * (1.0f-reduction));
+    return locked;
+}
+
+/*!
+  Decimates the mesh with \a numParts slabs. A negative number means that the
+  slabs are shifted by half of their size.
+ */
+void MeshSimplify::simplifyParts(unsigned long targetSize, int numParts, double tolerance)
+{
+    const MeshPointArray& points = myKernel.GetPoints();
+    const MeshFacetArray& facets = myKernel.GetFacets();
+    unsigned long numFacets = facets.size();
+    bool shifted = numParts < 0;
+    numParts = std::abs(numParts);
 
-    // Simplification starts
-    alg.simplify_mesh(target_count, tolerance);
+    std::vector<char> locked = lockedPoints();
+    std::vector<Decimation::Part> parts(shifted ? numParts + 1 : numParts);
 
-    // Simplification done
-    MeshPointArray new_points;
-    new_points.reserve(alg.vertices.size());
-    for (std::size_t i = 0; i < alg.vertices.size(); i++) {
-        new_points.push_back(alg.vertices[i].p);
+    if (parts.size() == 1) {
+        parts[0].facets.resize(numFacets);
+        std::generate(parts[0].facets.begin(), parts[0].facets.end(), Base::iotaGen<unsigned long>(0));
     }
+    else {
+        // sort the facets along the longest axis and cut the sequence into slabs of equal size
+        const Base::BoundBox3f& bbox = myKernel.GetBoundBox();
+        int axis = 0;
+        if (bbox.LengthY() > bbox.LengthX())
+            axis = 1;
+        if (bbox.LengthZ() > (axis == 0 ? bbox.LengthX() : bbox.LengthY()))
+            axis = 2;
+
+        std::vector<float> centers(numFacets);
+        for (unsigned long i = 0; i < numFacets; i++) {
+            const MeshFacet& face = facets[i];
+            centers[i] = points[face._aulPoints[0]][axis] +
+                         points[face._aulPoints[1]][axis] +
+                         points[face._aulPoints[2]][axis];
+        }
 
-    std::size_t numFacets = 0;
-    for (std::size_t i = 0; i < alg.triangles.size(); i++) {
-        if (!alg.triangles[i].deleted)
-            numFacets++;
+        std::vector<unsigned long> order(numFacets);
+        std::generate(order.begin(), order.end(), Base::iotaGen<unsigned long>(0));
+        int threads = std::max(1, QThread::idealThreadCount());
+        MeshCore::parallel_sort(order.begin(), order.end(), [&centers](unsigned long a, unsigned long b) {
+            return centers[a] < centers[b];
+        }, threads);
+        std::vector<float>().swap(centers);
+
+        // the shifted slabs start with a half slab
+        std::vector<unsigned long> bounds;
+        bounds.push_back(0);
+        for (int i = 1; i < numParts; i++)
+            bounds.push_back((numFacets * i) / numParts);
+        if (shifted) {
+            for (std::size_t i = 1; i < bounds.size(); i++)
+                bounds[i] -= numFacets / (2 * numParts);
+            bounds.push_back(numFacets - numFacets / (2 * numParts));
+        }
+        bounds.push_back(numFacets);
+
+        for (std::size_t i = 0; i < parts.size(); i++)
+            parts[i].facets.assign(order.begin() + bounds[i], order.begin() + bounds[i+1]);
+
+        // the points used by several slabs must not be moved
+        std::vector<int> owner(points.size(), -1);
+        for (std::size_t i = 0; i < parts.size(); i++) {
+            for (std::vector<unsigned long>::iterator it = parts[i].facets.begin(); it != parts[i].facets.end(); ++it) {
+                for (int j = 0; j < 3; j++) {
+                    unsigned long p = facets[*it]._aulPoints[j];
+                    if (owner[p] < 0)
+                        owner[p] = static_cast<int>(i);
+                    else if (owner[p] != static_cast<int>(i))
+                        locked[p] = 1;
+                }
+            }
+        }
+    }
+
+    // every slab contributes its share of the reduction
+    for (std::vector<Decimation::Part>::iterator it = parts.begin(); it != parts.end(); ++it) {
+        unsigned long size = it->facets.size();
+        double share = static_cast<double>(numFacets - targetSize) * static_cast<double>(size) / static_cast<double>(numFacets);
+        it->target = static_cast<int>(size - static_cast<unsigned long>(share));
     }
+
+    Decimation::PartDecimator decimator(myKernel, locked, tolerance);
+    if (parts.size() == 1)
+        decimator(parts.front());
+    else
+        QtConcurrent::blockingMap(parts, decimator);
+
+    // Merge the slabs. Locked points keep their global index to connect the
+    // slabs, all other points are owned by exactly one slab.
+    std::size_t numPoints = 0, numTria = 0;
+    for (std::vector<Decimation::Part>::iterator it = parts.begin(); it != parts.end(); ++it) {
+        numPoints += it->alg.vertices.size();
+        numTria += it->alg.triangles.size();
+    }
+
+    std::vector<unsigned long> lockedIndex(points.size(), ULONG_MAX);
+    MeshPointArray new_points;
+    new_points.reserve(numPoints);
     MeshFacetArray new_facets;
-    new_facets.reserve(numFacets);
-    for (std::size_t i = 0; i < alg.triangles.size(); i++) {
-        if (!alg.triangles[i].deleted) {
+    new_facets.reserve(numTria);
+    std::vector<unsigned long> localIndex;
+    for (std::vector<Decimation::Part>::iterator it = parts.begin(); it != parts.end(); ++it) {
+        Simplify& alg = it->alg;
+        localIndex.resize(alg.vertices.size());
+        for (std::size_t i = 0; i < alg.vertices.size(); i++) {
+            const Simplify::Vertex& v = alg.vertices[i];
+            if (v.locked) {
+                unsigned long global = it->globals[v.origin];
+                if (lockedIndex[global] == ULONG_MAX) {
+                    lockedIndex[global] = new_points.size();
+                    new_points.push_back(v.p);
+                }
+                localIndex[i] = lockedIndex[global];
+            }
+            else {
+                localIndex[i] = new_points.size();
+                new_points.push_back(v.p);
+            }
+        }
+
+        for (std::size_t i = 0; i < alg.triangles.size(); i++) {
             MeshFacet face;
-            face._aulPoints[0] = alg.triangles[i].v[0];
-            face._aulPoints[1] = alg.triangles[i].v[1];
-            face._aulPoints[2] = alg.triangles[i].v[2];
+            face._aulPoints[0] = localIndex[alg.triangles[i].v[0]];
+            face._aulPoints[1] = localIndex[alg.triangles[i].v[1]];
+            face._aulPoints[2] = localIndex[alg.triangles[i].v[2]];
             new_facets.push_back(face);
         }
+
+        // release the memory of the slab as early as possible
+        std::vector<Simplify::Triangle>().swap(alg.triangles);
+        std::vector<Simplify::Vertex>().swap(alg.vertices);
+        std::vector<Simplify::Ref>().swap(alg.refs);
+        std::vector<unsigned long>().swap(it->globals);
     }
 
     myKernel.Adopt(new_points, new_facets, true);
@@ -24,20 +24,50 @@
 #ifndef MESH_DECIMATION_H
 #define MESH_DECIMATION_H
 
+#include <vector>
 
 namespace MeshCore
 {
 class MeshKernel;
 
+/**
+ * The MeshSimplify class decimates a mesh by quadric based edge collapses.
+ * Large meshes are split into slabs along their longest axis that are
+ * decimated in parallel. The points shared by facets of different slabs are
+ * locked in a first pass and are decimated in a second pass with shifted
+ * slabs.
+ */
 class MeshExport MeshSimplify
 {
 public:
     MeshSimplify(MeshKernel&);
     ~MeshSimplify();
+    /** Sets the angle (in radians) between the normals of two adjacent facets
+     * above which their common edge is regarded as feature edge. The points of
+     * feature edges are kept. A value <= 0 disables the check which is the default.
+     */
+    void setFeatureAngle(float angle);
+    /** Sets the number of slabs the mesh is split into. A value <= 0 chooses
+     * it from the mesh size and the number of threads which is the default.
+     */
+    void setParts(int parts);
+    /** Reduces the number of facets by the factor \a reduction in the range
+     * [0.0,1.0] as long as the quadric error is below \a tolerance.
+     */
     void simplify(float tolerance, float reduction);
+    /** Reduces the number of facets to \a targetSize as long as the quadric
+     * error is below \a tolerance. A tolerance <= 0 means no limit.
+     */
+    void simplifyToSize(int targetSize, float tolerance = 0.0f);
+
+private:
+    void simplifyParts(unsigned long targetSize, int numParts, double tolerance);
+    std::vector<char> lockedPoints() const;
 
 private:
     MeshKernel& myKernel;
+    float myFeatureAngle;
+    int myParts;
 };
 
 } // namespace MeshCore
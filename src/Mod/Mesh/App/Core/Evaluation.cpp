@@ -28,6 +28,11 @@
 # include <vector>
 #endif
 
+#include <atomic>
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentMap>
+
 #include <Mod/Mesh/App/WildMagic4/Wm4Matrix3.h>
 #include <Mod/Mesh/App/WildMagic4/Wm4Vector3.h>
 
@@ -43,6 +48,7 @@
 #include <Base/Matrix.h>
 
 #include <Base/Sequencer.h>
+#include <Base/Tools.h>
 
 using namespace MeshCore;
 
@@ -591,76 +597,204 @@ bool MeshFixSingleFacet::Fixup ()
 
 // ----------------------------------------------------------------
 
-bool MeshEvalSelfIntersection::Evaluate ()
+namespace MeshCore {
+namespace SelfIntersection {
+
+/**
+ * Facet bounding boxes stored per component and ordered by their lower bound
+ * along the sweep axis. The sweep only needs to compare a box with its
+ * successors until their lower bound exceeds the upper bound of the box.
+ */
+struct SweepBoxes
 {
-    // Contains bounding boxes for every facet 
-    std::vector<Base::BoundBox3f> boxes;
+    std::vector<unsigned long> facet;
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+};
 
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
-    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX, ulGridY, ulGridZ;
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
+struct Chunk
+{
+    unsigned long begin, end;
+    std::vector<std::pair<unsigned long, unsigned long> > result;
+};
 
-    MeshFacetIterator cMFI(_rclMesh);
-    for (cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
-    }
+class SweepFunctor
+{
+public:
+    typedef void result_type;
 
-    // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX*ulGridY*ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        //Get the facet indices, belonging to the current grid unit
-        std::vector<unsigned long> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
+    SweepFunctor(const MeshKernel& kernel, const SweepBoxes& boxes, int axis, bool firstOnly,
+                 std::atomic<bool>& stop, std::atomic<unsigned long>& done)
+      : kernel(kernel), boxes(boxes), axis(axis), firstOnly(firstOnly), stop(stop), done(done)
+    {
+    }
 
-        seq.next();
-        if (aulGridElements.size()==0)
-            continue;
+    void operator()(Chunk& chunk) const
+    {
+        const MeshFacetArray& rFaces = kernel.GetFacets();
+        const std::vector<float>& lower = axis == 0 ? boxes.minX : (axis == 1 ? boxes.minY : boxes.minZ);
+        const std::vector<float>& upper = axis == 0 ? boxes.maxX : (axis == 1 ? boxes.maxY : boxes.maxZ);
+        unsigned long count = boxes.facet.size();
 
-        MeshGeomFacet facet1, facet2;
         Base::Vector3f pt1, pt2;
-        for (std::vector<unsigned long>::iterator it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<unsigned long>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) // the identical facet
+        for (unsigned long i = chunk.begin; i < chunk.end && !stop; ++i) {
+            unsigned long index1 = boxes.facet[i];
+            const MeshFacet& rface1 = rFaces[index1];
+            MeshGeomFacet facet1 = kernel.GetFacet(rface1);
+            float upperBound = upper[i];
+            for (unsigned long j = i + 1; j < count && lower[j] <= upperBound; ++j) {
+                if (boxes.minX[j] > boxes.maxX[i] || boxes.maxX[j] < boxes.minX[i] ||
+                    boxes.minY[j] > boxes.maxY[i] || boxes.maxY[j] < boxes.minY[i] ||
+                    boxes.minZ[j] > boxes.maxZ[i] || boxes.maxZ[j] < boxes.minZ[i])
                     continue;
-                // If the facets share a common vertex we do not check for self-intersections because they 
+
+                // If the facets share a common vertex we do not check for self-intersections because they
                 // could but usually do not intersect each other and the algorithm below would detect false-positives,
                 // otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0] || 
+                unsigned long index2 = boxes.facet[j];
+                const MeshFacet& rface2 = rFaces[index2];
+                if (rface1._aulPoints[0] == rface2._aulPoints[0] ||
                     rface1._aulPoints[0] == rface2._aulPoints[1] ||
                     rface1._aulPoints[0] == rface2._aulPoints[2])
                     continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[1] == rface2._aulPoints[0] || 
+                if (rface1._aulPoints[1] == rface2._aulPoints[0] ||
                     rface1._aulPoints[1] == rface2._aulPoints[1] ||
                     rface1._aulPoints[1] == rface2._aulPoints[2])
                     continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[2] == rface2._aulPoints[0] || 
+                if (rface1._aulPoints[2] == rface2._aulPoints[0] ||
                     rface1._aulPoints[2] == rface2._aulPoints[1] ||
                     rface1._aulPoints[2] == rface2._aulPoints[2])
                     continue; // ignore facets sharing a common vertex
 
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
+                MeshGeomFacet facet2 = kernel.GetFacet(rface2);
+                if (facet1.IntersectWithFacet(facet2, pt1, pt2) == 2) {
+                    chunk.result.push_back(std::make_pair(std::min(index1, index2), std::max(index1, index2)));
+                    if (firstOnly) {
                         // abort after the first detected self-intersection
-                        return false;
+                        stop = true;
+                        break;
                     }
                 }
             }
         }
+
+        ++done;
     }
 
-    return true;
+private:
+    const MeshKernel& kernel;
+    const SweepBoxes& boxes;
+    int axis;
+    bool firstOnly;
+    std::atomic<bool>& stop;
+    std::atomic<unsigned long>& done;
+};
+
+} // namespace SelfIntersection
+} // namespace MeshCore
+
+void MeshEvalSelfIntersection::CollectIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection,
+                                                    bool firstOnly, bool canAbort) const
+{
+    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    unsigned long ctFacets = rFaces.size();
+    if (ctFacets < 2)
+        return;
+
+    // Broad-phase: sweep the facet boxes along the axis of the largest extent
+    Base::BoundBox3f bbox = _rclMesh.GetBoundBox();
+    int axis = 0;
+    if (bbox.LengthY() > bbox.LengthX())
+        axis = 1;
+    if (bbox.LengthZ() > (axis == 0 ? bbox.LengthX() : bbox.LengthY()))
+        axis = 2;
+
+    std::vector<float> lower(ctFacets);
+    for (unsigned long i = 0; i < ctFacets; i++) {
+        const MeshFacet& face = rFaces[i];
+        float v0 = rPoints[face._aulPoints[0]][axis];
+        float v1 = rPoints[face._aulPoints[1]][axis];
+        float v2 = rPoints[face._aulPoints[2]][axis];
+        lower[i] = std::min(v0, std::min(v1, v2));
+    }
+
+    SelfIntersection::SweepBoxes boxes;
+    boxes.facet.resize(ctFacets);
+    std::generate(boxes.facet.begin(), boxes.facet.end(), Base::iotaGen<unsigned long>(0));
+    int threads = std::max(1, QThread::idealThreadCount());
+    MeshCore::parallel_sort(boxes.facet.begin(), boxes.facet.end(), [&lower](unsigned long a, unsigned long b) {
+        return lower[a] < lower[b] || (lower[a] == lower[b] && a < b);
+    }, threads);
+
+    boxes.minX.resize(ctFacets); boxes.minY.resize(ctFacets); boxes.minZ.resize(ctFacets);
+    boxes.maxX.resize(ctFacets); boxes.maxY.resize(ctFacets); boxes.maxZ.resize(ctFacets);
+    for (unsigned long i = 0; i < ctFacets; i++) {
+        const MeshFacet& face = rFaces[boxes.facet[i]];
+        const MeshPoint& p0 = rPoints[face._aulPoints[0]];
+        const MeshPoint& p1 = rPoints[face._aulPoints[1]];
+        const MeshPoint& p2 = rPoints[face._aulPoints[2]];
+        boxes.minX[i] = std::min(p0.x, std::min(p1.x, p2.x));
+        boxes.minY[i] = std::min(p0.y, std::min(p1.y, p2.y));
+        boxes.minZ[i] = std::min(p0.z, std::min(p1.z, p2.z));
+        boxes.maxX[i] = std::max(p0.x, std::max(p1.x, p2.x));
+        boxes.maxY[i] = std::max(p0.y, std::max(p1.y, p2.y));
+        boxes.maxZ[i] = std::max(p0.z, std::max(p1.z, p2.z));
+    }
+
+    // Narrow-phase: split the sweep into more chunks than threads so that the
+    // unequal costs of dense regions are balanced and the progress is reported
+    // at a reasonable rate. Each chunk collects its own results.
+    unsigned long numChunks = std::min<unsigned long>(threads * 16, ctFacets / 256 + 1);
+    std::vector<SelfIntersection::Chunk> chunks(numChunks);
+    for (unsigned long i = 0; i < numChunks; i++) {
+        chunks[i].begin = (ctFacets * i) / numChunks;
+        chunks[i].end = (ctFacets * (i + 1)) / numChunks;
+    }
+
+    std::atomic<bool> stop(false);
+    std::atomic<unsigned long> done(0);
+    SelfIntersection::SweepFunctor sweep(_rclMesh, boxes, axis, firstOnly, stop, done);
+
+    Base::SequencerLauncher seq("Checking for self-intersections...", numChunks);
+    if (threads < 2 || numChunks < 2) {
+        for (std::vector<SelfIntersection::Chunk>::iterator it = chunks.begin(); it != chunks.end() && !stop; ++it) {
+            sweep(*it);
+            seq.next(canAbort);
+        }
+    }
+    else {
+        // The sequencer must only be used by the calling thread, so it polls the
+        // number of finished chunks while the workers run
+        QFuture<void> future = QtConcurrent::map(chunks, sweep);
+        unsigned long reported = 0;
+        try {
+            while (!future.isFinished()) {
+                for (unsigned long count = done; reported < count; reported++)
+                    seq.next(canAbort);
+                QThread::msleep(10);
+            }
+        }
+        catch (...) {
+            stop = true;
+            future.cancel();
+            future.waitForFinished();
+            throw;
+        }
+        future.waitForFinished();
+    }
+
+    std::size_t offset = intersection.size();
+    for (std::vector<SelfIntersection::Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+        intersection.insert(intersection.end(), it->result.begin(), it->result.end());
+    std::sort(intersection.begin() + offset, intersection.end());
+}
+
+bool MeshEvalSelfIntersection::Evaluate ()
+{
+    std::vector<std::pair<unsigned long, unsigned long> > intersection;
+    CollectIntersections(intersection, true, false);
+    return intersection.empty();
 }
 
 void MeshEvalSelfIntersection::GetIntersections(const std::vector<std::pair<unsigned long, unsigned long> >& indices,
@@ -689,72 +823,7 @@ void MeshEvalSelfIntersection::GetIntersections(const std::vector<std::pair<unsi
 
 void MeshEvalSelfIntersection::GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection) const
 {
-    // Contains bounding boxes for every facet 
-    std::vector<Base::BoundBox3f> boxes;
-    //intersection.clear();
-
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
-    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX, ulGridY, ulGridZ;
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
-
-    MeshFacetIterator cMFI(_rclMesh);
-    for(cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
-    }
-
-    // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX*ulGridY*ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        //Get the facet indices, belonging to the current grid unit
-        std::vector<unsigned long> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
-
-        seq.next(true);
-        if (aulGridElements.size()==0)
-            continue;
-
-        MeshGeomFacet facet1, facet2;
-        Base::Vector3f pt1, pt2;
-        for (std::vector<unsigned long>::iterator it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<unsigned long>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) // the identical facet
-                    continue;
-                // If the facets share a common vertex we do not check for self-intersections because they 
-                // could but usually do not intersect each other and the algorithm below would detect false-positives,
-                // otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[0] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[0] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[1] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[1] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[1] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[2] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[2] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[2] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        intersection.push_back(std::make_pair (*it,*jt));
-                    }
-                }
-            }
-        }
-    }
+    CollectIntersections(intersection, false, true);
 }
 
 std::vector<unsigned long> MeshFixSelfIntersection::GetFacets() const
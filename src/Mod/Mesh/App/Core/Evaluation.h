@@ -297,6 +297,11 @@ public:
         std::vector<std::pair<Base::Vector3f, Base::Vector3f> >&) const;
     /// collect the index of all facets with self intersections
     void GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >&) const;
+
+private:
+    /// sweep the facet boxes and test the overlapping pairs in parallel
+    void CollectIntersections(std::vector<std::pair<unsigned long, unsigned long> >&,
+                              bool firstOnly, bool canAbort) const;
 };
 
 /**
@@ -43,12 +43,14 @@
 #include <zipios++/gzipoutputstream.h>
 
 #include <cmath>
+#include <cstring>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <boost/regex.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
+#include <QFile>
 
 
 using namespace MeshCore;
@@ -148,8 +150,26 @@ bool MeshInput::LoadAny(const char* FileName)
     if (!fi.isReadable())
         throw Base::FileException("No permission on the file",FileName);
 
+    // Map the file into memory so that the loaders read the data without
+    // going through the file stream buffers and the binary STL reader can
+    // parse it in place. If mapping isn't possible the file is streamed.
+    QFile file(QString::fromUtf8(FileName));
+    uchar* data = 0;
+    if (file.size() > 0 && file.open(QIODevice::ReadOnly))
+        data = file.map(0, file.size());
+    if (data) {
+        Base::MemoryIStreambuf buf(reinterpret_cast<const char*>(data),
+                                   static_cast<std::size_t>(file.size()));
+        std::istream str(&buf);
+        return LoadAny(fi, str);
+    }
+
     Base::ifstream str(fi, std::ios::in | std::ios::binary);
+    return LoadAny(fi, str);
+}
 
+bool MeshInput::LoadAny(const Base::FileInfo& fi, std::istream& str)
+{
     if (fi.hasExtension("bms")) {
         _rclMesh.Read(str);
         return true;
@@ -163,7 +183,7 @@ bool MeshInput::LoadAny(const char* FileName)
         else if (fi.hasExtension("iv")) {
             ok = LoadInventor( str );
             if (ok && _rclMesh.CountFacets() == 0)
-                Base::Console().Warning("No usable mesh found in file '%s'", FileName);
+                Base::Console().Warning("No usable mesh found in file '%s'", fi.filePath().c_str());
         }
         else if (fi.hasExtension("nas") || fi.hasExtension("bdf")) {
             ok = LoadNastran( str );
@@ -181,7 +201,7 @@ bool MeshInput::LoadAny(const char* FileName)
             ok = LoadPLY( str );
         }
         else {
-            throw Base::FileException("File extension not supported",FileName);
+            throw Base::FileException("File extension not supported",fi);
         }
 
         return ok;
@@ -1273,6 +1293,31 @@ bool MeshInput::LoadBinarySTL (std::istream &rstrIn)
     if (!rstrIn || rstrIn.bad() == true)
         return false;
 
+    // The data of a memory-mapped file is parsed in place
+    Base::MemoryIStreambuf* mem = dynamic_cast<Base::MemoryIStreambuf*>(rstrIn.rdbuf());
+    if (mem && mem->size() >= mem->tell() + 84) {
+        std::size_t pos = mem->tell();
+        const char* data = mem->data() + pos;
+        std::memcpy(&ulCt, data + 80, sizeof(ulCt));
+        if (ulCt > (mem->size() - pos - 84) / 50)
+            return false; // not a valid STL file
+
+        MeshFastBuilder builder(this->_rclMesh);
+        builder.Initialize(ulCt);
+
+        const char* record = data + 84;
+        for (uint32_t i = 0; i < ulCt; i++, record += 50) {
+            // normal and points followed by the 2 bytes attribute
+            std::memcpy(clVects, record, sizeof(clVects));
+            std::swap(clVects[0], clVects[3]);
+            builder.AddFacet(clVects);
+        }
+
+        builder.Finish();
+        mem->pubseekoff(static_cast<std::streamoff>(record - mem->data()), std::ios::beg, std::ios::in);
+        return true;
+    }
+
     // Header-Info ueberlesen
     rstrIn.read(szInfo, sizeof(szInfo));
 
@@ -1653,6 +1698,11 @@ void MeshOutput::SetSTLHeaderData(const std::string& header)
     }
 }
 
+const std::string& MeshOutput::GetSTLHeaderData()
+{
+    return stl_header;
+}
+
 void MeshOutput::Transform(const Base::Matrix4D& mat)
 {
     _transform = mat;
@@ -30,6 +30,7 @@
 #include <App/Material.h>
 
 namespace Base {
+class FileInfo;
 class XMLReader;
 class Writer;
 }
@@ -127,6 +128,10 @@ public:
     /** Loads a Cadmould FE file. */
     bool LoadCadmouldFE (std::ifstream &rstrIn);
 
+protected:
+    /// Loads the data of the stream, decided by the extension of the file
+    bool LoadAny(const Base::FileInfo& fi, std::istream &str);
+
 protected:
     MeshKernel &_rclMesh;   /**< reference to mesh data structure */
     Material* _material;
@@ -158,6 +163,8 @@ public:
      * automatically filled up with spaces.
      */
     static void SetSTLHeaderData(const std::string&);
+    /// Returns the header data of a binary STL
+    static const std::string& GetSTLHeaderData();
     /// Determine the mesh format by file extension
     static MeshIO::Format GetFormat(const char* FileName);
     /// Saves the file, decided by extension if not explicitly given
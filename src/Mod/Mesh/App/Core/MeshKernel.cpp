@@ -812,19 +812,36 @@ void MeshKernel::Write (std::ostream &rclOut) const
     // write the number of points and facets
     str << (uint32_t)CountPoints() << (uint32_t)CountFacets();
 
-    // write the data
+    // write the data in blocks to avoid the overhead per value
+    const std::size_t blockSize = 4096;
+    std::vector<float> coords;
+    coords.reserve(3 * blockSize);
     for (MeshPointArray::_TConstIterator it = _aclPointArray.begin(); it != _aclPointArray.end(); ++it) {
-        str << it->x << it->y << it->z;
+        coords.push_back(it->x);
+        coords.push_back(it->y);
+        coords.push_back(it->z);
+        if (coords.size() == 3 * blockSize) {
+            str.write(coords.data(), coords.size());
+            coords.clear();
+        }
     }
+    str.write(coords.data(), coords.size());
 
+    std::vector<uint32_t> indices;
+    indices.reserve(6 * blockSize);
     for (MeshFacetArray::_TConstIterator it = _aclFacetArray.begin(); it != _aclFacetArray.end(); ++it) {
-        str << (uint32_t)it->_aulPoints[0] 
-            << (uint32_t)it->_aulPoints[1] 
-            << (uint32_t)it->_aulPoints[2];
-        str << (uint32_t)it->_aulNeighbours[0] 
-            << (uint32_t)it->_aulNeighbours[1] 
-            << (uint32_t)it->_aulNeighbours[2];
+        indices.push_back((uint32_t)it->_aulPoints[0]);
+        indices.push_back((uint32_t)it->_aulPoints[1]);
+        indices.push_back((uint32_t)it->_aulPoints[2]);
+        indices.push_back((uint32_t)it->_aulNeighbours[0]);
+        indices.push_back((uint32_t)it->_aulNeighbours[1]);
+        indices.push_back((uint32_t)it->_aulNeighbours[2]);
+        if (indices.size() == 6 * blockSize) {
+            str.write(indices.data(), indices.size());
+            indices.clear();
+        }
     }
+    str.write(indices.data(), indices.size());
 
     str << _clBoundBox.MinX << _clBoundBox.MaxX;
     str << _clBoundBox.MinY << _clBoundBox.MaxY;
@@ -865,19 +882,34 @@ void MeshKernel::Read (std::istream &rclIn)
         str >> uCtPts >> uCtFts;
 
         try {
-            // read the data
+            // read the data in blocks to avoid the overhead per value
+            const std::size_t blockSize = 4096;
             MeshPointArray pointArray;
             pointArray.resize(uCtPts);
-            for (MeshPointArray::_TIterator it = pointArray.begin(); it != pointArray.end(); ++it) {
-                str >> it->x >> it->y >> it->z;
+            std::vector<float> coords(3 * blockSize);
+            for (std::size_t index = 0; index < uCtPts; index += blockSize) {
+                std::size_t num = std::min<std::size_t>(blockSize, uCtPts - index);
+                str.read(coords.data(), 3 * num);
+                for (std::size_t i = 0; i < num; i++)
+                    pointArray[index + i].Set(coords[3*i], coords[3*i+1], coords[3*i+2]);
             }
           
             MeshFacetArray facetArray;
             facetArray.resize(uCtFts);
 
+            std::vector<uint32_t> indices(6 * blockSize);
+            std::vector<uint32_t>::const_iterator jt = indices.end();
             uint32_t v1, v2, v3;
             for (MeshFacetArray::_TIterator it = facetArray.begin(); it != facetArray.end(); ++it) {
-                str >> v1 >> v2 >> v3;
+                if (jt == indices.end()) {
+                    std::size_t index = it - facetArray.begin();
+                    std::size_t num = std::min<std::size_t>(blockSize, uCtFts - index);
+                    indices.resize(6 * num);
+                    str.read(indices.data(), indices.size());
+                    jt = indices.begin();
+                }
+
+                v1 = *jt++; v2 = *jt++; v3 = *jt++;
 
                 // make sure to have valid indices
                 if (v1 >= uCtPts || v2 >= uCtPts || v3 >= uCtPts)
@@ -891,7 +923,7 @@ void MeshKernel::Read (std::istream &rclIn)
                 // the empty neighbour must be explicitly set to 'ULONG_MAX'
                 // because in algorithms this value is always used to check
                 // for open edges.
-                str >> v1 >> v2 >> v3;
+                v1 = *jt++; v2 = *jt++; v3 = *jt++;
 
                 // make sure to have valid indices
                 if (v1 >= uCtFts && v1 < open_edge)
@@ -1010,15 +1042,19 @@ void MeshKernel::operator *= (const Base::Matrix4D &rclMat)
 
 void MeshKernel::Transform (const Base::Matrix4D &rclMat)
 {
-    MeshPointArray::_TIterator  clPIter = _aclPointArray.begin(), clPEIter = _aclPointArray.end();
-    Base::Matrix4D clMatrix(rclMat);
-
-    _clBoundBox.SetVoid();
-    while (clPIter < clPEIter) {
-        *clPIter *= clMatrix;
-        _clBoundBox.Add(*clPIter);
-        clPIter++;
+    // same arithmetic as Matrix4D::multVec but with the coefficients kept in registers
+    const double m00 = rclMat[0][0], m01 = rclMat[0][1], m02 = rclMat[0][2], m03 = rclMat[0][3];
+    const double m10 = rclMat[1][0], m11 = rclMat[1][1], m12 = rclMat[1][2], m13 = rclMat[1][3];
+    const double m20 = rclMat[2][0], m21 = rclMat[2][1], m22 = rclMat[2][2], m23 = rclMat[2][3];
+
+    for (MeshPointArray::_TIterator it = _aclPointArray.begin(); it != _aclPointArray.end(); ++it) {
+        double x = it->x, y = it->y, z = it->z;
+        it->x = static_cast<float>(m00*x + m01*y + m02*z + m03);
+        it->y = static_cast<float>(m10*x + m11*y + m12*z + m13);
+        it->z = static_cast<float>(m20*x + m21*y + m22*z + m23);
     }
+
+    RecalcBoundBox();
 }
 
 void MeshKernel::Smooth(int iterations, float stepsize)
@@ -1030,8 +1066,21 @@ void MeshKernel::Smooth(int iterations, float stepsize)
 void MeshKernel::RecalcBoundBox (void)
 {
     _clBoundBox.SetVoid();
-    for (MeshPointArray::_TConstIterator pI = _aclPointArray.begin(); pI != _aclPointArray.end(); pI++)
-        _clBoundBox.Add(*pI);
+    if (_aclPointArray.empty())
+        return;
+
+    float minX, minY, minZ, maxX, maxY, maxZ;
+    minX = maxX = _aclPointArray.front().x;
+    minY = maxY = _aclPointArray.front().y;
+    minZ = maxZ = _aclPointArray.front().z;
+    for (MeshPointArray::_TConstIterator pI = _aclPointArray.begin(); pI != _aclPointArray.end(); ++pI) {
+        minX = std::min(minX, pI->x); maxX = std::max(maxX, pI->x);
+        minY = std::min(minY, pI->y); maxY = std::max(maxY, pI->y);
+        minZ = std::min(minZ, pI->z); maxZ = std::max(maxZ, pI->z);
+    }
+
+    _clBoundBox.MinX = minX; _clBoundBox.MinY = minY; _clBoundBox.MinZ = minZ;
+    _clBoundBox.MaxX = maxX; _clBoundBox.MaxY = maxY; _clBoundBox.MaxZ = maxZ;
 }
 
 std::vector<Base::Vector3f> MeshKernel::CalcVertexNormals() const
@@ -1057,12 +1106,16 @@ std::vector<Base::Vector3f> MeshKernel::CalcVertexNormals() const
 // Evaluation
 float MeshKernel::GetSurface() const
 {
-    float fSurface = 0.0;
-    MeshFacetIterator cIter(*this);
-    for (cIter.Init(); cIter.More(); cIter.Next())
-        fSurface += cIter->Area();
+    // access the points directly instead of building a MeshGeomFacet with its normal per facet
+    double fSurface = 0.0;
+    for (MeshFacetArray::_TConstIterator it = _aclFacetArray.begin(); it != _aclFacetArray.end(); ++it) {
+        const Base::Vector3f& p0 = _aclPointArray[it->_aulPoints[0]];
+        const Base::Vector3f& p1 = _aclPointArray[it->_aulPoints[1]];
+        const Base::Vector3f& p2 = _aclPointArray[it->_aulPoints[2]];
+        fSurface += ((p1 - p0) % (p2 - p0)).Length();
+    }
 
-    return fSurface;
+    return static_cast<float>(0.5 * fSurface);
 }
 
 float MeshKernel::GetSurface( const std::vector<unsigned long>& aSegment ) const
@@ -1084,22 +1137,18 @@ float MeshKernel::GetVolume() const
     //if ( !cSolid.Evaluate() )
     //    return 0.0f; // no solid
 
-    float fVolume = 0.0;
-    MeshFacetIterator cIter(*this);
-    Base::Vector3f p1,p2,p3;
-    for (cIter.Init(); cIter.More(); cIter.Next()) {
-        const MeshGeomFacet& rclF = *cIter;
-        p1 = rclF._aclPoints[0];
-        p2 = rclF._aclPoints[1];
-        p3 = rclF._aclPoints[2];
+    double fVolume = 0.0;
+    for (MeshFacetArray::_TConstIterator it = _aclFacetArray.begin(); it != _aclFacetArray.end(); ++it) {
+        const Base::Vector3f& p1 = _aclPointArray[it->_aulPoints[0]];
+        const Base::Vector3f& p2 = _aclPointArray[it->_aulPoints[1]];
+        const Base::Vector3f& p3 = _aclPointArray[it->_aulPoints[2]];
 
         fVolume += (-p3.x*p2.y*p1.z + p2.x*p3.y*p1.z + p3.x*p1.y*p2.z - p1.x*p3.y*p2.z - p2.x*p1.y*p3.z + p1.x*p2.y*p3.z);
     }
 
     fVolume /= 6.0;
-    fVolume = (float)fabs(fVolume);
 
-    return fVolume;
+    return static_cast<float>(fabs(fVolume));
 }
 
 bool MeshKernel::HasOpenEdges() const
@@ -0,0 +1,416 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cctype>
+# include <cmath>
+# include <cstring>
+# include <istream>
+# include <ostream>
+# include <sstream>
+# include <string>
+#endif
+
+#include <Base/Sequencer.h>
+
+#include "MeshStream.h"
+#include "MeshIO.h"
+
+using namespace MeshCore;
+
+MeshStreamReader* MeshStreamReader::CreateSTLReader(std::istream& str)
+{
+    // A binary STL whose size matches the number of facets in its header is
+    // taken as binary even if the header starts with 'solid' which some
+    // exporters write. Otherwise the keyword decides.
+    std::streamoff size = str.seekg(0, std::ios::end).tellg();
+    str.seekg(0, std::ios::beg);
+
+    bool binary = true;
+    char header[80];
+    uint32_t count = 0;
+    if (size >= 84 && str.read(header, sizeof(header)) && str.read((char*)&count, sizeof(count))) {
+        if (84 + 50 * static_cast<std::streamoff>(count) != size) {
+            std::string start(header, 80);
+            std::string::size_type pos = start.find_first_not_of(" \t\r\n");
+            if (pos != std::string::npos) {
+                start = start.substr(pos, 5);
+                for (std::string::iterator it = start.begin(); it != start.end(); ++it)
+                    *it = toupper(*it);
+                binary = (start != "SOLID");
+            }
+        }
+    }
+    else {
+        binary = false;
+    }
+
+    str.clear();
+    str.seekg(0, std::ios::beg);
+    if (binary)
+        return new MeshStreamBinarySTLReader(str);
+    return new MeshStreamAsciiSTLReader(str);
+}
+
+// ----------------------------------------------------------------------------
+
+MeshStreamBinarySTLReader::MeshStreamBinarySTLReader(std::istream& str)
+  : str(str), ulCount(0), ulRead(0)
+{
+    char header[80];
+    uint32_t count = 0;
+    if (str.read(header, sizeof(header)) && str.read((char*)&count, sizeof(count)))
+        ulCount = count;
+}
+
+bool MeshStreamBinarySTLReader::Read(std::vector<MeshGeomFacet>& chunk, std::size_t max)
+{
+    std::size_t num = std::min<std::size_t>(max, ulCount - ulRead);
+    if (num == 0)
+        return false;
+
+    // normal and points followed by the 2 bytes attribute
+    buffer.resize(num * 50);
+    str.read(&buffer[0], buffer.size());
+    num = static_cast<std::size_t>(str.gcount()) / 50;
+    if (num == 0)
+        return false;
+
+    Base::Vector3f points[3];
+    for (std::size_t i = 0; i < num; i++) {
+        std::memcpy(points, &buffer[i * 50 + 12], sizeof(points));
+        chunk.push_back(MeshGeomFacet(points[0], points[1], points[2]));
+    }
+
+    ulRead += num;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+MeshStreamAsciiSTLReader::MeshStreamAsciiSTLReader(std::istream& str)
+  : str(str)
+{
+}
+
+bool MeshStreamAsciiSTLReader::Read(std::vector<MeshGeomFacet>& chunk, std::size_t max)
+{
+    std::string line, keyword;
+    Base::Vector3f points[3];
+    int numPoints = 0;
+    std::size_t num = 0;
+
+    while (num < max && std::getline(str, line)) {
+        std::istringstream tokens(line);
+        if (!(tokens >> keyword))
+            continue;
+        for (std::string::iterator it = keyword.begin(); it != keyword.end(); ++it)
+            *it = toupper(*it);
+        if (keyword == "FACET") {
+            numPoints = 0;
+        }
+        else if (keyword == "VERTEX" && numPoints < 3) {
+            float x, y, z;
+            if (tokens >> x >> y >> z)
+                points[numPoints++].Set(x, y, z);
+            if (numPoints == 3) {
+                chunk.push_back(MeshGeomFacet(points[0], points[1], points[2]));
+                numPoints = 0;
+                num++;
+            }
+        }
+    }
+
+    return num > 0;
+}
+
+// ----------------------------------------------------------------------------
+
+void MeshStreamTransform::Process(std::vector<MeshGeomFacet>& chunk)
+{
+    for (std::vector<MeshGeomFacet>::iterator it = chunk.begin(); it != chunk.end(); ++it) {
+        for (int i = 0; i < 3; i++)
+            mat.multVec(it->_aclPoints[i], it->_aclPoints[i]);
+        it->NormalInvalid();
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool MeshStreamClustering::Triple::operator==(const Triple& t) const
+{
+    for (int i = 0; i < 3; i++) {
+        if (c[i].x != t.c[i].x || c[i].y != t.c[i].y || c[i].z != t.c[i].z)
+            return false;
+    }
+    return true;
+}
+
+std::size_t MeshStreamClustering::TripleHash::operator()(const Triple& t) const
+{
+    std::size_t seed = 0;
+    for (int i = 0; i < 3; i++) {
+        int64_t v[3] = {t.c[i].x, t.c[i].y, t.c[i].z};
+        for (int j = 0; j < 3; j++)
+            seed ^= std::hash<int64_t>()(v[j]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
+
+MeshStreamClustering::MeshStreamClustering(float cellSize)
+  : fCellSize(cellSize)
+{
+}
+
+MeshStreamClustering::Cell MeshStreamClustering::ToCell(const Base::Vector3f& p) const
+{
+    Cell c;
+    c.x = static_cast<int64_t>(std::floor(p.x / fCellSize));
+    c.y = static_cast<int64_t>(std::floor(p.y / fCellSize));
+    c.z = static_cast<int64_t>(std::floor(p.z / fCellSize));
+    return c;
+}
+
+Base::Vector3f MeshStreamClustering::ToPoint(const Cell& c) const
+{
+    return Base::Vector3f((static_cast<float>(c.x) + 0.5f) * fCellSize,
+                          (static_cast<float>(c.y) + 0.5f) * fCellSize,
+                          (static_cast<float>(c.z) + 0.5f) * fCellSize);
+}
+
+void MeshStreamClustering::Process(std::vector<MeshGeomFacet>& chunk)
+{
+    if (fCellSize <= 0.0f)
+        return;
+
+    auto less = [](const Cell& a, const Cell& b) {
+        if (a.x != b.x) return a.x < b.x;
+        if (a.y != b.y) return a.y < b.y;
+        return a.z < b.z;
+    };
+
+    std::vector<MeshGeomFacet>::iterator out = chunk.begin();
+    for (std::vector<MeshGeomFacet>::iterator it = chunk.begin(); it != chunk.end(); ++it) {
+        Triple t;
+        for (int i = 0; i < 3; i++)
+            t.c[i] = ToCell(it->_aclPoints[i]);
+
+        // the facet collapses if two corners are in the same cell
+        if (!less(t.c[0], t.c[1]) && !less(t.c[1], t.c[0]))
+            continue;
+        if (!less(t.c[1], t.c[2]) && !less(t.c[2], t.c[1]))
+            continue;
+        if (!less(t.c[0], t.c[2]) && !less(t.c[2], t.c[0]))
+            continue;
+
+        // the key doesn't depend on the order of the corners
+        Triple key = t;
+        std::sort(key.c, key.c + 3, less);
+        if (!triples.insert(key).second)
+            continue;
+
+        MeshGeomFacet facet(ToPoint(t.c[0]), ToPoint(t.c[1]), ToPoint(t.c[2]));
+        *out++ = facet;
+    }
+
+    chunk.erase(out, chunk.end());
+}
+
+// ----------------------------------------------------------------------------
+
+MeshStreamBinarySTLWriter::MeshStreamBinarySTLWriter(std::ostream& str)
+  : str(str), countPos(-1), ulCount(0)
+{
+}
+
+bool MeshStreamBinarySTLWriter::Begin()
+{
+    if (!str || str.bad())
+        return false;
+
+    // the header has a length of 80
+    std::string header = MeshOutput::GetSTLHeaderData();
+    header.resize(80, ' ');
+    str.write(header.c_str(), 80);
+
+    countPos = str.tellp();
+    ulCount = 0;
+    str.write((const char*)&ulCount, sizeof(ulCount));
+    return countPos >= 0 && str.good();
+}
+
+bool MeshStreamBinarySTLWriter::Write(const std::vector<MeshGeomFacet>& chunk)
+{
+    uint16_t usAtt = 0;
+    for (std::vector<MeshGeomFacet>::const_iterator it = chunk.begin(); it != chunk.end(); ++it) {
+        Base::Vector3f normal = it->GetNormal();
+        str.write((const char*)&(normal.x), sizeof(float));
+        str.write((const char*)&(normal.y), sizeof(float));
+        str.write((const char*)&(normal.z), sizeof(float));
+        for (int i = 0; i < 3; i++) {
+            str.write((const char*)&(it->_aclPoints[i].x), sizeof(float));
+            str.write((const char*)&(it->_aclPoints[i].y), sizeof(float));
+            str.write((const char*)&(it->_aclPoints[i].z), sizeof(float));
+        }
+        str.write((const char*)&usAtt, sizeof(usAtt));
+    }
+
+    ulCount += static_cast<uint32_t>(chunk.size());
+    return str.good();
+}
+
+bool MeshStreamBinarySTLWriter::End()
+{
+    // now the number of facets is known
+    std::streamoff endPos = str.tellp();
+    str.seekp(countPos, std::ios::beg);
+    str.write((const char*)&ulCount, sizeof(ulCount));
+    str.seekp(endPos, std::ios::beg);
+    str.flush();
+    return str.good();
+}
+
+// ----------------------------------------------------------------------------
+
+MeshStreamAsciiSTLWriter::MeshStreamAsciiSTLWriter(std::ostream& str)
+  : str(str)
+{
+}
+
+bool MeshStreamAsciiSTLWriter::Begin()
+{
+    if (!str || str.bad())
+        return false;
+
+    str.precision(6);
+    str.setf(std::ios::fixed | std::ios::showpoint);
+    str << "solid Mesh" << std::endl;
+    return str.good();
+}
+
+bool MeshStreamAsciiSTLWriter::Write(const std::vector<MeshGeomFacet>& chunk)
+{
+    for (std::vector<MeshGeomFacet>::const_iterator it = chunk.begin(); it != chunk.end(); ++it) {
+        Base::Vector3f normal = it->GetNormal();
+        str << "  facet normal " << normal.x << " " << normal.y << " " << normal.z << '\n';
+        str << "    outer loop" << '\n';
+        for (int i = 0; i < 3; i++) {
+            str << "      vertex " << it->_aclPoints[i].x << " "
+                                   << it->_aclPoints[i].y << " "
+                                   << it->_aclPoints[i].z << '\n';
+        }
+        str << "    endloop" << '\n';
+        str << "  endfacet" << '\n';
+    }
+
+    return str.good();
+}
+
+bool MeshStreamAsciiSTLWriter::End()
+{
+    str << "endsolid Mesh" << std::endl;
+    return str.good();
+}
+
+// ----------------------------------------------------------------------------
+
+MeshStreamOBJWriter::MeshStreamOBJWriter(std::ostream& str)
+  : str(str), ulIndex(1)
+{
+}
+
+bool MeshStreamOBJWriter::Begin()
+{
+    if (!str || str.bad())
+        return false;
+
+    str << "# Created by FreeCAD <http://www.freecadweb.org>" << std::endl;
+    str.precision(6);
+    str.setf(std::ios::fixed | std::ios::showpoint);
+    ulIndex = 1;
+    return str.good();
+}
+
+bool MeshStreamOBJWriter::Write(const std::vector<MeshGeomFacet>& chunk)
+{
+    // a face may only refer to vertices written before it
+    for (std::vector<MeshGeomFacet>::const_iterator it = chunk.begin(); it != chunk.end(); ++it) {
+        for (int i = 0; i < 3; i++) {
+            str << "v " << it->_aclPoints[i].x << " "
+                        << it->_aclPoints[i].y << " "
+                        << it->_aclPoints[i].z << '\n';
+        }
+    }
+    for (std::size_t i = 0; i < chunk.size(); i++, ulIndex += 3) {
+        str << "f " << ulIndex << " " << ulIndex + 1 << " " << ulIndex + 2 << '\n';
+    }
+
+    return str.good();
+}
+
+bool MeshStreamOBJWriter::End()
+{
+    str.flush();
+    return str.good();
+}
+
+// ----------------------------------------------------------------------------
+
+MeshStreamPipeline::MeshStreamPipeline(MeshStreamReader& reader, MeshStreamWriter& writer)
+  : reader(reader), writer(writer), chunkSize(100000), ulRead(0), ulWritten(0)
+{
+}
+
+bool MeshStreamPipeline::Run()
+{
+    ulRead = 0;
+    ulWritten = 0;
+    if (!writer.Begin())
+        return false;
+
+    std::size_t size = std::max<std::size_t>(1, chunkSize);
+    std::size_t steps = (reader.CountFacets() + size - 1) / size;
+    Base::SequencerLauncher seq("Processing mesh...", steps);
+
+    std::vector<MeshGeomFacet> chunk;
+    chunk.reserve(size);
+    for (;;) {
+        chunk.clear();
+        if (!reader.Read(chunk, size))
+            break;
+        ulRead += chunk.size();
+
+        for (std::vector<MeshStreamFilter*>::iterator it = filters.begin(); it != filters.end(); ++it)
+            (*it)->Process(chunk);
+
+        if (!writer.Write(chunk))
+            return false;
+        ulWritten += chunk.size();
+        seq.next(true); // allow to cancel
+    }
+
+    return writer.End();
+}
@@ -0,0 +1,233 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESHCORE_MESHSTREAM_H
+#define MESHCORE_MESHSTREAM_H
+
+#include <iosfwd>
+#include <stdint.h>
+#include <unordered_set>
+#include <vector>
+
+#include "Elements.h"
+#include <Base/Matrix.h>
+
+namespace MeshCore
+{
+
+/**
+ * Triangle meshes that don't fit into memory can't be loaded into a
+ * MeshKernel. The classes below process such meshes in chunks of facets
+ * instead: a MeshStreamReader reads a chunk, the MeshStreamFilter stages
+ * modify it and a MeshStreamWriter appends it to the output. Since no
+ * topology is available the facets are handled as a triangle soup.
+ */
+
+/** Base class of the readers of a MeshStreamPipeline. */
+class MeshExport MeshStreamReader
+{
+public:
+    virtual ~MeshStreamReader() {}
+    /** Reads up to \a max facets into \a chunk.
+     * Returns false if no more facets could be read.
+     */
+    virtual bool Read(std::vector<MeshGeomFacet>& chunk, std::size_t max) = 0;
+    /// Returns the number of facets if stored in the header, 0 otherwise
+    virtual unsigned long CountFacets() const
+    { return 0; }
+
+    /** Creates a reader for the STL data of the stream.
+     * The stream must be opened in binary mode and be seekable.
+     */
+    static MeshStreamReader* CreateSTLReader(std::istream& str);
+};
+
+class MeshExport MeshStreamBinarySTLReader : public MeshStreamReader
+{
+public:
+    MeshStreamBinarySTLReader(std::istream& str);
+    bool Read(std::vector<MeshGeomFacet>& chunk, std::size_t max);
+    unsigned long CountFacets() const
+    { return ulCount; }
+
+private:
+    std::istream& str;
+    unsigned long ulCount;
+    unsigned long ulRead;
+    std::vector<char> buffer;
+};
+
+class MeshExport MeshStreamAsciiSTLReader : public MeshStreamReader
+{
+public:
+    MeshStreamAsciiSTLReader(std::istream& str);
+    bool Read(std::vector<MeshGeomFacet>& chunk, std::size_t max);
+
+private:
+    std::istream& str;
+};
+
+// ----------------------------------------------------------------------------
+
+/** Base class of the filter stages of a MeshStreamPipeline. */
+class MeshExport MeshStreamFilter
+{
+public:
+    virtual ~MeshStreamFilter() {}
+    /// Modifies the chunk in place. Facets may be removed.
+    virtual void Process(std::vector<MeshGeomFacet>& chunk) = 0;
+};
+
+/** Applies a transformation to the facets. */
+class MeshExport MeshStreamTransform : public MeshStreamFilter
+{
+public:
+    MeshStreamTransform(const Base::Matrix4D& mat) : mat(mat) {}
+    void Process(std::vector<MeshGeomFacet>& chunk);
+
+private:
+    Base::Matrix4D mat;
+};
+
+/**
+ * Decimates the mesh by vertex clustering: every point is moved to the centre
+ * of the grid cell of size \a cellSize that contains it. Facets that collapse
+ * or that map to an already written cell triple are removed. Only the set of
+ * the written cell triples is kept, so the memory depends on the size of the
+ * output mesh but not of the input mesh.
+ */
+class MeshExport MeshStreamClustering : public MeshStreamFilter
+{
+public:
+    MeshStreamClustering(float cellSize);
+    void Process(std::vector<MeshGeomFacet>& chunk);
+
+private:
+    struct Cell { int64_t x, y, z; };
+    struct Triple {
+        Cell c[3];
+        bool operator==(const Triple&) const;
+    };
+    struct TripleHash {
+        std::size_t operator()(const Triple&) const;
+    };
+
+    Cell ToCell(const Base::Vector3f&) const;
+    Base::Vector3f ToPoint(const Cell&) const;
+
+    float fCellSize;
+    std::unordered_set<Triple, TripleHash> triples;
+};
+
+// ----------------------------------------------------------------------------
+
+/** Base class of the writers of a MeshStreamPipeline. */
+class MeshExport MeshStreamWriter
+{
+public:
+    virtual ~MeshStreamWriter() {}
+    virtual bool Begin() = 0;
+    virtual bool Write(const std::vector<MeshGeomFacet>& chunk) = 0;
+    virtual bool End() = 0;
+};
+
+/** Writes a binary STL. The stream must be seekable to set the number of facets at the end. */
+class MeshExport MeshStreamBinarySTLWriter : public MeshStreamWriter
+{
+public:
+    MeshStreamBinarySTLWriter(std::ostream& str);
+    bool Begin();
+    bool Write(const std::vector<MeshGeomFacet>& chunk);
+    bool End();
+
+private:
+    std::ostream& str;
+    std::streamoff countPos;
+    uint32_t ulCount;
+};
+
+class MeshExport MeshStreamAsciiSTLWriter : public MeshStreamWriter
+{
+public:
+    MeshStreamAsciiSTLWriter(std::ostream& str);
+    bool Begin();
+    bool Write(const std::vector<MeshGeomFacet>& chunk);
+    bool End();
+
+private:
+    std::ostream& str;
+};
+
+/** Writes an OBJ file. The points of the facets are not shared. */
+class MeshExport MeshStreamOBJWriter : public MeshStreamWriter
+{
+public:
+    MeshStreamOBJWriter(std::ostream& str);
+    bool Begin();
+    bool Write(const std::vector<MeshGeomFacet>& chunk);
+    bool End();
+
+private:
+    std::ostream& str;
+    unsigned long ulIndex;
+};
+
+// ----------------------------------------------------------------------------
+
+/**
+ * The MeshStreamPipeline class passes the facets chunk by chunk from the
+ * reader through the filters to the writer. The reader, filters and writer
+ * are not owned by the pipeline.
+ */
+class MeshExport MeshStreamPipeline
+{
+public:
+    MeshStreamPipeline(MeshStreamReader& reader, MeshStreamWriter& writer);
+
+    void AddFilter(MeshStreamFilter* filter)
+    { filters.push_back(filter); }
+    /// Sets the maximum number of facets per chunk
+    void SetChunkSize(std::size_t size)
+    { chunkSize = size; }
+    /** Runs the pipeline. The progress can be cancelled which throws
+     * a Base::AbortException.
+     */
+    bool Run();
+
+    unsigned long CountFacetsRead() const
+    { return ulRead; }
+    unsigned long CountFacetsWritten() const
+    { return ulWritten; }
+
+private:
+    MeshStreamReader& reader;
+    MeshStreamWriter& writer;
+    std::vector<MeshStreamFilter*> filters;
+    std::size_t chunkSize;
+    unsigned long ulRead;
+    unsigned long ulWritten;
+};
+
+} // namespace MeshCore
+
+#endif // MESHCORE_MESHSTREAM_H
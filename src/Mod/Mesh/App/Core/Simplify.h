@@ -9,6 +9,8 @@
 // * Comment out printf statements
 // * Fix compiler warnings
 // * Remove macros loop,i,j,k
+// * Add locked vertices that are never moved or removed and keep track of
+//   the original vertex index in compact_mesh
 
 #include <vector>
 #include <Base/Vector3D.h>
@@ -82,7 +84,7 @@ class Simplify
 {
 public:
     struct Triangle { int v[3];double err[4];int deleted,dirty;vec3f n; };
-    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;};
+    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;int locked;int origin;};
     struct Ref { int tid,tvertex; }; 
     std::vector<Triangle> triangles;
     std::vector<Vertex> vertices;
@@ -195,6 +197,8 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
                     // Border check
                     if (v0.border != v1.border)
                         continue;
+                    if (v0.locked || v1.locked)
+                        continue;
 
                     // Compute vertex to collapse to
                     vec3f p;
@@ -478,6 +482,8 @@ void Simplify::compact_mesh()
         {
             vertices[i].tstart=dst;
             vertices[dst].p=vertices[i].p;
+            vertices[dst].locked=vertices[i].locked;
+            vertices[dst].origin=vertices[i].origin;
             dst++;
         }
     }
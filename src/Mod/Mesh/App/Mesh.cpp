@@ -31,10 +31,12 @@
 #include <Base/Builder3D.h>
 #include <Base/Console.h>
 #include <Base/Exception.h>
+#include <Base/FileInfo.h>
 #include <Base/Writer.h>
 #include <Base/Reader.h>
 #include <Base/Interpreter.h>
 #include <Base/Sequencer.h>
+#include <Base/Stream.h>
 #include <Base/Tools.h>
 #include <Base/ViewProj.h>
 
@@ -52,6 +54,7 @@
 #include "Core/Trim.h"
 #include "Core/Visitor.h"
 #include "Core/Decimation.h"
+#include "Core/MeshStream.h"
 
 #include "Mesh.h"
 #include "MeshPy.h"
@@ -954,6 +957,14 @@ void MeshObject::decimate(float fTolerance, float fReduction)
     dm.simplify(fTolerance, fReduction);
 }
 
+void MeshObject::decimate(int targetSize, float fTolerance, float fFeatureAngle, int parts)
+{
+    MeshCore::MeshSimplify dm(this->_kernel);
+    dm.setFeatureAngle(fFeatureAngle);
+    dm.setParts(parts);
+    dm.simplifyToSize(targetSize, fTolerance);
+}
+
 Base::Vector3d MeshObject::getPointNormal(unsigned long index) const
 {
     std::vector<Base::Vector3f> temp = _kernel.CalcVertexNormals();
@@ -1700,6 +1711,49 @@ MeshObject* MeshObject::createCube(float length, float width, float height, floa
     return 0;
 }
 
+unsigned long MeshObject::convert(const char* src, const char* dst,
+                                  const Base::Matrix4D& mat, float cellSize)
+{
+    Base::FileInfo fi(src);
+    if (!fi.exists() || !fi.isFile())
+        throw Base::FileException("File does not exist", src);
+    if (!fi.hasExtension("stl") && !fi.hasExtension("ast"))
+        throw Base::FileException("File extension not supported for streaming", src);
+
+    Base::FileInfo fo(dst);
+    MeshCore::MeshIO::Format format = MeshCore::MeshOutput::GetFormat(dst);
+    if (format != MeshCore::MeshIO::BSTL && format != MeshCore::MeshIO::ASTL &&
+        format != MeshCore::MeshIO::OBJ)
+        throw Base::FileException("File extension not supported for streaming", dst);
+
+    Base::ifstream in(fi, std::ios::in | std::ios::binary);
+    Base::ofstream out(fo, std::ios::out | std::ios::binary);
+    if (!in || !out)
+        throw Base::FileException("Cannot open file", !in ? src : dst);
+
+    std::unique_ptr<MeshCore::MeshStreamReader> reader(MeshCore::MeshStreamReader::CreateSTLReader(in));
+    std::unique_ptr<MeshCore::MeshStreamWriter> writer;
+    if (format == MeshCore::MeshIO::BSTL)
+        writer.reset(new MeshCore::MeshStreamBinarySTLWriter(out));
+    else if (format == MeshCore::MeshIO::ASTL)
+        writer.reset(new MeshCore::MeshStreamAsciiSTLWriter(out));
+    else
+        writer.reset(new MeshCore::MeshStreamOBJWriter(out));
+
+    MeshCore::MeshStreamTransform transform(mat);
+    MeshCore::MeshStreamClustering clustering(cellSize);
+
+    MeshCore::MeshStreamPipeline pipeline(*reader, *writer);
+    if (mat != Base::Matrix4D())
+        pipeline.AddFilter(&transform);
+    if (cellSize > 0.0f)
+        pipeline.AddFilter(&clustering);
+
+    if (!pipeline.Run())
+        throw Base::FileException("Failed to convert file", src);
+    return pipeline.CountFacetsWritten();
+}
+
 void MeshObject::addSegment(const Segment& s)
 {
     addSegment(s.getIndices());
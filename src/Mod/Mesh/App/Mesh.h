@@ -217,6 +217,7 @@ public:
     void setPoint(unsigned long, const Base::Vector3d& v);
     void smooth(int iterations, float d_max);
     void decimate(float fTolerance, float fReduction);
+    void decimate(int targetSize, float fTolerance, float fFeatureAngle, int parts = 0);
     Base::Vector3d getPointNormal(unsigned long) const;
     std::vector<Base::Vector3d> getPointNormals() const;
     void crossSections(const std::vector<TPlane>&, std::vector<TPolylines> &sections,
@@ -313,6 +314,14 @@ public:
     static MeshObject* createTorus(float, float, int);
     static MeshObject* createCube(float, float, float);
     static MeshObject* createCube(float, float, float, float);
+    /** Converts the STL file \a src into \a dst without loading it into memory.
+     * The facets are transformed with \a mat and, if \a cellSize is positive,
+     * decimated by vertex clustering. The output format is decided by the
+     * extension of \a dst and must be STL, ASCII STL or OBJ.
+     * Returns the number of written facets.
+     */
+    static unsigned long convert(const char* src, const char* dst,
+        const Base::Matrix4D& mat, float cellSize = 0.0f);
     //@}
 
 public:
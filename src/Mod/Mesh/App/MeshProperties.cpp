@@ -157,9 +157,9 @@ void PropertyNormalList::SaveDocFile (Base::Writer &writer) const
     Base::OutputStream str(writer.Stream());
     uint32_t uCt = (uint32_t)getSize();
     str << uCt;
-    for (std::vector<Base::Vector3f>::const_iterator it = _lValueList.begin(); it != _lValueList.end(); ++it) {
-        str << it->x << it->y << it->z;
-    }
+    // a normal consists of three contiguous coordinates
+    static_assert(sizeof(Base::Vector3f) == 3 * sizeof(float), "Unexpected vector layout");
+    str.write(_lValueList.empty() ? 0 : &_lValueList[0].x, 3 * _lValueList.size());
 }
 
 void PropertyNormalList::RestoreDocFile(Base::Reader &reader)
@@ -168,9 +168,7 @@ void PropertyNormalList::RestoreDocFile(Base::Reader &reader)
     uint32_t uCt=0;
     str >> uCt;
     std::vector<Base::Vector3f> values(uCt);
-    for (std::vector<Base::Vector3f>::iterator it = values.begin(); it != values.end(); ++it) {
-        str >> it->x >> it->y >> it->z;
-    }
+    str.read(values.empty() ? 0 : &values[0].x, 3 * values.size());
     setValues(values);
 }
 
@@ -360,11 +358,9 @@ void PropertyCurvatureList::SaveDocFile (Base::Writer &writer) const
     Base::OutputStream str(writer.Stream());
     uint32_t uCt = (uint32_t)getSize();
     str << uCt;
-    for (std::vector<CurvatureInfo>::const_iterator it = _lValueList.begin(); it != _lValueList.end(); ++it) {
-        str << it->fMaxCurvature << it->fMinCurvature;
-        str << it->cMaxCurvDir.x << it->cMaxCurvDir.y << it->cMaxCurvDir.z;
-        str << it->cMinCurvDir.x << it->cMinCurvDir.y << it->cMinCurvDir.z;
-    }
+    // the curvature info consists of eight contiguous floats in file order
+    static_assert(sizeof(CurvatureInfo) == 8 * sizeof(float), "Unexpected curvature layout");
+    str.write(_lValueList.empty() ? 0 : &_lValueList[0].fMaxCurvature, 8 * _lValueList.size());
 }
 
 void PropertyCurvatureList::RestoreDocFile(Base::Reader &reader)
@@ -373,11 +369,7 @@ void PropertyCurvatureList::RestoreDocFile(Base::Reader &reader)
     uint32_t uCt=0;
     str >> uCt;
     std::vector<CurvatureInfo> values(uCt);
-    for (std::vector<CurvatureInfo>::iterator it = values.begin(); it != values.end(); ++it) {
-        str >> it->fMaxCurvature >> it->fMinCurvature;
-        str >> it->cMaxCurvDir.x >> it->cMaxCurvDir.y >> it->cMaxCurvDir.z;
-        str >> it->cMinCurvDir.x >> it->cMinCurvDir.y >> it->cMinCurvDir.z;
-    }
+    str.read(values.empty() ? 0 : &values[0].fMaxCurvature, 8 * values.size());
 
     setValues(values);
 }
@@ -455,9 +447,31 @@ void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
     hasSetValue();
 }
 
+/**
+ * Makes sure that the mesh object is not shared with a copy of this property
+ * before it gets modified. If \a copy is false the caller replaces the content
+ * anyway, so only the placement is kept.
+ */
+void PropertyMeshKernel::detachMesh(bool copy)
+{
+    if (_meshObject.getRefCount() > 1) {
+        if (copy) {
+            _meshObject = new MeshObject(*_meshObject);
+        }
+        else {
+            Base::Matrix4D mat = _meshObject->getTransform();
+            _meshObject = new MeshObject();
+            _meshObject->setTransform(mat);
+        }
+        if (meshPyObject)
+            meshPyObject->_pcTwinPointer = static_cast<MeshObject*>(_meshObject);
+    }
+}
+
 void PropertyMeshKernel::setValue(const MeshObject& mesh)
 {
     aboutToSetValue();
+    detachMesh(false);
     *_meshObject = mesh;
     hasSetValue();
 }
@@ -465,6 +479,7 @@ void PropertyMeshKernel::setValue(const MeshObject& mesh)
 void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    detachMesh(false);
     _meshObject->setKernel(mesh);
     hasSetValue();
 }
@@ -472,6 +487,7 @@ void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 {
     aboutToSetValue();
+    detachMesh(true);
     _meshObject->swap(mesh);
     hasSetValue();
 }
@@ -479,6 +495,7 @@ void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 void PropertyMeshKernel::swapMesh(MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    detachMesh(true);
     _meshObject->swap(mesh);
     hasSetValue();
 }
@@ -505,8 +522,9 @@ Base::BoundBox3d PropertyMeshKernel::getBoundingBox() const
 
 unsigned int PropertyMeshKernel::getMemSize (void) const
 {
+    // a mesh shared with copies of this property is accounted to each of them in parts
     unsigned int size = 0;
-    size += _meshObject->getMemSize();
+    size += _meshObject->getMemSize() / std::max(_meshObject.getRefCount(), 1);
     
     return size;
 }
@@ -514,6 +532,7 @@ unsigned int PropertyMeshKernel::getMemSize (void) const
 MeshObject* PropertyMeshKernel::startEditing()
 {
     aboutToSetValue();
+    detachMesh(true);
     return (MeshObject*)_meshObject;
 }
 
@@ -522,9 +541,18 @@ void PropertyMeshKernel::finishEditing()
     hasSetValue();
 }
 
+void PropertyMeshKernel::setTransform(const Base::Matrix4D &rclTrf)
+{
+    if (_meshObject->getTransform() != rclTrf) {
+        detachMesh(true);
+        _meshObject->setTransform(rclTrf);
+    }
+}
+
 void PropertyMeshKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
     aboutToSetValue();
+    detachMesh(true);
     _meshObject->transformGeometry(rclMat);
     hasSetValue();
 }
@@ -532,6 +560,7 @@ void PropertyMeshKernel::transformGeometry(const Base::Matrix4D &rclMat)
 void PropertyMeshKernel::setPointIndices(const std::vector<std::pair<unsigned long, Base::Vector3f> >& inds)
 {
     aboutToSetValue();
+    detachMesh(true);
     MeshCore::MeshKernel& kernel = _meshObject->getKernel();
     for (std::vector<std::pair<unsigned long, Base::Vector3f> >::const_iterator it = inds.begin(); it != inds.end(); ++it)
         kernel.SetPoint(it->first, it->second);
@@ -603,6 +632,7 @@ void PropertyMeshKernel::Restore(Base::XMLReader &reader)
         kernel.Adopt(points, facets);
 
         aboutToSetValue();
+        detachMesh(false);
         _meshObject->getKernel().Adopt(points, facets);
         hasSetValue();
     } 
@@ -617,26 +647,53 @@ void PropertyMeshKernel::SaveDocFile (Base::Writer &writer) const
     _meshObject->save(writer.Stream());
 }
 
+bool PropertyMeshKernel::allowConcurrentSave (const Base::Writer &) const
+{
+    return true;
+}
+
 void PropertyMeshKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    detachMesh(false);
     _meshObject->load(reader);
     hasSetValue();
 }
 
+bool PropertyMeshKernel::allowConcurrentRestore (const Base::Reader &) const
+{
+    return true;
+}
+
+std::function<void()> PropertyMeshKernel::stageDocFile(Base::Reader &reader)
+{
+    // Note: Only the kernel is swapped in to keep the placement of the mesh
+    std::shared_ptr<MeshObject> mesh = std::make_shared<MeshObject>();
+    mesh->load(reader);
+
+    return [this, mesh]() {
+        aboutToSetValue();
+        detachMesh(false);
+        _meshObject->swap(mesh->getKernel());
+        hasSetValue();
+    };
+}
+
 App::Property *PropertyMeshKernel::Copy(void) const
 {
-    // Note: Copy the content, do NOT reference the same mesh object
+    // Note: Reference the same mesh object, it is copied on modification
     PropertyMeshKernel *prop = new PropertyMeshKernel();
-    *(prop->_meshObject) = *(this->_meshObject);
+    prop->_meshObject = this->_meshObject;
     return prop;
 }
 
 void PropertyMeshKernel::Paste(const App::Property &from)
 {
-    // Note: Copy the content, do NOT reference the same mesh object
+    // Note: Reference the same mesh object, it is copied on modification
     aboutToSetValue();
     const PropertyMeshKernel& prop = dynamic_cast<const PropertyMeshKernel&>(from);
-    *(this->_meshObject) = *(prop._meshObject);
+    this->_meshObject = prop._meshObject;
+    if (meshPyObject)
+        meshPyObject->_pcTwinPointer = static_cast<MeshObject*>(_meshObject);
     hasSetValue();
 }
@@ -213,6 +213,8 @@ public:
     //@{
     MeshObject* startEditing();
     void finishEditing();
+    /// Sets the transformation of the mesh without notifying the container
+    void setTransform(const Base::Matrix4D &rclTrf);
     /// Transform the real mesh data
     void transformGeometry(const Base::Matrix4D &rclMat);
     void setPointIndices( const std::vector<std::pair<unsigned long, Base::Vector3f> >& );
@@ -244,11 +246,20 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool allowConcurrentSave (const Base::Writer &writer) const;
+    bool allowConcurrentRestore (const Base::Reader &reader) const;
+    std::function<void()> stageDocFile(Base::Reader &reader);
 
+    /** The copy references the same mesh object until one of both gets
+     * modified. This keeps the undo stack small for large meshes.
+     */
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
     //@}
 
+private:
+    void detachMesh(bool copy);
+
 private:
     Base::Reference<MeshObject> _meshObject;
     MeshPy* meshPyObject;
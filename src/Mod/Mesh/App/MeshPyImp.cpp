@@ -1723,10 +1723,32 @@ PyObject*  MeshPy::smooth(PyObject *args, PyObject *kwds)
     Py_Return;
 }
 
-PyObject*  MeshPy::decimate(PyObject *args)
+PyObject*  MeshPy::decimate(PyObject *args, PyObject *kwds)
 {
+    // The target size form is only selected by the targetSize keyword, so
+    // that positional calls keep their meaning of tolerance and reduction.
+    if (kwds && PyDict_GetItemString(kwds, "targetSize")) {
+        if (PyTuple_Size(args) > 0) {
+            PyErr_SetString(PyExc_TypeError, "decimate(targetSize=...) only takes keyword arguments");
+            return NULL;
+        }
+        int targetSize = -1, parts = 0;
+        float fTol = 0.0f, fAngle = 0.0f;
+        static char* keywords_decimate[] = {"targetSize","tolerance","featureAngle","parts",NULL};
+        if (!PyArg_ParseTupleAndKeywords(args, kwds, "i|ffi",keywords_decimate,
+                                         &targetSize, &fTol, &fAngle, &parts))
+            return NULL;
+
+        PY_TRY {
+            getMeshObjectPtr()->decimate(targetSize, fTol, fAngle, parts);
+        } PY_CATCH;
+
+        Py_Return;
+    }
+
     float fTol, fRed;
-    if (!PyArg_ParseTuple(args, "ff", &fTol,&fRed))
+    static char* keywords_reduction[] = {"tolerance","reduction",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ff",keywords_reduction, &fTol,&fRed))
         return NULL;
 
     PY_TRY {
@@ -76,6 +76,86 @@ class MeshGeoTestCases(unittest.TestCase):
 		res=f1.intersect(f2)
 		self.failUnless(len(res) == 0)
 
+	def testAreaVolumeTransform(self):
+		box = Mesh.createBox(1.0, 2.0, 3.0)
+		self.assertAlmostEqual(box.Area, 22.0, 4)
+		self.assertAlmostEqual(box.Volume, 6.0, 4)
+		mat = FreeCAD.Matrix()
+		mat.move(FreeCAD.Vector(1.0, 2.0, 3.0))
+		mat.scale(2.0, 2.0, 2.0)
+		box.transform(mat)
+		self.assertAlmostEqual(box.Area, 88.0, 4)
+		self.assertAlmostEqual(box.Volume, 48.0, 4)
+		bb = box.BoundBox
+		self.assertAlmostEqual(bb.XLength, 2.0, 4)
+		self.assertAlmostEqual(bb.YLength, 4.0, 4)
+		self.assertAlmostEqual(bb.ZLength, 6.0, 4)
+
+	def testDecimateTargetSize(self):
+		sphere = Mesh.createSphere(10.0, 50)
+		count = sphere.CountFacets
+		sphere.decimate(targetSize=count // 2)
+		self.failUnless(sphere.CountFacets <= count // 2 + count // 20)
+		self.failUnless(sphere.isSolid())
+		self.failIf(sphere.hasNonManifolds())
+
+	def testDecimatePositional(self):
+		# positional arguments are always the tolerance and the reduction,
+		# even if the tolerance is an integer
+		counts = []
+		for args, kwds in [((1.0, 0.5), {}), ((1, 0.5), {}), ((), {"tolerance":1.0, "reduction":0.5})]:
+			sphere = Mesh.createSphere(10.0, 50)
+			count = sphere.CountFacets
+			sphere.decimate(*args, **kwds)
+			counts.append(sphere.CountFacets)
+		self.failUnless(counts[0] < count)
+		self.assertEqual(counts[1], counts[0])
+		self.assertEqual(counts[2], counts[0])
+		# the target size is keyword only
+		self.assertRaises(TypeError, sphere.decimate, 100)
+		self.assertRaises(TypeError, sphere.decimate, 1.0, targetSize=100)
+
+	def testDecimateParts(self):
+		# force several slabs to run the split, lock and merge steps
+		sphere = Mesh.createSphere(10.0, 100)
+		count = sphere.CountFacets
+		volume = sphere.Volume
+		sphere.decimate(targetSize=count // 2, parts=4)
+		self.failUnless(sphere.CountFacets < count)
+		self.failUnless(sphere.CountFacets <= count // 2 + count // 10)
+		self.failUnless(sphere.isSolid())
+		self.failIf(sphere.hasNonManifolds())
+		self.failIf(sphere.hasInvalidPoints())
+		self.assertAlmostEqual(sphere.Volume / volume, 1.0, 1)
+		# the slabs must be stitched, i.e. no open edges remain
+		self.failUnless(len(sphere.getSeparateComponents()) == 1)
+
+	def testDecimateFeatureEdges(self):
+		box = Mesh.createBox(1.0, 1.0, 1.0, 0.1)
+		count = box.CountFacets
+		bb = box.BoundBox
+		box.decimate(targetSize=12, featureAngle=0.5)
+		self.failUnless(box.CountFacets < count)
+		# the feature edges are kept
+		self.assertAlmostEqual(box.BoundBox.DiagonalLength, bb.DiagonalLength, 5)
+		self.assertAlmostEqual(box.Volume, 1.0, 3)
+
+	def testSelfIntersection(self):
+		sphere = Mesh.createSphere(1.0, 50)
+		self.failIf(sphere.hasSelfIntersections())
+		self.failUnless(len(sphere.getSelfIntersections()) == 0)
+		other = Mesh.createSphere(1.0, 50)
+		other.translate(1.0, 0.3, 0.2)
+		sphere.addMesh(other)
+		self.failUnless(sphere.hasSelfIntersections())
+		res = sphere.getSelfIntersections()
+		self.failUnless(len(res) > 0)
+		count = sphere.CountFacets // 2
+		for i in res:
+			# each pair consists of a facet of either sphere
+			self.failUnless(i[0] < count <= i[1])
+		self.failUnless(len(set([(i[0], i[1]) for i in res])) == len(res))
+
 class PivyTestCases(unittest.TestCase):
 	def setUp(self):
 		# set up a planar face with 2 triangles
@@ -125,6 +205,53 @@ class PivyTestCases(unittest.TestCase):
 		self.failUnless(pc.getTriangleCount() == 2)
 		#self.failUnless(pc.getPointCount() == 6)
 
+	def testRayPickLargeFaceSet(self):
+		# large face sets are picked through a bounding volume hierarchy, which
+		# must give the same points and details as picking all triangles
+		if not FreeCAD.GuiUp:
+			return
+		from pivy import coin; import MeshGui
+		n = 64 # 8192 triangles, enough to build the hierarchy
+		points = []
+		for y in range(n+1):
+			for x in range(n+1):
+				points.append((x, y, 0.1*((3*x+5*y)%7)))
+		indices = []
+		for y in range(n):
+			for x in range(n):
+				a = y*(n+1)+x
+				indices += [a, a+1, a+n+2, -1, a, a+n+2, a+n+1, -1]
+
+		def pick(faceSet):
+			root = coin.SoSeparator()
+			coords = coin.SoCoordinate3()
+			coords.point.setValues(0, len(points), points)
+			faceSet.coordIndex.setValues(0, len(indices), indices)
+			root.addChild(coords)
+			root.addChild(faceSet)
+			result = []
+			for x, y in ((10.3, 20.6), (31.7, 5.2), (63.9, 63.1), (0.2, 0.1)):
+				rp = coin.SoRayPickAction(coin.SbViewportRegion(100, 100))
+				rp.setRay(coin.SbVec3f(x, y, 10), coin.SbVec3f(0, 0, -1))
+				rp.apply(root)
+				pp = rp.getPickedPoint()
+				self.failUnless(pp != None)
+				det = pp.getDetail()
+				self.failUnless(det.getTypeId() == coin.SoFaceDetail.getClassTypeId())
+				det = coin.cast(det, "SoFaceDetail")
+				vertices = [det.getPoint(i).getCoordinateIndex() for i in range(det.getNumPoints())]
+				result.append((pp.getPoint().getValue(), det.getFaceIndex(), vertices))
+			return result
+
+		faceSet = coin.SoType.fromName("SoFCIndexedFaceSet").createInstance()
+		picked = pick(coin.cast(faceSet, "SoIndexedFaceSet"))
+		expected = pick(coin.SoIndexedFaceSet())
+		for (point, face, vertices), (point2, face2, vertices2) in zip(picked, expected):
+			for i in range(3):
+				self.assertAlmostEqual(point[i], point2[i], 5)
+			self.assertEqual(face, face2)
+			self.assertEqual(vertices, vertices2)
+
 	def tearDown(self):
 		#closing doc
 		FreeCAD.closeDocument("MeshTest")
@@ -225,3 +352,77 @@ class PolynomialFitCases(unittest.TestCase):
 
     def tearDown(self):
         pass
+
+class MeshIOTestCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(10.0, 50)
+        self.names = []
+
+    def roundTrip(self, ext):
+        name = tempfile.gettempdir() + os.sep + "meshio." + ext
+        self.names.append(name)
+        self.mesh.write(name)
+        other = Mesh.Mesh(name)
+        self.assertEqual(other.CountPoints, self.mesh.CountPoints)
+        self.assertEqual(other.CountFacets, self.mesh.CountFacets)
+        self.assertAlmostEqual(other.Area, self.mesh.Area, 2)
+        self.assertAlmostEqual(other.Volume, self.mesh.Volume, 2)
+        self.assertTrue(other.isSolid())
+
+    def testBinarySTL(self):
+        self.roundTrip("stl")
+
+    def testAsciiSTL(self):
+        self.roundTrip("ast")
+
+    def testPLY(self):
+        self.roundTrip("ply")
+
+    def testStreamConvert(self):
+        tmp = tempfile.gettempdir() + os.sep
+        src = tmp + "meshio_src.stl"
+        self.names += [src, tmp + "meshio_dst.ast", tmp + "meshio_dst.obj", tmp + "meshio_dst.stl"]
+        self.mesh.write(src)
+        count = self.mesh.CountFacets
+        self.assertEqual(Mesh.convert(src, tmp + "meshio_dst.ast"), count)
+        self.assertEqual(Mesh.convert(tmp + "meshio_dst.ast", tmp + "meshio_dst.obj"), count)
+        other = Mesh.Mesh(tmp + "meshio_dst.obj")
+        self.assertEqual(other.CountFacets, count)
+        self.assertAlmostEqual(other.Volume, self.mesh.Volume, 1)
+
+        mat = FreeCAD.Matrix()
+        mat.move(FreeCAD.Vector(5.0, 0.0, 0.0))
+        self.assertEqual(Mesh.convert(src, tmp + "meshio_dst.stl", mat), count)
+        other = Mesh.Mesh(tmp + "meshio_dst.stl")
+        self.assertAlmostEqual(other.BoundBox.Center.x, self.mesh.BoundBox.Center.x + 5.0, 2)
+
+        # decimation by vertex clustering
+        reduced = Mesh.convert(src, tmp + "meshio_dst.stl", FreeCAD.Matrix(), 2.0)
+        self.assertTrue(0 < reduced < count)
+        self.assertEqual(Mesh.Mesh(tmp + "meshio_dst.stl").CountFacets, reduced)
+
+    def testDocumentRoundTrip(self):
+        # the meshes are read concurrently and must keep their order and placement
+        name = tempfile.gettempdir() + os.sep + "MeshIO.FCStd"
+        self.names.append(name)
+        doc = FreeCAD.newDocument("MeshIO")
+        counts = []
+        for i in range(8):
+            feature = doc.addObject("Mesh::Feature", "Mesh%d" % i)
+            feature.Mesh = Mesh.createSphere(1.0 + i, 10 + 5 * i)
+            feature.Placement.Base = FreeCAD.Vector(10.0 * i, 0.0, 0.0)
+            counts.append(feature.Mesh.CountFacets)
+        doc.saveAs(name)
+        FreeCAD.closeDocument("MeshIO")
+
+        doc = FreeCAD.openDocument(name)
+        for i in range(8):
+            feature = doc.getObject("Mesh%d" % i)
+            self.assertEqual(feature.Mesh.CountFacets, counts[i])
+            self.assertAlmostEqual(feature.Mesh.BoundBox.Center.x, 10.0 * i, 2)
+        FreeCAD.closeDocument("MeshIO")
+
+    def tearDown(self):
+        for name in self.names:
+            if os.path.exists(name):
+                os.remove(name)
@@ -39,14 +39,20 @@
 # include <GL/glu.h>
 # include <GL/glext.h>
 # endif
+# include <Inventor/SoPrimitiveVertex.h>
 # include <Inventor/actions/SoGLRenderAction.h>
+# include <Inventor/actions/SoRayPickAction.h>
 # include <Inventor/bundles/SoMaterialBundle.h>
+# include <Inventor/bundles/SoTextureCoordinateBundle.h>
+# include <Inventor/details/SoFaceDetail.h>
+# include <Inventor/details/SoPointDetail.h>
 # include <Inventor/elements/SoCoordinateElement.h>
 # include <Inventor/elements/SoGLCoordinateElement.h>
 # include <Inventor/elements/SoGLLazyElement.h>
 # include <Inventor/elements/SoMaterialBindingElement.h>
 # include <Inventor/elements/SoNormalBindingElement.h>
 # include <Inventor/elements/SoProjectionMatrixElement.h>
+# include <Inventor/elements/SoTextureCoordinateBindingElement.h>
 # include <Inventor/elements/SoViewingMatrixElement.h>
 # include <Inventor/errors/SoDebugError.h>
 #endif
@@ -57,6 +63,7 @@
 #include <Gui/SoFCInteractiveElement.h>
 #include <Gui/SoFCSelectionAction.h>
 #include <Gui/GLBuffer.h>
+#include <Gui/SoFCTriangleBVH.h>
 #include "SoFCIndexedFaceSet.h"
 
 #define RENDER_GL_VAO
@@ -461,6 +468,11 @@ SoFCIndexedFaceSet::SoFCIndexedFaceSet()
     SO_NODE_ADD_FIELD(updateGLArray, (false));
     updateGLArray.setFieldType(SoField::EVENTOUT_FIELD);
     setName(SoFCIndexedFaceSet::getClassTypeId().getName());
+    bvh.reset(new Gui::SoFCTriangleBVH(&coordIndex));
+}
+
+SoFCIndexedFaceSet::~SoFCIndexedFaceSet()
+{
 }
 
 /**
@@ -913,6 +925,122 @@ void SoFCIndexedFaceSet::doAction(SoAction * action)
     inherited::doAction(action);
 }
 
+void SoFCIndexedFaceSet::rayPick(SoRayPickAction *action)
+{
+    if (!this->shouldRayPick(action))
+        return;
+
+    SoState * state = action->getState();
+    if (this->vertexProperty.getValue()) {
+        state->push();
+        this->vertexProperty.getValue()->doAction(action);
+    }
+
+    // for large meshes only the triangles near the pick ray are generated
+    bool useBVH = bvh->update(SoCoordinateElement::getInstance(state));
+    if (useBVH) {
+        std::vector<int> triangles;
+        this->computeObjectSpaceRay(action);
+        bvh->rayPick(action, triangles);
+        if (!triangles.empty())
+            generateTriangles(action, triangles);
+    }
+
+    if (this->vertexProperty.getValue()) {
+        state->pop();
+    }
+
+    if (!useBVH)
+        inherited::rayPick(action);
+}
+
+namespace {
+// SoMaterialBindingElement and SoNormalBindingElement name their bindings alike
+template <class BindingT>
+Gui::SoFCTriangleBVH::Binding toTriangleBinding(BindingT bind)
+{
+    switch (bind) {
+    case BindingT::PER_PART:
+        return Gui::SoFCTriangleBVH::PerPart;
+    case BindingT::PER_PART_INDEXED:
+        return Gui::SoFCTriangleBVH::PerPartIndexed;
+    case BindingT::PER_FACE:
+        return Gui::SoFCTriangleBVH::PerFace;
+    case BindingT::PER_FACE_INDEXED:
+        return Gui::SoFCTriangleBVH::PerFaceIndexed;
+    case BindingT::PER_VERTEX:
+        return Gui::SoFCTriangleBVH::PerVertex;
+    case BindingT::PER_VERTEX_INDEXED:
+        return Gui::SoFCTriangleBVH::PerVertexIndexed;
+    default:
+        return Gui::SoFCTriangleBVH::Overall;
+    }
+}
+}
+
+void SoFCIndexedFaceSet::generateTriangles(SoAction * action, const std::vector<int> &triangles)
+{
+    // Generates the given triangles with the bindings of SoIndexedFaceSet. As the
+    // mesh is a plain triangle list they can be computed from the triangle index.
+    SoState * state = action->getState();
+    const SoCoordinateElement * coords;
+    const SbVec3f * normals;
+    const int32_t * cindices;
+    int numindices;
+    const int32_t * nindices;
+    const int32_t * tindices;
+    const int32_t * mindices;
+    SbBool sendNormals = true;
+    SbBool normalCacheUsed;
+
+    this->getVertexData(state, coords, normals, cindices,
+                        nindices, tindices, mindices, numindices,
+                        sendNormals, normalCacheUsed);
+
+    SoMaterialBindingElement::Binding mbind = SoMaterialBindingElement::get(state);
+    SoNormalBindingElement::Binding nbind = SoNormalBindingElement::get(state);
+    if (!sendNormals || !normals)
+        nbind = SoNormalBindingElement::OVERALL;
+    else if (normalCacheUsed && nbind == SoNormalBindingElement::PER_VERTEX)
+        nbind = SoNormalBindingElement::PER_VERTEX_INDEXED;
+    else if (normalCacheUsed && nbind == SoNormalBindingElement::PER_FACE_INDEXED)
+        nbind = SoNormalBindingElement::PER_FACE;
+    if (nbind == SoNormalBindingElement::PER_VERTEX_INDEXED && !nindices)
+        nindices = cindices;
+    if (mbind == SoMaterialBindingElement::PER_VERTEX_INDEXED && !mindices)
+        mindices = cindices;
+
+    SoTextureCoordinateBundle tb(action, false, false);
+    bool doTextures = tb.needCoordinates();
+    bool texIndexed = SoTextureCoordinateBindingElement::get(state) !=
+                      SoTextureCoordinateBindingElement::PER_VERTEX;
+    if (doTextures && texIndexed && !tindices)
+        tindices = cindices;
+
+    Gui::SoFCTriangleBVH::TriangleData data;
+    data.coords = coords;
+    data.normals = normals;
+    data.cindices = cindices;
+    data.nindices = nindices;
+    data.tindices = texIndexed ? tindices : nullptr;
+    data.mindices = mindices;
+    data.mbind = toTriangleBinding(mbind);
+    data.nbind = toTriangleBinding(nbind);
+    data.tb = doTextures ? &tb : nullptr;
+    // every triangle is a part of its own
+    data.partIndex = nullptr;
+    data.numParts = 0;
+
+    SoFaceDetail faceDetail;
+    this->beginShape(action, TRIANGLES, &faceDetail);
+    Gui::SoFCTriangleBVH::generateTriangles(triangles, data, faceDetail,
+        [this](SoPrimitiveVertex *v) { this->shapeVertex(v); });
+    this->endShape();
+
+    if (normalCacheUsed)
+        this->readUnlockNormalCache();
+}
+
 void SoFCIndexedFaceSet::startSelection(SoAction * action)
 {
     Gui::SoGLSelectAction *doaction = static_cast<Gui::SoGLSelectAction*>(action);
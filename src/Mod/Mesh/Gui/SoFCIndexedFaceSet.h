@@ -28,10 +28,16 @@
 #include <Inventor/engines/SoSubEngine.h>
 #include <Inventor/fields/SoSFBool.h>
 #include <Inventor/fields/SoMFColor.h>
+#include <memory>
+#include <vector>
 
 class SoGLCoordinateElement;
 class SoTextureCoordinateBundle;
 
+namespace Gui {
+class SoFCTriangleBVH;
+}
+
 typedef unsigned int GLuint;
 typedef int GLint;
 typedef float GLfloat;
@@ -103,8 +109,9 @@ public:
 
 protected:
     // Force using the reference count mechanism.
-    virtual ~SoFCIndexedFaceSet() {}
+    virtual ~SoFCIndexedFaceSet();
     virtual void GLRender(SoGLRenderAction *action);
+    virtual void rayPick(SoRayPickAction *action);
     void drawFaces(SoGLRenderAction *action);
     void drawCoords(const SoGLCoordinateElement * const vertexlist,
                     const int32_t *vertexindices,
@@ -128,10 +135,13 @@ private:
     void renderVisibleFaces(const SbVec3f *);
 
     void generateGLArrays(SoGLRenderAction * action);
+    void generateTriangles(SoAction * action, const std::vector<int> &triangles);
 
 private:
     MeshRenderer render;
     GLuint *selectBuf;
+    // Speeds up picking of large meshes
+    std::unique_ptr<Gui::SoFCTriangleBVH> bvh;
 };
 
 } // namespace MeshGui
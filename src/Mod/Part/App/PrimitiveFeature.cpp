@@ -106,6 +106,14 @@ App::DocumentObjectExecReturn* Primitive::execute(void) {
     return Part::Feature::execute();
 }
 
+bool Primitive::allowConcurrentRecompute() const
+{
+    // A primitive is built from its own properties only. The attacher on the
+    // other hand reads the support objects and reports to the console, so
+    // attached primitives are recomputed on the main thread.
+    return MapMode.getValue() == Attacher::mmDeactivated && !Support.getValue();
+}
+
 namespace Part {
     PYTHON_TYPE_DEF(PrimitivePy, PartFeaturePy)
     PYTHON_TYPE_IMP(PrimitivePy, PartFeaturePy)
@@ -47,6 +47,8 @@ public:
     PyObject* getPyObject() override;
     //@}
 
+    bool allowConcurrentRecompute() const override;
+
 protected:
     void Restore(Base::XMLReader &reader) override;
     void onChanged (const App::Property* prop) override;
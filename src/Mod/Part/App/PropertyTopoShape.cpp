@@ -35,9 +35,13 @@
 # include <BRepBuilderAPI_Copy.hxx>
 # include <TopTools_HSequenceOfShape.hxx>
 # include <TopTools_MapOfShape.hxx>
+# include <TopLoc_Location.hxx>
 # include <TopoDS.hxx>
 # include <TopoDS_Iterator.hxx>
 # include <TopExp.hxx>
+# include <TopExp_Explorer.hxx>
+# include <BRep_Tool.hxx>
+# include <Poly_Triangulation.hxx>
 # include <Standard_Failure.hxx>
 # include <Standard_Version.hxx>
 # include <gp_GTrsf.hxx>
@@ -75,6 +79,7 @@ using namespace Part;
 TYPESYSTEM_SOURCE(Part::PropertyPartShape , App::PropertyComplexGeoData);
 
 PropertyPartShape::PropertyPartShape()
+  : _SaveShared(false)
 {
 }
 
@@ -241,20 +246,58 @@ void PropertyPartShape::getPaths(std::vector<App::ObjectIdentifier> &paths) cons
                     << App::ObjectIdentifier::Component::SimpleComponent(App::ObjectIdentifier::String("Volume")));
 }
 
+static bool hasTriangulation(const TopoDS_Shape& shape)
+{
+    TopExp_Explorer xp(shape, TopAbs_FACE);
+    if (!xp.More())
+        return false;
+    for (; xp.More(); xp.Next()) {
+        TopLoc_Location loc;
+        if (BRep_Tool::Triangulation(TopoDS::Face(xp.Current()), loc).IsNull())
+            return false;
+    }
+    return true;
+}
+
 void PropertyPartShape::Save (Base::Writer &writer) const
 {
+    _SaveShared = false;
     if(!writer.isForceXML()) {
         //See SaveDocFile(), RestoreDocFile()
-        if (writer.getMode("BinaryBrep")) {
-            writer.Stream() << writer.ind() << "<Part file=\""
-                            << writer.addFile("PartShape.bin", this)
-                            << "\"/>" << std::endl;
+        writer.Stream() << writer.ind() << "<Part file=\"";
+
+        // Optionally store identical shapes only once. The file holds the
+        // shape without its placement, which is written to the XML instead.
+        // Shapes that only differ by their placement share the file directly.
+        // The archive writer stores a file with the same content as an
+        // earlier one as a reference to it, see RestoreDocFile().
+        bool share = App::GetApplication().GetParameterGroupByPath
+            ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("ShareShapeFiles", false);
+        if (share && !_Shape.getShape().IsNull()) {
+            writer.Stream() << addSharedFile(writer) << "\" location=\"";
+            Base::Matrix4D mat = _Shape.getTransform();
+            for (int i = 0; i < 4; i++) {
+                for (int j = 0; j < 4; j++)
+                    writer.Stream() << (i || j ? " " : "") << mat[i][j];
+            }
         }
-        else {
-            writer.Stream() << writer.ind() << "<Part file=\""
-                            << writer.addFile("PartShape.brp", this)
-                            << "\"/>" << std::endl;
+        else if (writer.getMode("BinaryBrep"))
+            writer.Stream() << writer.addFile("PartShape.bin", this);
+        else
+            writer.Stream() << writer.addFile("PartShape.brp", this);
+        writer.Stream() << "\"";
+
+        // Optionally store the tessellation next to the shape, so that it
+        // doesn't need to be recomputed when the document is opened again.
+        // It is written by TopoShape::SaveDocFile().
+        bool saveMesh = App::GetApplication().GetParameterGroupByPath
+            ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("SaveTessellation", false);
+        if (saveMesh && hasTriangulation(_Shape.getShape())) {
+            writer.Stream() << " mesh=\""
+                            << writer.addFile("PartShape.tri", &_Shape)
+                            << "\"";
         }
+        writer.Stream() << "/>" << std::endl;
     }
 }
 
@@ -262,10 +305,29 @@ void PropertyPartShape::Restore(Base::XMLReader &reader)
 {
     reader.readElement("Part");
     std::string file (reader.getAttribute("file") );
+    _SharedRestore.clear();
 
     if (!file.empty()) {
-        // initiate a file read
-        reader.addFile(file.c_str(),this);
+        if (reader.hasAttribute("location")) {
+            // the file may be shared with other properties, see Save()
+            Base::Matrix4D mat;
+            mat.fromString(reader.getAttribute("location"));
+            PropertyPartShape* owner = dynamic_cast<PropertyPartShape*>
+                (reader.getFileObject(file.c_str()));
+            if (!owner) {
+                owner = this;
+                reader.addFile(file.c_str(),this);
+            }
+            owner->_SharedRestore.push_back(std::make_pair(this, mat));
+        }
+        else {
+            // initiate a file read
+            reader.addFile(file.c_str(),this);
+        }
+
+        // the tessellation is restored after the shape, see Save()
+        if (reader.hasAttribute("mesh"))
+            reader.addFile(reader.getAttribute("mesh"),&_Shape);
     }
 }
 
@@ -313,8 +375,36 @@ static Standard_Boolean  BRepTools_Write(const TopoDS_Shape& Sh, const Standard_
   return isGood;
 }
 
+std::string PropertyPartShape::addSharedFile(Base::Writer &writer) const
+{
+    // Shapes with the same TShape and orientation only differ by their
+    // placement. The shape data is only written later by SaveDocFile().
+    const TopoDS_Shape& shape = _Shape.getShape();
+    std::ostringstream key;
+    key << "PartShape:" << static_cast<const void*>(shape.TShape().operator->())
+        << ":" << static_cast<int>(shape.Orientation());
+
+    // only the property that has added the file writes it
+    std::size_t numFiles = writer.getFilenames().size();
+    std::string name = writer.addSharedFile(key.str().c_str(),
+        writer.getMode("BinaryBrep") ? "PartShape.bin" : "PartShape.brp", this);
+    _SaveShared = writer.getFilenames().size() > numFiles;
+    return name;
+}
+
 void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
 {
+    // a shared file is written without placement, see Save()
+    if (_SaveShared) {
+        TopoShape shape;
+        shape.setShape(_Shape.getShape().Located(TopLoc_Location()));
+        if (writer.getMode("BinaryBrep"))
+            shape.exportBinary(writer.Stream());
+        else
+            BRepTools_Write(shape.getShape(), writer.Stream());
+        return;
+    }
+
     // If the shape is empty we simply store nothing. The file size will be 0 which
     // can be checked when reading in the data.
     if (_Shape.getShape().IsNull())
@@ -382,13 +472,48 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
     }
 }
 
+bool PropertyPartShape::allowConcurrentSave (const Base::Writer &writer) const
+{
+    if (_SaveShared)
+        return true;
+    // The indirect way uses a single temporary file
+    if (writer.getMode("BinaryBrep"))
+        return true;
+    return App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
+}
+
+// The shape of an earlier shared file with the same content as the file
+// 'name'. The property owning that file has already restored it with its own
+// placement, see Save().
+static TopoDS_Shape getSharedShape(const PropertyPartShape *owner,
+                                   const std::string &file, const std::string &name)
+{
+    if (!owner) {
+        Base::Console().Error("Shared shape file '%s' referred by '%s' not found\n",
+                              file.c_str(), name.c_str());
+        return TopoDS_Shape();
+    }
+    return owner->getValue().Located(TopLoc_Location());
+}
+
 void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
 {
+    // a shared file may refer to an earlier one with the same content
+    if (!_SharedRestore.empty()) {
+        std::string file = reader.getSharedFileReference();
+        if (!file.empty()) {
+            auto owner = dynamic_cast<PropertyPartShape*>(reader.getFileObject(file.c_str()));
+            setRestoredValue(getSharedShape(owner, file, reader.getFileName()));
+            return;
+        }
+    }
+
     Base::FileInfo brep(reader.getFileName());
     if (brep.hasExtension("bin")) {
         TopoShape shape;
         shape.importBinary(reader);
-        setValue(shape);
+        setRestoredValue(shape.getShape());
     }
     else {
         bool direct = App::GetApplication().GetParameterGroupByPath
@@ -432,17 +557,76 @@ void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
 
             // delete the temp file
             fi.deleteFile();
-            setValue(shape);
+            setRestoredValue(shape);
         }
         else {
             BRep_Builder builder;
             TopoDS_Shape shape;
             BRepTools::Read(shape, reader, builder);
-            setValue(shape);
+            setRestoredValue(shape);
         }
     }
 }
 
+void PropertyPartShape::setRestoredValue(const TopoDS_Shape &shape)
+{
+    if (_SharedRestore.empty()) {
+        setValue(shape);
+        return;
+    }
+
+    // the shape of a shared file is without placement, see Restore()
+    std::vector<std::pair<PropertyPartShape*, Base::Matrix4D> > props;
+    props.swap(_SharedRestore);
+    for (const auto &it : props) {
+        TopoShape located(shape);
+        located.setTransform(it.second);
+        it.first->setValue(located);
+    }
+}
+
+bool PropertyPartShape::allowConcurrentRestore (const Base::Reader &reader) const
+{
+    // The indirect way uses a temporary file and reports errors of the object
+    Base::FileInfo brep(reader.getFileName());
+    if (brep.hasExtension("bin"))
+        return true;
+    return App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
+}
+
+std::function<void()> PropertyPartShape::stageDocFile(Base::Reader &reader)
+{
+    // The earlier file is applied before this one, so the shape is only
+    // looked up then
+    if (!_SharedRestore.empty()) {
+        std::string file = reader.getSharedFileReference();
+        if (!file.empty()) {
+            auto owner = dynamic_cast<PropertyPartShape*>(reader.getFileObject(file.c_str()));
+            std::string name = reader.getFileName();
+            return [this, owner, file, name]() {
+                setRestoredValue(getSharedShape(owner, file, name));
+            };
+        }
+    }
+
+    TopoShape shape;
+    Base::FileInfo brep(reader.getFileName());
+    if (brep.hasExtension("bin")) {
+        shape.importBinary(reader);
+    }
+    else {
+        BRep_Builder builder;
+        TopoDS_Shape sh;
+        BRepTools::Read(sh, reader, builder);
+        shape.setShape(sh);
+    }
+
+    return [this, shape]() {
+        setRestoredValue(shape.getShape());
+    };
+}
+
 // -------------------------------------------------------------------------
 
 TYPESYSTEM_SOURCE(Part::PropertyShapeHistory , App::PropertyLists);
@@ -82,6 +82,9 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool allowConcurrentSave (const Base::Writer &writer) const;
+    bool allowConcurrentRestore (const Base::Reader &reader) const;
+    std::function<void()> stageDocFile(Base::Reader &reader);
 
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
@@ -91,8 +94,16 @@ public:
     /// Get valid paths for this property; used by auto completer
     virtual void getPaths(std::vector<App::ObjectIdentifier> & paths) const;
 
+private:
+    std::string addSharedFile(Base::Writer &writer) const;
+    void setRestoredValue(const TopoDS_Shape &shape);
+
 private:
     TopoShape _Shape;
+    /// whether the file to write is shared with other properties, see Save()
+    mutable bool _SaveShared;
+    /// properties that restore their shape from the shared file of this one
+    std::vector<std::pair<PropertyPartShape*, Base::Matrix4D> > _SharedRestore;
 };
 
 struct PartExport ShapeHistory {
@@ -159,6 +159,11 @@
 # include <BinTools_ShapeSet.hxx>
 # include <Poly_Polygon3D.hxx>
 # include <Poly_PolygonOnTriangulation.hxx>
+# include <TColStd_Array1OfInteger.hxx>
+# include <TColStd_Array1OfReal.hxx>
+# include <TColStd_HArray1OfReal.hxx>
+# include <TColgp_Array1OfPnt2d.hxx>
+# include <cstring>
 # include <BRepBuilderAPI_Sewing.hxx>
 # include <ShapeFix_Shape.hxx>
 # include <XSControl_WorkSession.hxx>
@@ -190,6 +195,9 @@
 #include <Base/Exception.h>
 #include <Base/Tools.h>
 #include <Base/Console.h>
+#include <Base/Reader.h>
+#include <Base/Stream.h>
+#include <Base/Writer.h>
 #include <App/Material.h>
 
 #include "PartPyCXX.h"
@@ -819,6 +827,300 @@ void TopoShape::importBinary(std::istream& str)
     }
 }
 
+// Identifies the binary format of exportTriangulation()
+static const uint32_t TriangulationMagic = 0x52544346; // "FCTR"
+static const uint32_t TriangulationVersion = 1;
+// Sanity limit of the nodes or triangles of a single face, which guards
+// against huge allocations when reading a corrupt file
+static const int32_t TriangulationMaxSize = 1 << 26;
+
+// Fingerprint of the topology and vertex positions of a shape. It makes sure
+// that a triangulation written by exportTriangulation() is only attached to
+// the very same shape again. The points are compared in single precision to
+// be robust against the round-off of the ASCII BRep format.
+static uint64_t triangulationFingerprint(const TopoDS_Shape& shape,
+                                         const TopTools_IndexedMapOfShape& faceMap,
+                                         const TopTools_IndexedMapOfShape& edgeMap)
+{
+    TopTools_IndexedMapOfShape vertexMap;
+    TopExp::MapShapes(shape, TopAbs_VERTEX, vertexMap);
+
+    // FNV-1a over the values, independent of the byte order
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](uint32_t value) {
+        for (int i=0; i<4; i++) {
+            hash ^= (value >> (8*i)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    add(faceMap.Extent());
+    add(edgeMap.Extent());
+    add(vertexMap.Extent());
+    for (int i=1; i<=vertexMap.Extent(); i++) {
+        gp_Pnt pnt = BRep_Tool::Pnt(TopoDS::Vertex(vertexMap(i)));
+        float xyz[3] = {(float)pnt.X(), (float)pnt.Y(), (float)pnt.Z()};
+        for (float v : xyz) {
+            uint32_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            add(bits);
+        }
+    }
+    return hash;
+}
+
+static void writePolygonOnTriangulation(Base::OutputStream& str,
+                                        const Handle(Poly_PolygonOnTriangulation)& poly)
+{
+    const TColStd_Array1OfInteger& nodes = poly->Nodes();
+    str << (int32_t)nodes.Length() << (double)poly->Deflection();
+    for (int i=nodes.Lower(); i<=nodes.Upper(); i++)
+        str << (int32_t)nodes(i);
+    bool hasParameters = poly->HasParameters();
+    str << hasParameters;
+    if (hasParameters) {
+        const TColStd_Array1OfReal& params = poly->Parameters()->Array1();
+        for (int i=params.Lower(); i<=params.Upper(); i++)
+            str << (double)params(i);
+    }
+}
+
+static Handle(Poly_PolygonOnTriangulation) readPolygonOnTriangulation(Base::InputStream& str,
+                                                                      int32_t nbMeshNodes)
+{
+    Handle(Poly_PolygonOnTriangulation) poly;
+    int32_t nbNodes = 0;
+    double deflection = 0;
+    str >> nbNodes >> deflection;
+    if (!str || nbNodes < 1 || nbNodes > nbMeshNodes)
+        return poly;
+    TColStd_Array1OfInteger nodes(1, nbNodes);
+    for (int i=1; i<=nbNodes; i++) {
+        int32_t node = 0;
+        str >> node;
+        if (node < 1 || node > nbMeshNodes)
+            return poly;
+        nodes(i) = node;
+    }
+    bool hasParameters = false;
+    str >> hasParameters;
+    if (hasParameters) {
+        TColStd_Array1OfReal params(1, nbNodes);
+        for (int i=1; i<=nbNodes; i++)
+            str >> params(i);
+        poly = new Poly_PolygonOnTriangulation(nodes, params);
+    }
+    else {
+        poly = new Poly_PolygonOnTriangulation(nodes);
+    }
+    poly->Deflection(deflection);
+    if (!str)
+        poly.Nullify();
+    return poly;
+}
+
+bool TopoShape::exportTriangulation(std::ostream& out) const
+{
+    if (this->_Shape.IsNull())
+        return false;
+
+    TopTools_IndexedMapOfShape faceMap, edgeMap;
+    TopExp::MapShapes(this->_Shape, TopAbs_FACE, faceMap);
+    TopExp::MapShapes(this->_Shape, TopAbs_EDGE, edgeMap);
+    if (faceMap.IsEmpty())
+        return false;
+
+    // only a complete triangulation is of any use
+    for (int i=1; i<=faceMap.Extent(); i++) {
+        TopLoc_Location loc;
+        if (BRep_Tool::Triangulation(TopoDS::Face(faceMap(i)), loc).IsNull())
+            return false;
+    }
+
+    Base::OutputStream str(out);
+    str << TriangulationMagic << TriangulationVersion
+        << triangulationFingerprint(this->_Shape, faceMap, edgeMap)
+        << (int32_t)faceMap.Extent();
+
+    for (int i=1; i<=faceMap.Extent(); i++) {
+        const TopoDS_Face& face = TopoDS::Face(faceMap(i));
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(face, loc);
+
+        const TColgp_Array1OfPnt& nodes = mesh->Nodes();
+        const Poly_Array1OfTriangle& triangles = mesh->Triangles();
+        bool hasUV = mesh->HasUVNodes();
+        str << (int32_t)mesh->NbNodes() << (int32_t)mesh->NbTriangles()
+            << hasUV << (double)mesh->Deflection();
+        for (int j=nodes.Lower(); j<=nodes.Upper(); j++)
+            str << nodes(j).X() << nodes(j).Y() << nodes(j).Z();
+        if (hasUV) {
+            const TColgp_Array1OfPnt2d& uvNodes = mesh->UVNodes();
+            for (int j=uvNodes.Lower(); j<=uvNodes.Upper(); j++)
+                str << uvNodes(j).X() << uvNodes(j).Y();
+        }
+        for (int j=triangles.Lower(); j<=triangles.Upper(); j++) {
+            Standard_Integer n1, n2, n3;
+            triangles(j).Get(n1, n2, n3);
+            str << (int32_t)n1 << (int32_t)n2 << (int32_t)n3;
+        }
+
+        // the polygons of the edges on this face, seam edges have two of them
+        struct EdgePolygons {
+            int32_t edge;
+            Handle(Poly_PolygonOnTriangulation) poly1, poly2;
+        };
+        std::vector<EdgePolygons> polygons;
+        TopTools_IndexedMapOfShape faceEdges;
+        TopExp::MapShapes(face, TopAbs_EDGE, faceEdges);
+        for (int j=1; j<=faceEdges.Extent(); j++) {
+            const TopoDS_Edge& edge = TopoDS::Edge(faceEdges(j));
+            EdgePolygons polys;
+            polys.edge = edgeMap.FindIndex(edge);
+            polys.poly1 = BRep_Tool::PolygonOnTriangulation(
+                    TopoDS::Edge(edge.Oriented(TopAbs_FORWARD)), mesh, loc);
+            if (polys.edge == 0 || polys.poly1.IsNull())
+                continue;
+            if (BRep_Tool::IsClosed(edge, mesh, loc))
+                polys.poly2 = BRep_Tool::PolygonOnTriangulation(
+                        TopoDS::Edge(edge.Oriented(TopAbs_REVERSED)), mesh, loc);
+            polygons.push_back(polys);
+        }
+        str << (int32_t)polygons.size();
+        for (const auto& polys : polygons) {
+            bool seam = !polys.poly2.IsNull();
+            str << polys.edge << seam;
+            writePolygonOnTriangulation(str, polys.poly1);
+            if (seam)
+                writePolygonOnTriangulation(str, polys.poly2);
+        }
+    }
+
+    return out.good();
+}
+
+bool TopoShape::importTriangulation(std::istream& in)
+{
+    if (this->_Shape.IsNull())
+        return false;
+
+    TopTools_IndexedMapOfShape faceMap, edgeMap;
+    TopExp::MapShapes(this->_Shape, TopAbs_FACE, faceMap);
+    TopExp::MapShapes(this->_Shape, TopAbs_EDGE, edgeMap);
+
+    Base::InputStream str(in);
+    uint32_t magic = 0, version = 0;
+    str >> magic >> version;
+    if (!str || magic != TriangulationMagic || version != TriangulationVersion)
+        return false;
+    uint64_t fingerprint = 0;
+    int32_t numFaces = 0;
+    str >> fingerprint >> numFaces;
+    if (!str || numFaces != faceMap.Extent() ||
+        fingerprint != triangulationFingerprint(this->_Shape, faceMap, edgeMap))
+        return false;
+
+    // Read in everything first and only attach it to the shape if complete
+    struct EdgePolygons {
+        int32_t edge;
+        int32_t face;
+        Handle(Poly_PolygonOnTriangulation) poly1, poly2;
+    };
+    std::vector<Handle(Poly_Triangulation)> meshes(numFaces);
+    std::vector<EdgePolygons> polygons;
+    for (int32_t i=0; i<numFaces; i++) {
+        int32_t nbNodes = 0, nbTriangles = 0;
+        bool hasUV = false;
+        double deflection = 0;
+        str >> nbNodes >> nbTriangles >> hasUV >> deflection;
+        if (!str || nbNodes < 3 || nbTriangles < 1 ||
+            nbNodes > TriangulationMaxSize || nbTriangles > TriangulationMaxSize)
+            return false;
+
+        // The counts are not trusted, so the data is read into buffers
+        // that only grow with what has actually been read
+        const int32_t chunk = 4096;
+        std::vector<gp_Pnt> nodeBuffer;
+        nodeBuffer.reserve(std::min(nbNodes, chunk));
+        for (int32_t j=0; j<nbNodes && str; j++) {
+            double x = 0, y = 0, z = 0;
+            str >> x >> y >> z;
+            nodeBuffer.emplace_back(x, y, z);
+        }
+        std::vector<gp_Pnt2d> uvBuffer;
+        if (hasUV) {
+            uvBuffer.reserve(std::min(nbNodes, chunk));
+            for (int32_t j=0; j<nbNodes && str; j++) {
+                double u = 0, v = 0;
+                str >> u >> v;
+                uvBuffer.emplace_back(u, v);
+            }
+        }
+        std::vector<Poly_Triangle> triangleBuffer;
+        triangleBuffer.reserve(std::min(nbTriangles, chunk));
+        for (int32_t j=0; j<nbTriangles && str; j++) {
+            int32_t n1 = 0, n2 = 0, n3 = 0;
+            str >> n1 >> n2 >> n3;
+            if (n1 < 1 || n1 > nbNodes || n2 < 1 || n2 > nbNodes || n3 < 1 || n3 > nbNodes)
+                return false;
+            triangleBuffer.emplace_back(n1, n2, n3);
+        }
+        if (!str)
+            return false;
+
+        Handle(Poly_Triangulation) mesh = new Poly_Triangulation(nbNodes, nbTriangles, hasUV);
+        TColgp_Array1OfPnt& nodes = mesh->ChangeNodes();
+        for (int32_t j=0; j<nbNodes; j++)
+            nodes(nodes.Lower() + j) = nodeBuffer[j];
+        if (hasUV) {
+            TColgp_Array1OfPnt2d& uvNodes = mesh->ChangeUVNodes();
+            for (int32_t j=0; j<nbNodes; j++)
+                uvNodes(uvNodes.Lower() + j) = uvBuffer[j];
+        }
+        Poly_Array1OfTriangle& triangles = mesh->ChangeTriangles();
+        for (int32_t j=0; j<nbTriangles; j++)
+            triangles(triangles.Lower() + j) = triangleBuffer[j];
+        mesh->Deflection(deflection);
+        meshes[i] = mesh;
+
+        int32_t numPolygons = 0;
+        str >> numPolygons;
+        if (!str || numPolygons < 0)
+            return false;
+        for (int32_t j=0; j<numPolygons; j++) {
+            EdgePolygons polys;
+            bool seam = false;
+            polys.face = i + 1;
+            str >> polys.edge >> seam;
+            if (!str || polys.edge < 1 || polys.edge > edgeMap.Extent())
+                return false;
+            polys.poly1 = readPolygonOnTriangulation(str, nbNodes);
+            if (polys.poly1.IsNull())
+                return false;
+            if (seam) {
+                polys.poly2 = readPolygonOnTriangulation(str, nbNodes);
+                if (polys.poly2.IsNull())
+                    return false;
+            }
+            polygons.push_back(polys);
+        }
+    }
+    if (!str)
+        return false;
+
+    BRep_Builder builder;
+    for (int32_t i=0; i<numFaces; i++)
+        builder.UpdateFace(TopoDS::Face(faceMap(i+1)), meshes[i]);
+    for (const auto& polys : polygons) {
+        const TopoDS_Edge& edge = TopoDS::Edge(edgeMap(polys.edge));
+        const TopLoc_Location& loc = faceMap(polys.face).Location();
+        if (polys.poly2.IsNull())
+            builder.UpdateEdge(edge, polys.poly1, meshes[polys.face-1], loc);
+        else
+            builder.UpdateEdge(edge, polys.poly1, polys.poly2, meshes[polys.face-1], loc);
+    }
+    return true;
+}
+
 void TopoShape::write(const char *FileName) const
 {
     Base::FileInfo File(FileName);
@@ -1185,12 +1487,16 @@ void TopoShape::Restore(Base::XMLReader &)
 {
 }
 
-void TopoShape::SaveDocFile (Base::Writer &) const
+void TopoShape::SaveDocFile (Base::Writer &writer) const
 {
+    // Used by PropertyPartShape to store the tessellation next to the BRep
+    exportTriangulation(writer.Stream());
 }
 
-void TopoShape::RestoreDocFile(Base::Reader &)
+void TopoShape::RestoreDocFile(Base::Reader &reader)
 {
+    if (!importTriangulation(reader))
+        Base::Console().Log("Discard outdated tessellation '%s'\n", reader.getFileName().c_str());
 }
 
 unsigned int TopoShape_RefCountShapes(const TopoDS_Shape& aShape)
@@ -185,6 +185,16 @@ public:
     void exportBrep(const char *FileName) const;
     void exportBrep(std::ostream&) const;
     void exportBinary(std::ostream&);
+    /** Write the triangulation of all faces and the polygons of their edges
+     * in binary form, together with a fingerprint of the shape. Returns false
+     * and writes nothing if not all faces are triangulated.
+     */
+    bool exportTriangulation(std::ostream&) const;
+    /** Attach a triangulation written by exportTriangulation() to the faces
+     * and edges of this shape. Returns false and leaves the shape untouched
+     * if the fingerprint doesn't match.
+     */
+    bool importTriangulation(std::istream&);
     void exportStl (const char *FileName, double deflection) const;
     void exportFaceSet(double, double, const std::vector<App::Color>&, std::ostream&) const;
     void exportLineSet(std::ostream&) const;
@@ -80,6 +80,7 @@
 #include <Gui/SoFCUnifiedSelection.h>
 #include <Gui/SoFCSelectionAction.h>
 #include <Gui/SoFCInteractiveElement.h>
+#include <Gui/SoFCTriangleBVH.h>
 
 using namespace PartGui;
 
@@ -177,6 +178,7 @@ SoBrepFaceSet::SoBrepFaceSet()
     selContext2 = std::make_shared<SelContext>();
 
     pimpl.reset(new VBO);
+    bvh.reset(new Gui::SoFCTriangleBVH(&coordIndex));
 }
 
 SoBrepFaceSet::~SoBrepFaceSet()
@@ -922,7 +924,41 @@ void SoBrepFaceSet::GLRenderBelowPath(SoGLRenderAction * action)
   pointDetail.setCoordinateIndex(idx);      \
   this->shapeVertex(&vertex);
 
+void SoBrepFaceSet::rayPick(SoRayPickAction *action)
+{
+    if (!this->shouldRayPick(action))
+        return;
+
+    SoState * state = action->getState();
+    if (this->vertexProperty.getValue()) {
+        state->push();
+        this->vertexProperty.getValue()->doAction(action);
+    }
+
+    // for large face sets only the triangles near the pick ray are generated
+    std::vector<int> triangles;
+    bool useBVH = bvh->update(SoCoordinateElement::getInstance(state));
+    if (useBVH) {
+        this->computeObjectSpaceRay(action);
+        bvh->rayPick(action, triangles);
+    }
+
+    if (this->vertexProperty.getValue()) {
+        state->pop();
+    }
+
+    if (!useBVH)
+        inherited::rayPick(action);
+    else if (!triangles.empty())
+        generatePrimitives(action, &triangles);
+}
+
 void SoBrepFaceSet::generatePrimitives(SoAction * action)
+{
+    generatePrimitives(action, nullptr);
+}
+
+void SoBrepFaceSet::generatePrimitives(SoAction * action, const std::vector<int> *triangles)
 {
     //TODO
 #if 0
@@ -1008,6 +1044,36 @@ void SoBrepFaceSet::generatePrimitives(SoAction * action)
         mindices = cindices;
     }
 
+    if (triangles) {
+        Gui::SoFCTriangleBVH::TriangleData data;
+        data.coords = coords;
+        data.normals = normals;
+        data.cindices = cindices;
+        data.nindices = nindices;
+        data.tindices = tindices;
+        data.mindices = mindices;
+        // both enums follow the order of SoIndexedFaceSet
+        data.mbind = static_cast<Gui::SoFCTriangleBVH::Binding>(mbind);
+        data.nbind = static_cast<Gui::SoFCTriangleBVH::Binding>(nbind);
+        data.tb = doTextures ? &tb : nullptr;
+        data.partIndex = this->partIndex.getValues(0);
+        data.numParts = this->partIndex.getNum();
+
+        SoFaceDetail faceDetail;
+        this->beginShape(action, TRIANGLES, &faceDetail);
+        Gui::SoFCTriangleBVH::generateTriangles(*triangles, data, faceDetail,
+            [this](SoPrimitiveVertex *v) { this->shapeVertex(v); });
+        this->endShape();
+
+        if (normalCacheUsed) {
+            this->readUnlockNormalCache();
+        }
+        if (this->vertexProperty.getValue()) {
+            state->pop();
+        }
+        return;
+    }
+
     int texidx = 0;
     TriangleShape mode = POLYGON;
     TriangleShape newmode;
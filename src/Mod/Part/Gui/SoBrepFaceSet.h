@@ -38,6 +38,10 @@
 class SoGLCoordinateElement;
 class SoTextureCoordinateBundle;
 
+namespace Gui {
+class SoFCTriangleBVH;
+}
+
 // #define RENDER_GLARRAYS
 
 namespace PartGui {
@@ -98,6 +102,7 @@ protected:
         const SoPrimitiveVertex * v3,
         SoPickedPoint * pp);
     virtual void generatePrimitives(SoAction * action);
+    virtual void rayPick(SoRayPickAction *action);
 
 private:
     enum Binding {
@@ -136,6 +141,7 @@ private:
     void renderSelection(SoGLRenderAction *action, SelContextPtr, bool push=true);
 
     bool overrideMaterialBinding(SoGLRenderAction *action, SelContextPtr ctx, SelContextPtr ctx2);
+    void generatePrimitives(SoAction * action, const std::vector<int> *triangles);
 
 #ifdef RENDER_GLARRAYS
     void renderSimpleArray();
@@ -157,6 +163,9 @@ private:
     // Define some VBO pointer for the current mesh
     class VBO;
     std::unique_ptr<VBO> pimpl;
+
+    // Speeds up picking of large face sets
+    std::unique_ptr<Gui::SoFCTriangleBVH> bvh;
 };
 
 } // namespace PartGui
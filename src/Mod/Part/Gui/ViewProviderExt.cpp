@@ -95,6 +95,7 @@
 # include <Inventor/nodes/SoLightModel.h>
 # include <QAction>
 # include <QMenu>
+# include <QtConcurrentMap>
 #endif
 
 /// Here the FreeCAD includes sorted by Base,App,Gui......
@@ -919,7 +920,6 @@ void ViewProviderPartExt::updateVisual()
     // time measurement and book keeping
     Base::TimeInfo start_time;
     int numTriangles=0,numNodes=0,numNorms=0,numFaces=0,numEdges=0,numLines=0;
-    std::set<int> faceEdges;
 
     try {
         // calculating the deflection value
@@ -944,55 +944,57 @@ void ViewProviderPartExt::updateVisual()
         TopLoc_Location aLoc;
         cShape.Location(aLoc);
 
-        // count triangles and nodes in the mesh
+        // get an indexed map of edges
+        TopTools_IndexedMapOfShape edgeMap;
+        TopExp::MapShapes(cShape, TopAbs_EDGE, edgeMap);
+        numEdges = edgeMap.Extent();
+
+        // Count triangles and nodes in the mesh and remember where each face
+        // starts in the node and index arrays, so that the faces can be
+        // filled in independently of each other.
         TopTools_IndexedMapOfShape faceMap;
         TopExp::MapShapes(cShape, TopAbs_FACE, faceMap);
-        for (int i=1; i <= faceMap.Extent(); i++) {
-            Handle (Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(faceMap(i)), aLoc);
+        numFaces = faceMap.Extent();
+
+        // Note: The assumption that if for an edge BRep_Tool::Polygon3D
+        // returns a valid object is wrong. This e.g. happens for ruled
+        // surfaces which gets created by two edges or wires.
+        // So, we have to mark the edges associated to a face. If a given
+        // edge is not marked we know it's really a free edge.
+        std::vector<bool> faceEdges(numEdges+1,false);
+
+        struct FaceSlice {
+            Handle(Poly_Triangulation) mesh;
+            TopLoc_Location loc;
+            int nodeOffset;
+            int triaOffset;
+        };
+        std::vector<FaceSlice> slices(numFaces);
+        for (int i=1; i <= numFaces; i++) {
+            FaceSlice &slice = slices[i-1];
+            slice.mesh = BRep_Tool::Triangulation(TopoDS::Face(faceMap(i)), slice.loc);
+            slice.nodeOffset = numNodes;
+            slice.triaOffset = numTriangles;
             // Note: we must also count empty faces
-            if (!mesh.IsNull()) {
-                numTriangles += mesh->NbTriangles();
-                numNodes     += mesh->NbNodes();
-                numNorms     += mesh->NbNodes();
+            if (!slice.mesh.IsNull()) {
+                numTriangles += slice.mesh->NbTriangles();
+                numNodes     += slice.mesh->NbNodes();
+                numNorms     += slice.mesh->NbNodes();
             }
 
             TopExp_Explorer xp;
             for (xp.Init(faceMap(i),TopAbs_EDGE);xp.More();xp.Next())
-                faceEdges.insert(xp.Current().HashCode(INT_MAX));
-            numFaces++;
+                faceEdges[edgeMap.FindIndex(xp.Current())] = true;
         }
-
-        // get an indexed map of edges
-        TopTools_IndexedMapOfShape edgeMap;
-        TopExp::MapShapes(cShape, TopAbs_EDGE, edgeMap);
-
-         // key is the edge number, value the coord indexes. This is needed to keep the same order as the edges.
-        std::map<int, std::vector<int32_t> > lineSetMap;
-        std::set<int>          edgeIdxSet;
-        std::vector<int32_t>   edgeVector;
-
-        // count and index the edges
-        for (int i=1; i <= edgeMap.Extent(); i++) {
-            edgeIdxSet.insert(i);
-            numEdges++;
-
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            TopLoc_Location aLoc;
-
-            // handling of the free edge that are not associated to a face
-            // Note: The assumption that if for an edge BRep_Tool::Polygon3D
-            // returns a valid object is wrong. This e.g. happens for ruled
-            // surfaces which gets created by two edges or wires.
-            // So, we have to store the hashes of the edges associated to a face.
-            // If the hash of a given edge is not in this list we know it's really
-            // a free edge.
-            int hash = aEdge.HashCode(INT_MAX);
-            if (faceEdges.find(hash) == faceEdges.end()) {
-                Handle(Poly_Polygon3D) aPoly = BRep_Tool::Polygon3D(aEdge, aLoc);
-                if (!aPoly.IsNull()) {
-                    int nbNodesInEdge = aPoly->NbNodes();
-                    numNodes += nbNodesInEdge;
-                }
+        int faceNodeOffset = numNodes;
+
+        // count the free edge that are not associated to a face
+        for (int i=1; i <= numEdges; i++) {
+            if (!faceEdges[i]) {
+                TopLoc_Location aLoc;
+                Handle(Poly_Polygon3D) aPoly = BRep_Tool::Polygon3D(TopoDS::Edge(edgeMap(i)), aLoc);
+                if (!aPoly.IsNull())
+                    numNodes += aPoly->NbNodes();
             }
         }
 
@@ -1012,32 +1014,41 @@ void ViewProviderPartExt::updateVisual()
         int32_t* index = faceset ->coordIndex  .startEditing();
         int32_t* parts = faceset ->partIndex   .startEditing();
 
-        // preset the normal vector with null vector
-        for (int i=0;i < numNorms;i++)
-            norms[i]= SbVec3f(0.0,0.0,0.0);
+        // Fill in the triangles of each face into its own slice of the
+        // arrays. This does not modify any shared data and thus the faces
+        // are handled concurrently.
+        std::vector<int> faceIndices(numFaces);
+        for (int i=0; i < numFaces; i++)
+            faceIndices[i] = i;
+        QtConcurrent::blockingMap(faceIndices, [&](int &ii) {
+            const FaceSlice &slice = slices[ii];
+            const Handle(Poly_Triangulation) &mesh = slice.mesh;
+            if (mesh.IsNull()) {
+                parts[ii] = 0;
+                return;
+            }
 
-        int ii = 0,faceNodeOffset=0,faceTriaOffset=0;
-        for (int i=1; i <= faceMap.Extent(); i++, ii++) {
-            TopLoc_Location aLoc;
-            const TopoDS_Face &actFace = TopoDS::Face(faceMap(i));
-            // get the mesh of the shape
-            Handle (Poly_Triangulation) mesh = BRep_Tool::Triangulation(actFace,aLoc);
-            if (mesh.IsNull()) continue;
+            const TopoDS_Face &actFace = TopoDS::Face(faceMap(ii+1));
 
             // getting the transformation of the shape/face
             gp_Trsf myTransf;
             Standard_Boolean identity = true;
-            if (!aLoc.IsIdentity()) {
+            if (!slice.loc.IsIdentity()) {
                 identity = false;
-                myTransf = aLoc.Transformation();
+                myTransf = slice.loc.Transformation();
             }
 
             // getting size of node and triangle array of this face
             int nbNodesInFace = mesh->NbNodes();
             int nbTriInFace   = mesh->NbTriangles();
+            int faceNodeOffset = slice.nodeOffset;
+            int faceTriaOffset = slice.triaOffset;
             // check orientation
             TopAbs_Orientation orient = actFace.Orientation();
 
+            // preset the normal vector with null vector
+            for (int i=0;i < nbNodesInFace;i++)
+                norms[faceNodeOffset+i]= SbVec3f(0.0,0.0,0.0);
 
             // cycling through the poly mesh
             const Poly_Array1OfTriangle& Triangles = mesh->Triangles();
@@ -1107,29 +1118,51 @@ void ViewProviderPartExt::updateVisual()
                 index[faceTriaOffset*4+4*(g-1)+3] = SO_END_FACE_INDEX;
             }
 
+            // normalize the normals of this face
+            for (int i=0;i < nbNodesInFace;i++)
+                norms[faceNodeOffset+i].normalize();
+
             parts[ii] = nbTriInFace; // new part
+        });
+
+         // key is the edge number, value the coord indexes. This is needed to keep the same order as the edges.
+        std::map<int, std::vector<int32_t> > lineSetMap;
+        std::vector<bool> edgeDone(numEdges+1,false);
+
+        // handling the edges lying on the faces
+        for (int i=1; i <= numFaces; i++) {
+            const FaceSlice &slice = slices[i-1];
+            const Handle(Poly_Triangulation) &mesh = slice.mesh;
+            if (mesh.IsNull()) continue;
+
+            gp_Trsf myTransf;
+            Standard_Boolean identity = true;
+            if (!slice.loc.IsIdentity()) {
+                identity = false;
+                myTransf = slice.loc.Transformation();
+            }
+            const TColgp_Array1OfPnt& Nodes = mesh->Nodes();
 
-            // handling the edges lying on this face
             TopExp_Explorer Exp;
-            for(Exp.Init(actFace,TopAbs_EDGE);Exp.More();Exp.Next()) {
+            for(Exp.Init(faceMap(i),TopAbs_EDGE);Exp.More();Exp.Next()) {
                 const TopoDS_Edge &curEdge = TopoDS::Edge(Exp.Current());
                 // get the overall index of this edge
                 int edgeIndex = edgeMap.FindIndex(curEdge);
-                edgeVector.push_back((int32_t)edgeIndex-1);
                 // already processed this index ?
-                if (edgeIdxSet.find(edgeIndex)!=edgeIdxSet.end()) {
+                if (!edgeDone[edgeIndex]) {
                     
                     // this holds the indices of the edge's triangulation to the current polygon
-                    Handle(Poly_PolygonOnTriangulation) aPoly = BRep_Tool::PolygonOnTriangulation(curEdge, mesh, aLoc);
+                    Handle(Poly_PolygonOnTriangulation) aPoly = BRep_Tool::PolygonOnTriangulation(curEdge, mesh, slice.loc);
                     if (aPoly.IsNull())
                         continue; // polygon does not exist
                     
                     // getting the indexes of the edge polygon
                     const TColStd_Array1OfInteger& indices = aPoly->Nodes();
-                    for (Standard_Integer i=indices.Lower();i <= indices.Upper();i++) {
-                        int nodeIndex = indices(i);
-                        int index = faceNodeOffset+nodeIndex-1;
-                        lineSetMap[edgeIndex].push_back(index);
+                    std::vector<int32_t> &lineSet = lineSetMap[edgeIndex];
+                    for (Standard_Integer j=indices.Lower();j <= indices.Upper();j++) {
+                        int nodeIndex = indices(j);
+                        int index = slice.nodeOffset+nodeIndex-1;
+                        lineSet.push_back(index);
 
                         // usually the coordinates for this edge are already set by the
                         // triangles of the face this edge belongs to. However, there are
@@ -1142,28 +1175,21 @@ void ViewProviderPartExt::updateVisual()
                         verts[index].setValue((float)(p.X()),(float)(p.Y()),(float)(p.Z()));
                     }
 
-                    // remove the handled edge index from the set
-                    edgeIdxSet.erase(edgeIndex);
+                    // mark the handled edge index
+                    edgeDone[edgeIndex] = true;
                 }
             }
-
-            edgeVector.push_back(-1);
-            
-            // counting up the per Face offsets
-            faceNodeOffset += nbNodesInFace;
-            faceTriaOffset += nbTriInFace;
         }
 
         // handling of the free edges
-        for (int i=1; i <= edgeMap.Extent(); i++) {
+        for (int i=1; i <= numEdges; i++) {
             const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
             Standard_Boolean identity = true;
             gp_Trsf myTransf;
             TopLoc_Location aLoc;
 
             // handling of the free edge that are not associated to a face
-            int hash = aEdge.HashCode(INT_MAX);
-            if (faceEdges.find(hash) == faceEdges.end()) {
+            if (!faceEdges[i]) {
                 Handle(Poly_Polygon3D) aPoly = BRep_Tool::Polygon3D(aEdge, aLoc);
                 if (!aPoly.IsNull()) {
                     if (!aLoc.IsIdentity()) {
@@ -1195,10 +1221,6 @@ void ViewProviderPartExt::updateVisual()
             gp_Pnt pnt = BRep_Tool::Pnt(aVertex);
             verts[faceNodeOffset+i].setValue((float)(pnt.X()),(float)(pnt.Y()),(float)(pnt.Z()));
         }
-
-        // normalize all normals 
-        for (int i = 0; i< numNorms ;i++)
-            norms[i].normalize();
         
         std::vector<int32_t> lineSetCoords;
         for (std::map<int, std::vector<int32_t> >::iterator it = lineSetMap.begin(); it != lineSetMap.end(); ++it) {
@@ -52,6 +52,127 @@ class PartTestCases(unittest.TestCase):
         #self.Doc.addObject("Part::Feature","Face").Shape = result
         #self.assertTrue(isinstance(result.Surface, Part.BSplineSurface))
 
+    def testSaveRestoreShapes(self):
+        # the shapes are written to the archive concurrently
+        import tempfile
+        for i in range(1, 21):
+            self.Doc.addObject("Part::Feature","Shape{}".format(i)).Shape = Part.makeBox(i, 1, 1)
+        fileName = os.path.join(tempfile.gettempdir(), "PartTest.FCStd")
+        self.Doc.saveAs(fileName)
+        FreeCAD.closeDocument(self.Doc.Name)
+
+        self.Doc = FreeCAD.openDocument(fileName)
+        for i in range(1, 21):
+            shape = self.Doc.getObject("Shape{}".format(i)).Shape
+            self.assertAlmostEqual(shape.Volume, i)
+        os.remove(fileName)
+
+    def testSaveRestoreSharedShapes(self):
+        # shapes that only differ by their placement are stored once
+        import math, tempfile, zipfile
+        param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Part/General")
+        share = param.GetBool("ShareShapeFiles", False)
+        param.SetBool("ShareShapeFiles", True)
+        box = Part.makeBox(2, 2, 2)
+        for i in range(5):
+            feature = self.Doc.addObject("Part::Feature","Box{}".format(i))
+            feature.Shape = box
+            feature.Placement.Base = FreeCAD.Vector(3 * i, 0, 0)
+        self.Doc.addObject("Part::Feature","Cylinder").Shape = Part.makeCylinder(1, 2)
+        fileName = os.path.join(tempfile.gettempdir(), "PartTest.FCStd")
+        try:
+            self.Doc.saveAs(fileName)
+        finally:
+            param.SetBool("ShareShapeFiles", share)
+        with zipfile.ZipFile(fileName) as archive:
+            shapes = [n for n in archive.namelist() if n.endswith((".brp", ".bin"))]
+        self.assertEqual(len(shapes), 2)
+        FreeCAD.closeDocument(self.Doc.Name)
+
+        self.Doc = FreeCAD.openDocument(fileName)
+        for i in range(5):
+            shape = self.Doc.getObject("Box{}".format(i)).Shape
+            self.assertAlmostEqual(shape.Volume, 8)
+            self.assertAlmostEqual(shape.BoundBox.XMin, 3 * i)
+        self.assertAlmostEqual(self.Doc.Cylinder.Shape.Volume, 2 * math.pi, 5)
+        os.remove(fileName)
+
+    def testSaveRestoreIdenticalShapes(self):
+        # shapes built independently with the same content are stored once,
+        # the other files refer to the first one
+        import tempfile, zipfile
+        param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Part/General")
+        share = param.GetBool("ShareShapeFiles", False)
+        param.SetBool("ShareShapeFiles", True)
+        for i in range(5):
+            feature = self.Doc.addObject("Part::Feature","Box{}".format(i))
+            feature.Shape = Part.makeBox(2, 2, 2)
+            feature.Placement.Base = FreeCAD.Vector(3 * i, 0, 0)
+        self.Doc.addObject("Part::Feature","Other").Shape = Part.makeBox(1, 2, 2)
+        fileName = os.path.join(tempfile.gettempdir(), "PartTest.FCStd")
+        try:
+            self.Doc.saveAs(fileName)
+        finally:
+            param.SetBool("ShareShapeFiles", share)
+        with zipfile.ZipFile(fileName) as archive:
+            shapes = [archive.read(n) for n in archive.namelist() if n.endswith((".brp", ".bin"))]
+        self.assertEqual(len(shapes), 6)
+        refs = [s for s in shapes if s.startswith(b"@SharedFile:")]
+        self.assertEqual(len(refs), 4)
+        FreeCAD.closeDocument(self.Doc.Name)
+
+        self.Doc = FreeCAD.openDocument(fileName)
+        for i in range(5):
+            shape = self.Doc.getObject("Box{}".format(i)).Shape
+            self.assertAlmostEqual(shape.Volume, 8)
+            self.assertAlmostEqual(shape.BoundBox.XMin, 3 * i)
+        self.assertAlmostEqual(self.Doc.Other.Shape.Volume, 4)
+        os.remove(fileName)
+
+    def testSaveRestoreTessellation(self):
+        # the tessellation is saved next to the shape and reused when the
+        # document is opened again
+        import math, struct, tempfile, zipfile
+        param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Part/General")
+        saveMesh = param.GetBool("SaveTessellation", False)
+        param.SetBool("SaveTessellation", True)
+        shape = Part.makeCylinder(1, 2)
+        numFine = len(shape.tessellate(0.01)[1])
+        numCoarse = len(Part.makeCylinder(1, 2).tessellate(1.0)[1])
+        self.assertTrue(numFine > numCoarse)
+        self.Doc.addObject("Part::Feature","Cylinder").Shape = shape
+        fileName = os.path.join(tempfile.gettempdir(), "PartTest.FCStd")
+        try:
+            self.Doc.saveAs(fileName)
+        finally:
+            param.SetBool("SaveTessellation", saveMesh)
+        with zipfile.ZipFile(fileName) as archive:
+            entries = dict((n, archive.read(n)) for n in archive.namelist())
+        meshes = [n for n in entries if n.endswith(".tri")]
+        self.assertEqual(len(meshes), 1)
+        FreeCAD.closeDocument(self.Doc.Name)
+
+        # an existing finer tessellation is reused for a coarser request
+        self.Doc = FreeCAD.openDocument(fileName)
+        shape = self.Doc.Cylinder.Shape
+        self.assertAlmostEqual(shape.Volume, 2 * math.pi, 5)
+        self.assertEqual(len(shape.tessellate(1.0)[1]), numFine)
+        FreeCAD.closeDocument(self.Doc.Name)
+
+        # Corrupt the node and triangle counts of the first face. The header
+        # (magic, version, fingerprint, number of faces) is kept, so that the
+        # counts are actually read. The tessellation must be ignored.
+        data = entries[meshes[0]]
+        entries[meshes[0]] = data[:20] + struct.pack("=ii?d", 0x7fffffff, 0x7fffffff, False, 0.01)
+        with zipfile.ZipFile(fileName, "w") as archive:
+            for name, content in entries.items():
+                archive.writestr(name, content)
+        self.Doc = FreeCAD.openDocument(fileName)
+        shape = self.Doc.Cylinder.Shape
+        self.assertAlmostEqual(shape.Volume, 2 * math.pi, 5)
+        self.assertEqual(len(shape.tessellate(1.0)[1]), numCoarse)
+        os.remove(fileName)
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartTest")
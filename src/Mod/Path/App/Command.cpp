@@ -25,6 +25,7 @@
 
 #ifndef _PreComp_
 # include <cinttypes>
+# include <cstdlib>
 # include <iomanip>
 # include <boost/algorithm/string.hpp>
 # include <boost/lexical_cast.hpp>
@@ -100,108 +101,168 @@ bool Command::has(const std::string& attr) const
 
 std::string Command::toGCode (int precision, bool padzero) const
 {
-    std::stringstream str;
-    str.fill('0');
-    str << Name;
+    std::string gcode(Name);
+    for(std::map<std::string,double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
+        if(i->first == "N") continue;
+        appendGCodeWord(gcode, i->first, i->second, precision, padzero);
+    }
+    return gcode;
+}
+
+static void appendDigits(std::string &str, std::int64_t v, int width)
+{
+    char digits[24];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + v%10);
+        v /= 10;
+    } while(v && count < 24);
+    for(int i = count; i < width; i++)
+        str += '0';
+    while(count > 0)
+        str += digits[--count];
+}
+
+void Command::appendGCodeWord(std::string &gcode, const std::string &key, double value,
+                              int precision, bool padzero)
+{
     if(precision<0)
         precision = 0;
-    double scale = std::pow(10.0,precision+1);
+    double scale = 10.0;
+    for(int i = 0; i < precision; i++)
+        scale *= 10.0;
     std::int64_t iscale = static_cast<std::int64_t>(scale)/10;
-    for(std::map<std::string,double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
-        if(i->first == "N") continue;
 
-        str << " " << i->first;
+    gcode += ' ';
+    gcode += key;
 
-        std::int64_t v = static_cast<std::int64_t>(i->second*scale);
-        if(v<0) {
-            v = -v;
-            str << '-'; //shall we allow -0 ?
-        }
-        v+=5;
-        v /= 10;
-        str << (v/iscale);
-        if(!precision) continue;
-
-        int width = precision;
-        std::int64_t digits = v%iscale;
-        if(!padzero) {
-            if(!digits) continue;
-            while(digits%10 == 0) {
-                digits/=10;
-                --width;
-            }
+    std::int64_t v = static_cast<std::int64_t>(value*scale);
+    if(v<0) {
+        v = -v;
+        gcode += '-'; //shall we allow -0 ?
+    }
+    v+=5;
+    v /= 10;
+    appendDigits(gcode, v/iscale, 0);
+    if(!precision) return;
+
+    int width = precision;
+    std::int64_t digits = v%iscale;
+    if(!padzero) {
+        if(!digits) return;
+        while(digits%10 == 0) {
+            digits/=10;
+            --width;
         }
-        str << '.' << std::setw(width) << std::right << digits;
     }
-    return str.str();
+    gcode += '.';
+    appendDigits(gcode, digits, width);
 }
 
-void Command::setFromGCode (const std::string& str)
+// Converts the digits, minus signs and points collected for a word the same
+// way as atof() does, but without its overhead for the common short values.
+static double toValue(const std::string &value)
 {
-    Parameters.clear();
-    std::string mode = "none";
-    std::string key;
+    static const double powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char *it = value.c_str();
+    bool negative = (*it == '-');
+    if(negative)
+        ++it;
+
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int decimals = 0;
+    for(; isdigit(*it); ++it, ++digits)
+        mantissa = mantissa*10 + static_cast<std::uint64_t>(*it - '0');
+    if(*it == '.') {
+        for(++it; isdigit(*it); ++it, ++digits, ++decimals)
+            mantissa = mantissa*10 + static_cast<std::uint64_t>(*it - '0');
+    }
+
+    if(!digits)
+        return 0.0;
+    if(digits > 15)
+        return std::atof(value.c_str());
+    double v = static_cast<double>(mantissa)/powers[decimals];
+    return negative ? -v : v;
+}
+
+void Command::parseGCode(const char* begin, const char* end, std::string &name,
+                         std::vector<std::pair<char,double> > &words)
+{
+    enum { ModeNone, ModeCommand, ModeArgument, ModeComment } mode = ModeNone;
+    char key = 0;
     std::string value;
-    for (unsigned int i=0; i < str.size(); i++) {
-        if ( (isdigit(str[i])) || (str[i] == '-') || (str[i] == '.') ) {
-            value += str[i];
-        } else if (isalpha(str[i])) {
-            if (mode == "command") {
-                if (!key.empty() && !value.empty()) {
-                    std::string cmd = key + value;
-                    boost::to_upper(cmd);
-                    Name = cmd;
-                    key = "";
-                    value = "";
-                    mode = "argument";
+    words.clear();
+    for (const char *it = begin; it != end; ++it) {
+        unsigned char c = static_cast<unsigned char>(*it);
+        if ( (isdigit(c)) || (c == '-') || (c == '.') ) {
+            value += *it;
+        } else if (isalpha(c)) {
+            if (mode == ModeCommand) {
+                if (key && !value.empty()) {
+                    name.assign(1, key);
+                    name += value;
+                    boost::to_upper(name);
+                    value.clear();
                 } else {
                     throw Base::BadFormatError("Badly formatted GCode command");
                 }
-                mode = "argument";
-            } else if (mode == "none") {
-                mode = "command";
-            } else if (mode == "argument") {
-                if (!key.empty() && !value.empty()) {
-                    double val = std::atof(value.c_str());
-                    boost::to_upper(key);
-                    Parameters[key] = val;
-                    key = "";
-                    value = "";
+                mode = ModeArgument;
+            } else if (mode == ModeNone) {
+                mode = ModeCommand;
+            } else if (mode == ModeArgument) {
+                if (key && !value.empty()) {
+                    words.push_back(std::make_pair(static_cast<char>(toupper(static_cast<unsigned char>(key))),
+                                                   toValue(value)));
+                    value.clear();
                 } else {
                     throw Base::BadFormatError("Badly formatted GCode argument");
                 }
-            } else if (mode == "comment") {
-                value += str[i];
+            } else if (mode == ModeComment) {
+                value += *it;
             }
-            key = str[i];
-        } else if (str[i] == '(') {
-            mode = "comment";
-        } else if (str[i] == ')') {
-            key = "(";
-            value += ")";
+            key = *it;
+        } else if (c == '(') {
+            mode = ModeComment;
+        } else if (c == ')') {
+            key = '(';
+            value += ')';
         } else {
             // add non-ascii characters only if this is a comment
-            if (mode == "comment") {
-                value += str[i];
+            if (mode == ModeComment) {
+                value += *it;
             }
         }
     }
-    if (!key.empty() && !value.empty()) {
-        if ( (mode == "command") || (mode == "comment") ) {
-            std::string cmd = key + value;
-            if (mode == "command")
-                boost::to_upper(cmd);
-            Name = cmd;
+    if (key && !value.empty()) {
+        if ( (mode == ModeCommand) || (mode == ModeComment) ) {
+            name.assign(1, key);
+            name += value;
+            if (mode == ModeCommand)
+                boost::to_upper(name);
         } else {
-            double val = std::atof(value.c_str());
-            boost::to_upper(key);
-            Parameters[key] = val;
+            words.push_back(std::make_pair(static_cast<char>(toupper(static_cast<unsigned char>(key))),
+                                           toValue(value)));
         }
     } else {
         throw Base::BadFormatError("Badly formatted GCode argument");
     }
 }
 
+void Command::setFromGCode (const std::string& str)
+{
+    Parameters.clear();
+    std::vector<std::pair<char,double> > words;
+    parseGCode(str.c_str(), str.c_str() + str.size(), Name, words);
+    for (std::vector<std::pair<char,double> >::const_iterator it = words.begin(); it != words.end(); ++it)
+        Parameters[std::string(1, it->first)] = it->second;
+}
+
 void Command::setFromPlacement (const Base::Placement &plac)
 {
     Name = "G1";
@@ -303,7 +364,10 @@ void Command::scaleBy(double factor)
 
 unsigned int Command::getMemSize (void) const
 {
-    return toGCode().size();
+    unsigned int size = Name.size();
+    for(std::map<std::string,double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i)
+        size += i->first.size() + sizeof(double);
+    return size;
 }
 
 void Command::Save (Writer &writer) const
@@ -26,6 +26,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <Base/Persistence.h>
 #include <Base/Placement.h>
 #include <Base/Vector3D.h>
@@ -60,6 +61,13 @@ namespace Path
         double getValue(const std::string &name) const; // returns the value of a given parameter
         void scaleBy(double factor); // scales the receiver - use for imperial/metric conversions
 
+        // parses a single GCode command, the words are returned as upper case letters with their values
+        static void parseGCode(const char* begin, const char* end, std::string& name,
+                               std::vector<std::pair<char,double> >& words);
+        // appends a word with the given key and value to a GCode string as done by toGCode()
+        static void appendGCodeWord(std::string& gcode, const std::string& key, double value,
+                                    int precision=6, bool padzero=true);
+
         // this assumes the name is upper case
         inline double getParam(const std::string &name) const {
             auto it = Parameters.find(name);
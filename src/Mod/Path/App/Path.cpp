@@ -24,11 +24,14 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <cctype>
+# include <iterator>
 # include <boost/regex.hpp>
 #endif
 
 #include <Base/Writer.h>
 #include <Base/Reader.h>
+#include <Base/Rotation.h>
 #include <Base/Stream.h>
 #include <Base/Exception.h>
 
@@ -46,20 +49,25 @@ using namespace Base;
 TYPESYSTEM_SOURCE(Path::Toolpath , Base::Persistence);
 
 Toolpath::Toolpath()
+    : offsets(1, 0)
 {
 }
 
 Toolpath::Toolpath(const Toolpath& otherPath)
-    : vpcCommands(otherPath.vpcCommands.size())
+    : names(otherPath.names)
+    , nameIndex(otherPath.nameIndex)
+    , opcodes(otherPath.opcodes)
+    , masks(otherPath.masks)
+    , offsets(otherPath.offsets)
+    , values(otherPath.values)
+    , extras(otherPath.extras)
     , center(otherPath.center)
 {
-    *this = otherPath;
     recalculate();
 }
 
 Toolpath::~Toolpath()
 {
-    clear();
 }
 
 Toolpath &Toolpath::operator=(const Toolpath& otherPath)
@@ -67,12 +75,13 @@ Toolpath &Toolpath::operator=(const Toolpath& otherPath)
     if (this == &otherPath)
         return *this;
 
-    clear();
-    vpcCommands.resize(otherPath.vpcCommands.size());
-    int i = 0;
-    for (std::vector<Command*>::const_iterator it=otherPath.vpcCommands.begin();it!=otherPath.vpcCommands.end();++it,i++) {
-        vpcCommands[i] = new Command(**it);
-    }
+    names = otherPath.names;
+    nameIndex = otherPath.nameIndex;
+    opcodes = otherPath.opcodes;
+    masks = otherPath.masks;
+    offsets = otherPath.offsets;
+    values = otherPath.values;
+    extras = otherPath.extras;
     center = otherPath.center;
     recalculate();
     return *this;
@@ -80,62 +89,197 @@ Toolpath &Toolpath::operator=(const Toolpath& otherPath)
 
 void Toolpath::clear(void)
 {
-    for(std::vector<Command*>::iterator it = vpcCommands.begin();it!=vpcCommands.end();++it)
-        delete ( *it );
-    vpcCommands.clear();
+    names.clear();
+    nameIndex.clear();
+    opcodes.clear();
+    masks.clear();
+    offsets.assign(1, 0);
+    values.clear();
+    extras.clear();
     recalculate();
 }
 
+static inline std::size_t countWords(std::uint32_t mask)
+{
+    std::size_t count = 0;
+    for (; mask; mask &= mask - 1)
+        ++count;
+    return count;
+}
+
+// Splits the parameters of a command into the words A-Z, which are stored
+// in alphabetical order, and the other parameters
+static std::uint32_t collectWords(const Command &cmd, double *words,
+                                  std::map<std::string,double> &extra)
+{
+    std::uint32_t mask = 0;
+    std::size_t count = 0;
+    for (std::map<std::string,double>::const_iterator it = cmd.Parameters.begin(); it != cmd.Parameters.end(); ++it) {
+        const std::string &key = it->first;
+        if (key.size() == 1 && key[0] >= 'A' && key[0] <= 'Z') {
+            mask |= 1u << (key[0] - 'A');
+            words[count++] = it->second;
+        } else {
+            extra.insert(*it);
+        }
+    }
+    return mask;
+}
+
+// Moves the extra parameters of the commands at and behind pos one position
+// up after an insertion or one position down after a deletion
+static void shiftExtras(std::map<std::size_t, std::map<std::string,double> > &extras,
+                        std::size_t pos, bool inserted)
+{
+    std::map<std::size_t, std::map<std::string,double> > shifted;
+    for (std::map<std::size_t, std::map<std::string,double> >::iterator it = extras.begin(); it != extras.end(); ++it) {
+        if (it->first < pos)
+            shifted[it->first].swap(it->second);
+        else if (inserted)
+            shifted[it->first + 1].swap(it->second);
+        else if (it->first > pos)
+            shifted[it->first - 1].swap(it->second);
+    }
+    extras.swap(shifted);
+}
+
+unsigned int Toolpath::getOpcode(const std::string &name)
+{
+    std::map<std::string, unsigned int>::iterator it = nameIndex.find(name);
+    if (it != nameIndex.end())
+        return it->second;
+
+    unsigned int opcode = static_cast<unsigned int>(names.size());
+    names.push_back(name);
+    nameIndex[name] = opcode;
+    return opcode;
+}
+
+void Toolpath::insertWords(std::size_t pos, unsigned int opcode, std::uint32_t mask,
+                           const double *words, const std::map<std::string,double> *extra)
+{
+    std::size_t count = countWords(mask);
+    std::size_t offset = offsets[pos];
+    values.insert(values.begin() + offset, words, words + count);
+    offsets.insert(offsets.begin() + pos, offset);
+    for (std::vector<std::size_t>::iterator it = offsets.begin() + pos + 1; it != offsets.end(); ++it)
+        *it += count;
+    opcodes.insert(opcodes.begin() + pos, opcode);
+    masks.insert(masks.begin() + pos, mask);
+
+    if (pos + 1 < opcodes.size() && !extras.empty())
+        shiftExtras(extras, pos, true);
+    if (extra && !extra->empty())
+        extras[pos] = *extra;
+}
+
 void Toolpath::addCommand(const Command &Cmd)
 {
-    Command *tmp = new Command(Cmd);
-    vpcCommands.push_back(tmp);
-    recalculate();
+    insertCommand(Cmd, static_cast<int>(opcodes.size()));
 }
 
 void Toolpath::insertCommand(const Command &Cmd, int pos)
 {
     if (pos == -1) {
-        addCommand(Cmd);
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        Command *tmp = new Command(Cmd);
-        vpcCommands.insert(vpcCommands.begin()+pos,tmp);
-    } else {
+        pos = static_cast<int>(opcodes.size());
+    } else if (pos < 0 || pos > static_cast<int>(opcodes.size())) {
         throw Base::IndexError("Index not in range");
     }
+
+    double words[26];
+    std::map<std::string,double> extra;
+    std::uint32_t mask = collectWords(Cmd, words, extra);
+    insertWords(pos, getOpcode(Cmd.Name), mask, words, &extra);
     recalculate();
 }
 
 void Toolpath::deleteCommand(int pos)
 {
-    if (pos == -1) {
-        //delete(*vpcCommands.rbegin()); // causes crash
-        vpcCommands.pop_back();
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        vpcCommands.erase (vpcCommands.begin()+pos);
-    } else {
+    if (pos == -1)
+        pos = static_cast<int>(opcodes.size()) - 1;
+    if (pos < 0 || pos >= static_cast<int>(opcodes.size()))
         throw Base::IndexError("Index not in range");
-    }
+
+    std::size_t first = offsets[pos];
+    std::size_t count = offsets[pos + 1] - first;
+    values.erase(values.begin() + first, values.begin() + first + count);
+    offsets.erase(offsets.begin() + pos);
+    for (std::vector<std::size_t>::iterator it = offsets.begin() + pos; it != offsets.end(); ++it)
+        *it -= count;
+    opcodes.erase(opcodes.begin() + pos);
+    masks.erase(masks.begin() + pos);
+
+    if (!extras.empty())
+        shiftExtras(extras, pos, false);
     recalculate();
 }
 
+Command Toolpath::getCommand(unsigned int pos) const
+{
+    Command cmd;
+    cmd.Name = names[opcodes[pos]];
+    std::size_t offset = offsets[pos];
+    for (int i = 0; i < 26; i++) {
+        if (masks[pos] & (1u << i)) {
+            cmd.Parameters.insert(cmd.Parameters.end(),
+                std::make_pair(std::string(1, static_cast<char>('A' + i)), values[offset++]));
+        }
+    }
+
+    std::map<std::size_t, std::map<std::string,double> >::const_iterator it = extras.find(pos);
+    if (it != extras.end())
+        cmd.Parameters.insert(it->second.begin(), it->second.end());
+    return cmd;
+}
+
+double Toolpath::getParameter(unsigned int pos, char word) const
+{
+    std::uint32_t bit = wordBit(word);
+    if (!(masks[pos] & bit))
+        return 0.0;
+    // the values are in alphabetical order
+    return values[offsets[pos] + countWords(masks[pos] & (bit - 1))];
+}
+
+Base::Placement Toolpath::getPlacement(std::size_t pos) const
+{
+    unsigned int i = static_cast<unsigned int>(pos);
+    Vector3d vec(getParameter(i,'X'),getParameter(i,'Y'),getParameter(i,'Z'));
+    Rotation rot;
+    rot.setYawPitchRoll(getParameter(i,'A'),getParameter(i,'B'),getParameter(i,'C'));
+    return Placement(vec,rot);
+}
+
 double Toolpath::getLength()
 {
-    if(vpcCommands.size()==0)
+    if(opcodes.empty())
         return 0;
+
+    // check the names once instead of for every command
+    std::vector<char> kinds(names.size(), 0);
+    for (std::size_t i = 0; i < names.size(); i++) {
+        const std::string &name = names[i];
+        if ( (name == "G0") || (name == "G00") || (name == "G1") || (name == "G01") )
+            kinds[i] = 'L';
+        else if ( (name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") )
+            kinds[i] = 'A';
+    }
+
     double l = 0;
     Vector3d last(0,0,0);
     Vector3d next;
-    for(std::vector<Command*>::const_iterator it = vpcCommands.begin();it!=vpcCommands.end();++it) {
-        std::string name = (*it)->Name;
-        next = (*it)->getPlacement().getPosition();
-        if ( (name == "G0") || (name == "G00") || (name == "G1") || (name == "G01") ) {
+    for (unsigned int i = 0; i < getSize(); i++) {
+        char kind = kinds[opcodes[i]];
+        if (!kind)
+            continue;
+        next.Set(getParameter(i,'X'),getParameter(i,'Y'),getParameter(i,'Z'));
+        if (kind == 'L') {
             // straight line
             l += (next - last).Length();
             last = next;
-        } else if ( (name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
+        } else {
             // arc
-            Vector3d center = (*it)->getCenter();
+            Vector3d center(getParameter(i,'I'),getParameter(i,'J'),getParameter(i,'K'));
             double radius = (last - center).Length();
             double angle = (next - center).GetAngle(last - center);
             l += angle * radius;
@@ -145,22 +289,61 @@ double Toolpath::getLength()
     return l;
 }
 
-static void bulkAddCommand(const std::string &gcodestr, std::vector<Command*> &commands, bool &inches)
+void Toolpath::addCommands(const Toolpath &other)
 {
-    Command *cmd = new Command();
-    cmd->setFromGCode(gcodestr);
-    if ("G20" == cmd->Name) {
-        inches = true;
-        delete cmd;
-    } else if ("G21" == cmd->Name) {
-        inches = false;
-        delete cmd;
-    } else {
-        if (inches) {
-            cmd->scaleBy(25.4);
+    if (this == &other) {
+        Toolpath copy(other);
+        addCommands(copy);
+        return;
+    }
+
+    std::vector<unsigned int> opcodeMap(other.names.size());
+    for (std::size_t i = 0; i < other.names.size(); i++)
+        opcodeMap[i] = getOpcode(other.names[i]);
+
+    std::size_t count = opcodes.size();
+    std::size_t offset = values.size();
+    opcodes.reserve(count + other.opcodes.size());
+    for (std::vector<unsigned int>::const_iterator it = other.opcodes.begin(); it != other.opcodes.end(); ++it)
+        opcodes.push_back(opcodeMap[*it]);
+    masks.insert(masks.end(), other.masks.begin(), other.masks.end());
+    values.insert(values.end(), other.values.begin(), other.values.end());
+    offsets.reserve(offsets.size() + other.opcodes.size());
+    for (std::vector<std::size_t>::const_iterator it = other.offsets.begin() + 1; it != other.offsets.end(); ++it)
+        offsets.push_back(offset + *it);
+    for (std::map<std::size_t, std::map<std::string,double> >::const_iterator it = other.extras.begin(); it != other.extras.end(); ++it)
+        extras[count + it->first] = it->second;
+    recalculate();
+}
+
+void Toolpath::transform(const Base::Placement &other)
+{
+    static const char axes[] = "XYZABC";
+    std::uint32_t axesMask = 0;
+    for (int j = 0; j < 6; j++)
+        axesMask |= wordBit(axes[j]);
+
+    for (std::size_t i = 0; i < opcodes.size(); i++) {
+        std::uint32_t mask = masks[i];
+        if (!(mask & axesMask))
+            continue;
+
+        Base::Placement plac = getPlacement(i);
+        plac *= other;
+        double transformed[6];
+        transformed[0] = plac.getPosition().x;
+        transformed[1] = plac.getPosition().y;
+        transformed[2] = plac.getPosition().z;
+        plac.getRotation().getYawPitchRoll(transformed[3],transformed[4],transformed[5]);
+
+        // only the words the command already has are changed
+        for (int j = 0; j < 6; j++) {
+            std::uint32_t bit = wordBit(axes[j]);
+            if (mask & bit)
+                values[offsets[i] + countWords(mask & (bit - 1))] = transformed[j];
         }
-        commands.push_back(cmd);
     }
+    recalculate();
 }
 
 void Toolpath::setFromGCode(const std::string instr)
@@ -170,47 +353,96 @@ void Toolpath::setFromGCode(const std::string instr)
     // remove comments
     //boost::regex e("\\(.*?\\)");
     //std::string str = boost::regex_replace(instr, e, "");
-    std::string str(instr);
+    const std::string &str(instr);
+
+    std::string name;
+    std::vector<std::pair<char,double> > words;
+    double slots[26];
+    double packed[26];
+    bool inches = false;
+
+    // parses the command between first and last and appends it to the columns
+    auto addGCode = [&](std::size_t first, std::size_t last) {
+        name.clear();
+        Command::parseGCode(str.data() + first, str.data() + last, name, words);
+        if ("G20" == name) {
+            inches = true;
+            return;
+        } else if ("G21" == name) {
+            inches = false;
+            return;
+        }
+
+        std::uint32_t mask = 0;
+        std::map<std::string,double> extra;
+        for (std::vector<std::pair<char,double> >::const_iterator it = words.begin(); it != words.end(); ++it) {
+            double value = it->second;
+            if (inches) {
+                // the same words as Command::scaleBy()
+                switch (it->first) {
+                    case 'X':
+                    case 'Y':
+                    case 'Z':
+                    case 'I':
+                    case 'J':
+                    case 'R':
+                    case 'Q':
+                    case 'F':
+                        value *= 25.4;
+                        break;
+                }
+            }
+            std::uint32_t bit = wordBit(it->first);
+            if (bit) {
+                mask |= bit;
+                slots[it->first - 'A'] = value;
+            } else {
+                extra[std::string(1, it->first)] = value;
+            }
+        }
+
+        std::size_t count = 0;
+        for (int i = 0; i < 26; i++) {
+            if (mask & (1u << i))
+                packed[count++] = slots[i];
+        }
+        insertWords(opcodes.size(), getOpcode(name), mask, packed, &extra);
+    };
 
     // split input string by () or G or M commands
-    std::string mode = "command";
+    bool comment = false;
     std::size_t found = str.find_first_of("(gGmM");
-    int last = -1;
-    bool inches = false;
+    std::size_t last = std::string::npos;
     while (found != std::string::npos)
     {
         if (str[found] == '(') {
             // start of comment
-            if ( (last > -1) && (mode == "command") ) {
+            if ( (last != std::string::npos) && !comment ) {
                 // before opening a comment, add the last found command
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
+                addGCode(last, found);
             }
-            mode = "comment";
+            comment = true;
             last = found;
             found = str.find_first_of(")", found+1);
         } else if (str[found] == ')') {
             // end of comment
-            std::string gcodestr = str.substr(last, found-last+1);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
-            last = -1;
+            addGCode(last, found+1);
+            last = std::string::npos;
             found = str.find_first_of("(gGmM", found+1);
-            mode = "command";
-        } else if (mode == "command") {
+            comment = false;
+        } else if (!comment) {
             // command
-            if (last > -1) {
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
+            if (last != std::string::npos) {
+                addGCode(last, found);
             }
             last = found;
             found = str.find_first_of("(gGmM", found+1);
         }
     }
     // add the last command found, if any
-    if (last > -1) {
-        if (mode == "command") {
-            std::string gcodestr = str.substr(last,std::string::npos);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
+    if (last != std::string::npos) {
+        if (!comment) {
+            addGCode(last, str.size());
         }
     }
     recalculate();
@@ -218,9 +450,29 @@ void Toolpath::setFromGCode(const std::string instr)
 
 std::string Toolpath::toGCode(void) const
 {
+    std::string keys[26];
+    for (int i = 0; i < 26; i++)
+        keys[i] = std::string(1, static_cast<char>('A' + i));
+
     std::string result;
-    for (std::vector<Command*>::const_iterator it=vpcCommands.begin();it!=vpcCommands.end();++it) {
-        result += (*it)->toGCode();
+    result.reserve(values.size() * 12 + opcodes.size() * 4);
+    for (unsigned int i = 0; i < getSize(); i++) {
+        if (extras.find(i) != extras.end()) {
+            // keep the order of Command::toGCode() for the other parameter names
+            result += getCommand(i).toGCode();
+            result += "\n";
+            continue;
+        }
+
+        result += names[opcodes[i]];
+        const double *value = values.data() + offsets[i];
+        for (int j = 0; j < 26; j++) {
+            if (masks[i] & (1u << j)) {
+                if (j != 'N' - 'A')
+                    Command::appendGCodeWord(result, keys[j], *value);
+                ++value;
+            }
+        }
         result += "\n";
     }
     return result;
@@ -229,7 +481,7 @@ std::string Toolpath::toGCode(void) const
 void Toolpath::recalculate(void) // recalculates the path cache
 {
 
-    if(vpcCommands.size()==0)
+    if(opcodes.empty())
         return;
 
     // TODO recalculate the KDL stuff. At the moment, this is unused.
@@ -293,7 +545,15 @@ void Toolpath::recalculate(void) // recalculates the path cache
 
 unsigned int Toolpath::getMemSize (void) const
 {
-    return toGCode().size();
+    std::size_t size = opcodes.size() * sizeof(unsigned int)
+                     + masks.size() * sizeof(std::uint32_t)
+                     + offsets.size() * sizeof(std::size_t)
+                     + values.size() * sizeof(double);
+    for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+        size += it->size();
+    for (std::map<std::size_t, std::map<std::string,double> >::const_iterator it = extras.begin(); it != extras.end(); ++it)
+        size += it->second.size() * (sizeof(double) + 1);
+    return static_cast<unsigned int>(size);
 }
 
 void Toolpath::setCenter(const Base::Vector3d &c)
@@ -314,7 +574,7 @@ void Toolpath::Save (Writer &writer) const
         writer.incInd();
         saveCenter(writer, center);
         for(unsigned int i = 0; i < getSize(); i++) {
-            vpcCommands[i]->Save(writer);
+            getCommand(i).Save(writer);
         }
         writer.decInd();
     } else {
@@ -329,9 +589,10 @@ void Toolpath::Save (Writer &writer) const
 
 void Toolpath::SaveDocFile (Base::Writer &writer) const
 {
-    if (toGCode().empty())
+    std::string gcode = toGCode();
+    if (gcode.empty())
         return;
-    writer.Stream() << toGCode();
+    writer.Stream() << gcode;
 }
 
 void Toolpath::Restore(XMLReader &reader)
@@ -347,12 +608,22 @@ void Toolpath::Restore(XMLReader &reader)
 
 void Toolpath::RestoreDocFile(Base::Reader &reader)
 {
+    // read the whole file at once, every run of white space becomes a single blank
     std::string gcode;
-    std::string line;
-    while (reader >> line) {
-        gcode += line;
-        gcode += " ";
+    bool blank = true;
+    std::istreambuf_iterator<char> it(reader), end;
+    for (; it != end; ++it) {
+        if (isspace(static_cast<unsigned char>(*it))) {
+            if (!blank)
+                gcode += ' ';
+            blank = true;
+        } else {
+            gcode += *it;
+            blank = false;
+        }
     }
+    if (!blank)
+        gcode += ' ';
     setFromGCode(gcode);
 
 }
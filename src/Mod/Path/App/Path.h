@@ -28,12 +28,22 @@
 //#include "Mod/Robot/App/kdl_cp/path_composite.hpp"
 //#include "Mod/Robot/App/kdl_cp/frames_io.hpp"
 #include <Base/Persistence.h>
+#include <Base/Placement.h>
 #include <Base/Vector3D.h>
+#include <cstdint>
 
 namespace Path
 {
 
-    /** The representation of a CNC Toolpath */
+    /** The representation of a CNC Toolpath
+     *
+     * The commands are not kept as individual Command objects but in columns:
+     * each command has an index into the table of command names and a bit
+     * mask of the words A to Z it has. The values of these words follow each
+     * other in alphabetical order in one array. Parameters whose name is not a
+     * single upper case letter are kept aside per command. Command objects are
+     * only created on request, e.g. for the Python interface.
+     */
     
     class PathExport Toolpath : public Base::Persistence
     {
@@ -62,11 +72,15 @@ namespace Path
             void recalculate(void); // recalculates the points
             void setFromGCode(const std::string); // sets the path from the contents of the given GCode string
             std::string toGCode(void) const; // gets a gcode string representation from the Path
+            void addCommands(const Toolpath &other); // adds all commands of another path at the end
+            void transform(const Base::Placement &plac); // transforms all commands as Command::transform does
             
             // shortcut functions
-            unsigned int getSize(void) const { return vpcCommands.size(); }
-            const std::vector<Command*> &getCommands(void) const { return vpcCommands; }
-            const Command &getCommand(unsigned int pos)    const { return *vpcCommands[pos]; }
+            unsigned int getSize(void) const { return static_cast<unsigned int>(opcodes.size()); }
+            Command getCommand(unsigned int pos) const; // returns a copy of the command at the given position
+            const std::string &getCommandName(unsigned int pos) const { return names[opcodes[pos]]; }
+            bool hasParameter(unsigned int pos, char word) const { return (masks[pos] & wordBit(word)) != 0; }
+            double getParameter(unsigned int pos, char word) const; // returns 0 if the command doesn't have the word
         
             // support for rotation
             const Base::Vector3d& getCenter() const { return center; }
@@ -75,7 +89,21 @@ namespace Path
             static const int SchemaVersion = 2;
 
         protected:
-            std::vector<Command*> vpcCommands;
+            static std::uint32_t wordBit(char word) {
+                return (word >= 'A' && word <= 'Z') ? (1u << (word - 'A')) : 0u;
+            }
+            unsigned int getOpcode(const std::string &name);
+            void insertWords(std::size_t pos, unsigned int opcode, std::uint32_t mask,
+                             const double *words, const std::map<std::string,double> *extra);
+            Base::Placement getPlacement(std::size_t pos) const;
+
+            std::vector<std::string> names;                 // the distinct command names
+            std::map<std::string, unsigned int> nameIndex;  // position of a name in names
+            std::vector<unsigned int> opcodes;              // per command the index of its name
+            std::vector<std::uint32_t> masks;               // per command the words A-Z it has
+            std::vector<std::size_t> offsets;               // per command its first value, plus the end
+            std::vector<double> values;                     // the values of all words
+            std::map<std::size_t, std::map<std::string,double> > extras; // other parameters per command
             Base::Vector3d center;
             //KDL::Path_Composite *pcPath;
             
@@ -524,21 +524,20 @@ void ViewProviderPath::updateVisual(bool rebuild) {
         markers.push_back(last); // startpoint of path
 
         for (unsigned int  i = 0; i < tp.getSize(); i++) {
-            const Path::Command &cmd = tp.getCommand(i);
-            const std::string &name = cmd.Name;
-            Base::Vector3d next = cmd.getPlacement().getPosition();
+            const std::string &name = tp.getCommandName(i);
+            Base::Vector3d next(tp.getParameter(i,'X'), tp.getParameter(i,'Y'), tp.getParameter(i,'Z'));
             double a = A;
             double b = B;
             double c = C;
 
             if (!absolute)
                 next = last + next;
-            if (!cmd.has("X")) next.x = last.x;
-            if (!cmd.has("Y")) next.y = last.y;
-            if (!cmd.has("Z")) next.z = last.z;
-            if ( cmd.has("A")) a = cmd.getValue("A");
-            if ( cmd.has("B")) b = cmd.getValue("B");
-            if ( cmd.has("C")) c = cmd.getValue("C");
+            if (!tp.hasParameter(i,'X')) next.x = last.x;
+            if (!tp.hasParameter(i,'Y')) next.y = last.y;
+            if (!tp.hasParameter(i,'Z')) next.z = last.z;
+            if ( tp.hasParameter(i,'A')) a = tp.getParameter(i,'A');
+            if ( tp.hasParameter(i,'B')) b = tp.getParameter(i,'B');
+            if ( tp.hasParameter(i,'C')) c = tp.getParameter(i,'C');
 
             Base::Rotation nrot = yawPitchRoll(a, b, c);
 
@@ -585,17 +584,15 @@ void ViewProviderPath::updateVisual(bool rebuild) {
             } else if ( (name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
                 // arc
                 Base::Vector3d norm;
-                Base::Vector3d center;
+                Base::Vector3d center(tp.getParameter(i,'I'), tp.getParameter(i,'J'), tp.getParameter(i,'K'));
 
                 if ( (name == "G2") || (name == "G02") )
                     norm.*pz = -1.0;
                 else
                     norm.*pz = 1.0;
 
-                if (absolutecenter)
-                    center = cmd.getCenter();
-                else
-                    center = (last + cmd.getCenter());
+                if (!absolutecenter)
+                    center = (last + center);
                 Base::Vector3d next0(next);
                 next0.*pz = 0.0;
                 Base::Vector3d last0(last);
@@ -672,8 +669,8 @@ void ViewProviderPath::updateVisual(bool rebuild) {
             } else if ((name=="G81")||(name=="G82")||(name=="G83")||(name=="G84")||(name=="G85")||(name=="G86")||(name=="G89")){
                 // drill,tap,bore
                 double r = 0;
-                if (cmd.has("R"))
-                    r = cmd.getValue("R");
+                if (tp.hasParameter(i,'R'))
+                    r = tp.getParameter(i,'R');
 
                 Base::Vector3d p1(next);
                 p1.*pz = last.*pz;
@@ -714,8 +711,8 @@ void ViewProviderPath::updateVisual(bool rebuild) {
                 markers.push_back(rnext);
                 colorindex.push_back(1);
                 double q;
-                if (cmd.has("Q")) {
-                    q = cmd.getValue("Q");
+                if (tp.hasParameter(i,'Q')) {
+                    q = tp.getParameter(i,'Q');
                     if (q>0) {
                         Base::Vector3d temp(next);
                         for(temp.*pz=r;temp.*pz>next.*pz;temp.*pz-=q) {
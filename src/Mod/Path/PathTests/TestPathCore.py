@@ -126,6 +126,32 @@ G0 Z0.500000
         p.setFromGCode(lines)
         self.assertEqual (p.toGCode(), output)
 
+    def test15(self):
+        """Test editing the commands of a Path object"""
+
+        p = Path.Path()
+        p.setFromGCode("G20\nG0 X1 Y-0.5 (move)\nG21\nG1 X10 Z-1.5 F200\nM05\n")
+        self.assertEqual(p.Size, 4)
+        self.assertEqual(p.toGCode(), 'G0 X25.400000 Y-12.700000\n(move)\nG1 F200.000000 X10.000000 Z-1.500000\nM05\n')
+        self.assertEqual(str(p.Commands[1]), 'Command (move) [ ]')
+
+        p.insertCommand(Path.Command("G1", {"X": 1, "Y": 2}), 1)
+        self.assertEqual(p.Size, 5)
+        self.assertEqual(str(p.Commands[1]), 'Command G1 [ X:1 Y:2 ]')
+        self.assertEqual(str(p.Commands[3]), 'Command G1 [ F:200 X:10 Z:-1.5 ]')
+
+        p.deleteCommand(0)
+        p.deleteCommand()
+        self.assertEqual(str(p.Commands), '[Command G1 [ X:1 Y:2 ], Command (move) [ ], Command G1 [ F:200 X:10 Z:-1.5 ]]')
+
+        # parameters that aren't a single letter are kept as well
+        p.addCommands(Path.Command("G1", {"X": 3, "XA": 4}))
+        self.assertEqual(str(p.Commands[-1]), 'Command G1 [ X:3 XA:4 ]')
+        self.assertEqual(p.toGCode().splitlines()[-1], 'G1 X3.000000 XA4.000000')
+        p.insertCommand(Path.Command("G0", {"Z": 5}), 0)
+        self.assertEqual(str(p.Commands[-1]), 'Command G1 [ X:3 XA:4 ]')
+        self.assertAlmostEqual(p.Length, 5 + 30**0.5 + 87.25**0.5 + 51.25**0.5, places=6)
+
     def test20(self):
         """Test Path Tool and ToolTable object core functionality"""
 
@@ -26,6 +26,9 @@
 #ifdef FC_OS_LINUX
 # include <unistd.h>
 #endif
+# include <cmath>
+# include <cstring>
+# include <limits>
 # include <sstream>
 #endif
 
@@ -39,6 +42,7 @@
 #include <Base/Console.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
+#include <Base/Swap.h>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/regex.hpp>
@@ -46,6 +50,10 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
 
+#include <QFile>
+#include <QThread>
+#include <QtConcurrentMap>
+
 using namespace Points;
 
 void PointsAlgos::Load(PointKernel &points, const char *FileName)
@@ -214,7 +222,6 @@ public:
     virtual ~Converter() {
     }
     virtual std::string toString(float) const = 0;
-    virtual double toDouble(Base::InputStream&) const = 0;
     virtual int getSizeOf() const = 0;
 };
 template <typename T>
@@ -228,11 +235,6 @@ public:
         oss << c;
         return oss.str();
     }
-    virtual double toDouble(Base::InputStream& str) const {
-        T c;
-        str >> c;
-        return static_cast<double>(c);
-    }
     virtual int getSizeOf() const {
         return sizeof(T);
     }
@@ -240,73 +242,6 @@ public:
 
 typedef boost::shared_ptr<Converter> ConverterPtr;
 
-class DataStreambuf : public std::streambuf
-{
-public:
-    explicit DataStreambuf(const std::vector<char>& data) : _buffer(data) {
-        _beg = 0;
-        _end = data.size();
-        _cur = 0;
-    }
-    ~DataStreambuf() {
-    }
-
-protected:
-    virtual int_type uflow() {
-        if (_cur == _end)
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur++]) & 0x000000ff;
-    }
-    virtual int_type underflow() {
-        if (_cur == _end)
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur]) & 0x000000ff;
-    }
-    virtual int_type pbackfail(int_type ch) {
-        if (_cur == _beg || (ch != traits_type::eof() && ch != _buffer[_cur-1]))
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[--_cur]) & 0x000000ff;
-    }
-    virtual std::streamsize showmanyc() {
-        return _end - _cur;
-    }
-    virtual pos_type seekoff(std::streambuf::off_type off,
-        std::ios_base::seekdir way,
-        std::ios_base::openmode = 
-            std::ios::in | std::ios::out) {
-        int p_pos=-1;
-        if (way == std::ios_base::beg)
-            p_pos = _beg;
-        else if (way == std::ios_base::end)
-            p_pos = _end;
-        else if (way == std::ios_base::cur)
-            p_pos = _cur;
-
-        if (p_pos > _end)
-            return traits_type::eof();
-
-        if (((p_pos + off) > _end) || ((p_pos + off) < _beg))
-            return traits_type::eof();
-
-        _cur = p_pos+ off;
-
-        return ((p_pos+off) - _beg);
-    }
-    virtual pos_type seekpos(std::streambuf::pos_type pos,
-        std::ios_base::openmode which =
-        std::ios::in | std::ios::out) {
-        (void)which;
-        return seekoff(pos, std::ios_base::beg);
-    }
-
-private:
-    const std::vector<char>& _buffer;
-    int _beg, _end, _cur;
-};
-
 //Taken from https://github.com/PointCloudLibrary/pcl/blob/master/io/src/lzf.cpp
 unsigned int 
 lzfDecompress (const void *const in_data,  unsigned int in_len,
@@ -491,6 +426,431 @@ lzfDecompress (const void *const in_data,  unsigned int in_len,
 
   return (static_cast<unsigned int> (op - static_cast<unsigned char*> (out_data)));
 }
+
+// Gives access to the content of a file. The file is mapped into memory if
+// possible, otherwise it is read into a buffer.
+class FileData
+{
+public:
+    explicit FileData(const std::string& filename)
+        : file(QString::fromUtf8(filename.c_str())), ptr(0), len(0)
+    {
+        uchar* mapped = 0;
+        if (file.size() > 0 && file.open(QIODevice::ReadOnly))
+            mapped = file.map(0, file.size());
+        if (mapped) {
+            ptr = reinterpret_cast<const char*>(mapped);
+            len = static_cast<std::size_t>(file.size());
+        }
+        else {
+            Base::FileInfo fi(filename);
+            Base::ifstream inp(fi, std::ios::in | std::ios::binary);
+            buffer.assign(std::istreambuf_iterator<char>(inp), std::istreambuf_iterator<char>());
+            ptr = buffer.empty() ? 0 : &buffer[0];
+            len = buffer.size();
+        }
+    }
+    const char* data() const {
+        return ptr;
+    }
+    std::size_t size() const {
+        return len;
+    }
+
+private:
+    QFile file;
+    std::vector<char> buffer;
+    const char* ptr;
+    std::size_t len;
+};
+
+// A property of the vertex data that is decoded straight into one of the
+// float arrays of a reader. Properties without a target are skipped.
+struct Column
+{
+    Column() : type('F'), size(4), start(0), stride(0), token(0)
+             , target(0), step(1), norm(1.0f), packed(false) {
+    }
+
+    char type;          // 'I', 'U' or 'F' as for pcd files
+    int size;           // number of bytes of a value
+    std::size_t start;  // byte offset of the first value of binary data
+    std::size_t stride; // byte distance of two values of binary data
+    std::size_t token;  // index of the value in a line of ascii data
+    float* target;      // destination of the value of the first point
+    std::size_t step;   // number of floats between the values of two points
+    float norm;         // the value is divided by this number
+    bool packed;        // a color with 8 bits per channel packed as 0xaarrggbb
+};
+
+std::size_t findField(const std::vector<std::string>& fields, const char* name, const char* alias = 0)
+{
+    std::vector<std::string>::const_iterator it = std::find(fields.begin(), fields.end(), name);
+    if (it == fields.end() && alias)
+        it = std::find(fields.begin(), fields.end(), alias);
+    return static_cast<std::size_t>(std::distance(fields.begin(), it));
+}
+
+void checkType(const Column& col)
+{
+    bool ok = false;
+    switch (col.size) {
+    case 1:
+    case 2:
+        ok = (col.type == 'I' || col.type == 'U');
+        break;
+    case 4:
+        ok = (col.type == 'I' || col.type == 'U' || col.type == 'F');
+        break;
+    case 8:
+        ok = (col.type == 'F');
+        break;
+    }
+
+    if (!ok || (col.packed && col.size != 4))
+        throw Base::BadFormatError("Unexpected type");
+}
+
+inline void unpackColor(uint32_t packed, float* rgba)
+{
+    rgba[0] = static_cast<float>((packed >> 16) & 0xff) / 255.0f;
+    rgba[1] = static_cast<float>((packed >> 8) & 0xff) / 255.0f;
+    rgba[2] = static_cast<float>(packed & 0xff) / 255.0f;
+    rgba[3] = static_cast<float>((packed >> 24) & 0xff) / 255.0f;
+}
+
+inline void storeValue(const Column& col, std::size_t row, double value)
+{
+    float* dst = col.target + row * col.step;
+    if (col.packed) {
+        uint32_t packed;
+        if (col.type == 'F') {
+            float f = static_cast<float>(value);
+            std::memcpy(&packed, &f, sizeof(packed));
+        }
+        else {
+            packed = static_cast<uint32_t>(value);
+        }
+        unpackColor(packed, dst);
+    }
+    else {
+        *dst = static_cast<float>(value) / col.norm;
+    }
+}
+
+template <typename T>
+void decodeValues(const char* data, const Column& col, std::size_t first, std::size_t last, bool swap)
+{
+    const char* src = data + col.start + first * col.stride;
+    float* dst = col.target + first * col.step;
+    for (std::size_t i = first; i < last; i++) {
+        T value;
+        std::memcpy(&value, src, sizeof(T));
+        if (swap)
+            Base::SwapEndian(value);
+        *dst = static_cast<float>(value) / col.norm;
+        src += col.stride;
+        dst += col.step;
+    }
+}
+
+void decodePacked(const char* data, const Column& col, std::size_t first, std::size_t last, bool swap)
+{
+    const char* src = data + col.start + first * col.stride;
+    float* dst = col.target + first * col.step;
+    for (std::size_t i = first; i < last; i++) {
+        uint32_t packed;
+        std::memcpy(&packed, src, sizeof(packed));
+        if (swap)
+            Base::SwapEndian(packed);
+        unpackColor(packed, dst);
+        src += col.stride;
+        dst += col.step;
+    }
+}
+
+void decodeColumn(const char* data, const Column& col, std::size_t first, std::size_t last, bool swap)
+{
+    if (col.packed) {
+        decodePacked(data, col, first, last, swap);
+        return;
+    }
+
+    switch (col.size) {
+    case 1:
+        if (col.type == 'I')
+            decodeValues<int8_t>(data, col, first, last, swap);
+        else
+            decodeValues<uint8_t>(data, col, first, last, swap);
+        break;
+    case 2:
+        if (col.type == 'I')
+            decodeValues<int16_t>(data, col, first, last, swap);
+        else
+            decodeValues<uint16_t>(data, col, first, last, swap);
+        break;
+    case 4:
+        if (col.type == 'F')
+            decodeValues<float>(data, col, first, last, swap);
+        else if (col.type == 'I')
+            decodeValues<int32_t>(data, col, first, last, swap);
+        else
+            decodeValues<uint32_t>(data, col, first, last, swap);
+        break;
+    case 8:
+        decodeValues<double>(data, col, first, last, swap);
+        break;
+    }
+}
+
+// Decodes the given columns of binary data. The points are split into ranges
+// that are handled in parallel.
+void decodeBinary(const char* data, const std::vector<Column>& columns, std::size_t numPoints, bool swap)
+{
+    std::size_t numRanges = static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1)) * 4;
+    std::size_t rangeSize = std::max<std::size_t>(numPoints / numRanges + 1, 4096);
+    std::vector<std::pair<std::size_t, std::size_t> > ranges;
+    for (std::size_t i = 0; i < numPoints; i += rangeSize)
+        ranges.push_back(std::make_pair(i, std::min(i + rangeSize, numPoints)));
+
+    QtConcurrent::blockingMap(ranges, [&](const std::pair<std::size_t, std::size_t>& range) {
+        for (std::vector<Column>::const_iterator it = columns.begin(); it != columns.end(); ++it)
+            decodeColumn(data, *it, range.first, range.second, swap);
+    });
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool matchWord(const char* it, const char* end, const char* word)
+{
+    for (; *word; ++word, ++it) {
+        if (it == end || (*it | 0x20) != *word)
+            return false;
+    }
+    return true;
+}
+
+// Parses a decimal number independent of the C locale. The digits are
+// accumulated as an integer that is scaled by a power of ten at the end,
+// which is exact for up to 15 significant digits and 22 decimal places.
+// Returns the position after the number or 'begin' if there is no number.
+const char* parseNumber(const char* begin, const char* end, double& value)
+{
+    static const double powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* it = begin;
+    bool negative = false;
+    if (it != end && (*it == '-' || *it == '+')) {
+        negative = (*it == '-');
+        ++it;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    for (; it != end && isDigit(*it); ++it) {
+        hasDigits = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*it - '0');
+            if (mantissa > 0)
+                digits++;
+        }
+        else {
+            exponent++;
+        }
+    }
+    if (it != end && *it == '.') {
+        for (++it; it != end && isDigit(*it); ++it) {
+            hasDigits = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*it - '0');
+                if (mantissa > 0)
+                    digits++;
+                exponent--;
+            }
+        }
+    }
+
+    if (!hasDigits) {
+        if (matchWord(it, end, "nan")) {
+            value = std::numeric_limits<double>::quiet_NaN();
+            return it + 3;
+        }
+        if (matchWord(it, end, "inf")) {
+            value = negative ? -std::numeric_limits<double>::infinity()
+                             :  std::numeric_limits<double>::infinity();
+            return matchWord(it, end, "infinity") ? it + 8 : it + 3;
+        }
+        return begin;
+    }
+
+    if (it != end && (*it == 'e' || *it == 'E')) {
+        const char* exp = it + 1;
+        bool negExp = false;
+        if (exp != end && (*exp == '-' || *exp == '+')) {
+            negExp = (*exp == '-');
+            ++exp;
+        }
+        if (exp != end && isDigit(*exp)) {
+            int e = 0;
+            for (; exp != end && isDigit(*exp); ++exp) {
+                if (e < 10000)
+                    e = e * 10 + (*exp - '0');
+            }
+            exponent += negExp ? -e : e;
+            it = exp;
+        }
+    }
+
+    double result = static_cast<double>(mantissa);
+    if (exponent < 0)
+        result = exponent >= -22 ? result / powers[-exponent] : result * std::pow(10.0, exponent);
+    else if (exponent > 0)
+        result = exponent <= 22 ? result * powers[exponent] : result * std::pow(10.0, exponent);
+    value = negative ? -result : result;
+    return it;
+}
+
+// A block of complete lines of ascii data
+struct TextChunk
+{
+    const char* begin;
+    const char* end;
+    std::size_t lines;     // number of non-empty lines
+    std::size_t firstLine; // index of the first non-empty line in the data
+    bool failed;
+};
+
+std::size_t countLines(const char* it, const char* end)
+{
+    std::size_t lines = 0;
+    while (it < end) {
+        const char* eol = static_cast<const char*>(std::memchr(it, '\n', end - it));
+        if (!eol)
+            eol = end;
+        while (it < eol && isBlank(*it))
+            ++it;
+        if (it < eol)
+            lines++;
+        it = eol + 1;
+    }
+    return lines;
+}
+
+void parseChunk(TextChunk& chunk, const std::vector<Column>& columns,
+                std::size_t skip, std::size_t numPoints)
+{
+    std::size_t line = chunk.firstLine;
+    const char* it = chunk.begin;
+    while (it < chunk.end) {
+        const char* eol = static_cast<const char*>(std::memchr(it, '\n', chunk.end - it));
+        if (!eol)
+            eol = chunk.end;
+        while (it < eol && isBlank(*it))
+            ++it;
+        if (it == eol) {
+            it = eol + 1;
+            continue;
+        }
+
+        if (line >= skip) {
+            std::size_t row = line - skip;
+            if (row >= numPoints)
+                return;
+
+            // only the tokens of the used columns are parsed
+            std::size_t token = 0;
+            std::vector<Column>::const_iterator col = columns.begin();
+            while (it < eol && col != columns.end()) {
+                const char* next = it;
+                while (next < eol && !isBlank(*next))
+                    ++next;
+                if (token == col->token) {
+                    double value;
+                    if (parseNumber(it, next, value) != next) {
+                        chunk.failed = true;
+                        return;
+                    }
+                    storeValue(*col, row, value);
+                    ++col;
+                }
+
+                ++token;
+                it = next;
+                while (it < eol && isBlank(*it))
+                    ++it;
+            }
+        }
+
+        ++line;
+        it = eol + 1;
+    }
+}
+
+// Decodes the given columns of ascii data where the first 'skip' non-empty lines
+// are ignored. The text is split into blocks of lines that are parsed in parallel.
+void decodeAscii(const char* begin, const char* end, const std::vector<Column>& columns,
+                 std::size_t skip, std::size_t numPoints)
+{
+    std::size_t numChunks = static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1)) * 4;
+    std::size_t chunkSize = std::max<std::size_t>(static_cast<std::size_t>(end - begin) / numChunks + 1, 65536);
+    std::vector<TextChunk> chunks;
+    while (begin < end) {
+        const char* stop = begin + std::min<std::size_t>(chunkSize, static_cast<std::size_t>(end - begin));
+        if (stop < end) {
+            const char* eol = static_cast<const char*>(std::memchr(stop, '\n', end - stop));
+            stop = eol ? eol + 1 : end;
+        }
+        TextChunk chunk = {begin, stop, 0, 0, false};
+        chunks.push_back(chunk);
+        begin = stop;
+    }
+
+    // the row of the first line of each block is known after counting the lines
+    QtConcurrent::blockingMap(chunks, [](TextChunk& chunk) {
+        chunk.lines = countLines(chunk.begin, chunk.end);
+    });
+
+    std::size_t lines = 0;
+    for (std::vector<TextChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+        it->firstLine = lines;
+        lines += it->lines;
+    }
+
+    QtConcurrent::blockingMap(chunks, [&](TextChunk& chunk) {
+        if (chunk.firstLine < skip + numPoints)
+            parseChunk(chunk, columns, skip, numPoints);
+    });
+
+    for (std::vector<TextChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+        if (it->failed)
+            throw Base::BadFormatError("Invalid number in ascii data");
+    }
+}
+
+// Copies the columns with a target. This keeps the order of the columns which
+// is needed to parse ascii data.
+std::vector<Column> usedColumns(const std::vector<Column>& columns)
+{
+    std::vector<Column> used;
+    for (std::vector<Column>::const_iterator it = columns.begin(); it != columns.end(); ++it) {
+        if (it->target)
+            used.push_back(*it);
+    }
+    return used;
+}
 }
 
 PlyReader::PlyReader()
@@ -507,8 +867,9 @@ void PlyReader::read(const std::string& filename)
     this->width = 1;
     this->height = 0;
 
-    Base::FileInfo fi(filename);
-    Base::ifstream inp(fi, std::ios::in | std::ios::binary);
+    FileData file(filename);
+    Base::MemoryIStreambuf buf(file.data(), file.size());
+    std::istream inp(&buf);
 
     std::string format;
     std::vector<std::string> fields;
@@ -516,141 +877,114 @@ void PlyReader::read(const std::string& filename)
     std::vector<int> sizes;
     std::size_t offset = 0;
     std::size_t numPoints = readHeader(inp, format, offset, fields, types, sizes);
-
-    Eigen::MatrixXd data(numPoints, fields.size());
-    if (format == "ascii") {
-        readAscii(inp, offset, data);
-    }
-    else if (format == "binary_little_endian") {
-        readBinary(false, inp, offset, types, sizes, data);
-    }
-    else if (format == "binary_big_endian") {
-        readBinary(true, inp, offset, types, sizes, data);
-    }
-
-    std::vector<std::string>::iterator it;
-    std::size_t max_size = std::numeric_limits<std::size_t>::max();
-
-    // x field
-    std::size_t x = max_size;
-    it = std::find(fields.begin(), fields.end(), "x");
-    if (it != fields.end())
-        x = std::distance(fields.begin(), it);
-
-    // y field
-    std::size_t y = max_size;
-    it = std::find(fields.begin(), fields.end(), "y");
-    if (it != fields.end())
-        y = std::distance(fields.begin(), it);
-
-    // z field
-    std::size_t z = max_size;
-    it = std::find(fields.begin(), fields.end(), "z");
-    if (it != fields.end())
-        z = std::distance(fields.begin(), it);
-
-    // normal x field
-    std::size_t normal_x = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_x");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nx");
-    if (it != fields.end())
-        normal_x = std::distance(fields.begin(), it);
-
-    // normal y field
-    std::size_t normal_y = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_y");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "ny");
-    if (it != fields.end())
-        normal_y = std::distance(fields.begin(), it);
-
-    // normal z field
-    std::size_t normal_z = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_z");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nz");
-    if (it != fields.end())
-        normal_z = std::distance(fields.begin(), it);
-
-    // intensity field
-    std::size_t greyvalue = max_size;
-    it = std::find(fields.begin(), fields.end(), "intensity");
-    if (it != fields.end())
-        greyvalue = std::distance(fields.begin(), it);
-
-    // rgb(a) field
-    std::size_t red = max_size, green = max_size, blue = max_size, alpha = max_size;
-    it = std::find(fields.begin(), fields.end(), "red");
-    if (it != fields.end())
-        red = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "green");
-    if (it != fields.end())
-        green = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "blue");
-    if (it != fields.end())
-        blue = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "alpha");
-    if (it != fields.end())
-        alpha = std::distance(fields.begin(), it);
-
-    // transfer the data
-    bool hasData = (x != max_size && y != max_size && z != max_size);
-    bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
-    bool hasIntensity = (greyvalue != max_size);
-    bool hasColor = (red != max_size && green != max_size && blue != max_size);
-
-    if (hasData) {
-        points.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i,x),data(i,y),data(i,z)));
+    std::size_t dataStart = buf.tell();
+
+    // the header has already checked the type names
+    std::vector<Column> columns(fields.size());
+    std::size_t recordSize = 0;
+    for (std::size_t i=0; i<fields.size(); i++) {
+        const std::string& t = types[i];
+        Column& col = columns[i];
+        if (t == "float" || t == "float32" || t == "double" || t == "float64")
+            col.type = 'F';
+        else if (t[0] == 'u')
+            col.type = 'U';
+        else
+            col.type = 'I';
+        col.size = sizes[i];
+        col.start = dataStart + offset + recordSize;
+        col.token = i;
+        recordSize += static_cast<std::size_t>(sizes[i]);
+    }
+
+    bool ascii = (format == "ascii");
+    if (!ascii) {
+        for (std::vector<Column>::iterator it = columns.begin(); it != columns.end(); ++it) {
+            checkType(*it);
+            it->stride = recordSize;
         }
-    }
 
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            normals.push_back(Base::Vector3f(data(i,normal_x),data(i,normal_y),data(i,normal_z)));
-        }
+        std::size_t available = dataStart + offset < file.size() ? file.size() - dataStart - offset : 0;
+        if (numPoints > 0 && (recordSize == 0 || numPoints > available / recordSize))
+            throw Base::BadFormatError("File expects too many elements");
     }
 
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            intensity.push_back(data(i,greyvalue));
-        }
+    std::size_t numFields = fields.size();
+    std::size_t x = findField(fields, "x");
+    std::size_t y = findField(fields, "y");
+    std::size_t z = findField(fields, "z");
+    std::size_t normal_x = findField(fields, "normal_x", "nx");
+    std::size_t normal_y = findField(fields, "normal_y", "ny");
+    std::size_t normal_z = findField(fields, "normal_z", "nz");
+    std::size_t greyvalue = findField(fields, "intensity");
+    std::size_t red = findField(fields, "red");
+    std::size_t green = findField(fields, "green");
+    std::size_t blue = findField(fields, "blue");
+    std::size_t alpha = findField(fields, "alpha");
+
+    bool hasData = (x < numFields && y < numFields && z < numFields);
+    bool hasNormal = (normal_x < numFields && normal_y < numFields && normal_z < numFields);
+    bool hasIntensity = (greyvalue < numFields);
+    bool hasColor = (red < numFields && green < numFields && blue < numFields);
+    if (!hasData || numPoints == 0)
+        return;
+
+    // let the columns point directly to the arrays of the reader
+    const std::size_t vecStep = sizeof(Base::Vector3f) / sizeof(float);
+    std::vector<Base::Vector3f>& pts = points.getBasicPoints();
+    pts.resize(numPoints);
+    columns[x].target = &pts[0].x;
+    columns[y].target = &pts[0].y;
+    columns[z].target = &pts[0].z;
+    columns[x].step = columns[y].step = columns[z].step = vecStep;
+
+    if (hasNormal) {
+        normals.resize(numPoints);
+        columns[normal_x].target = &normals[0].x;
+        columns[normal_y].target = &normals[0].y;
+        columns[normal_z].target = &normals[0].z;
+        columns[normal_x].step = columns[normal_y].step = columns[normal_z].step = vecStep;
     }
 
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        float a = 1.0;
-        if (types[red] == "uchar") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                float r = data(i, red);
-                float g = data(i, green);
-                float b = data(i, blue);
-                if (alpha != max_size)
-                    a = data(i, alpha);
-                colors.push_back(App::Color(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f));
-            }
-        }
-        else if (types[red] == "float") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                float r = data(i, red);
-                float g = data(i, green);
-                float b = data(i, blue);
-                if (alpha != max_size)
-                    a = data(i, alpha);
-                colors.push_back(App::Color(r, g, b, a));
+    if (hasIntensity) {
+        intensity.resize(numPoints);
+        columns[greyvalue].target = &intensity[0];
+    }
+
+    if (hasColor) {
+        float norm = 0.0f;
+        if (types[red] == "uchar" || types[red] == "uint8")
+            norm = 255.0f;
+        else if (types[red] == "float" || types[red] == "float32")
+            norm = 1.0f;
+
+        if (norm > 0.0f) {
+            const std::size_t colStep = sizeof(App::Color) / sizeof(float);
+            colors.resize(numPoints, App::Color(0.0f, 0.0f, 0.0f, 1.0f / norm));
+            columns[red].target = &colors[0].r;
+            columns[green].target = &colors[0].g;
+            columns[blue].target = &colors[0].b;
+            if (alpha < numFields)
+                columns[alpha].target = &colors[0].a;
+
+            std::size_t channels[] = {red, green, blue, alpha};
+            for (std::size_t i=0; i<4; i++) {
+                if (channels[i] < numFields) {
+                    columns[channels[i]].step = colStep;
+                    columns[channels[i]].norm = norm;
+                }
             }
         }
     }
+
+    if (ascii) {
+        decodeAscii(file.data() + dataStart, file.data() + file.size(),
+                    usedColumns(columns), offset, numPoints);
+    }
+    else {
+        decodeBinary(file.data(), usedColumns(columns), numPoints,
+                     format == "binary_big_endian");
+    }
 }
 
 std::size_t PlyReader::readHeader(std::istream& in,
@@ -821,121 +1155,6 @@ std::size_t PlyReader::readHeader(std::istream& in,
     return numPoints;
 }
 
-void PlyReader::readAscii(std::istream& inp, std::size_t offset, Eigen::MatrixXd& data)
-{
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        if (offset > 0) {
-            offset--;
-            continue;
-        }
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
-}
-
-void PlyReader::readBinary(bool swapByteOrder,
-                           std::istream& inp,
-                           std::size_t offset,
-                           const std::vector<std::string>& types,
-                           const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
-{
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (std::size_t j=0; j<numFields; j++) {
-        std::string t = types[j];
-        switch (sizes[j]) {
-        case 1:
-            if (t == "char" || t == "int8")
-                converters.push_back(convert_int8);
-            else if (t == "uchar" || t == "uint8")
-                converters.push_back(convert_uint8);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 2:
-            if (t == "short" || t == "int16")
-                converters.push_back(convert_int16);
-            else if (t == "ushort" || t == "uint16")
-                converters.push_back(convert_uint16);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 4:
-            if (t == "int" || t == "int32")
-                converters.push_back(convert_int32);
-            else if (t == "uint" || t == "uint32")
-                converters.push_back(convert_uint32);
-            else if (t == "float" || t == "float32")
-                converters.push_back(convert_float32);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 8:
-            if (t == "double" || t == "float64")
-                converters.push_back(convert_float64);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        default:
-            throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
-    }
-
-    std::streamoff ulSize = 0;
-    std::streamoff ulCurr = 0;
-    std::streambuf* buf = inp.rdbuf();
-    if (buf) {
-        ulCurr = buf->pubseekoff(static_cast<std::streamoff>(offset), std::ios::cur, std::ios::in);
-        ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-        buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize*static_cast<std::streamoff>(numPoints) > ulSize)
-            throw Base::BadFormatError("File expects too many elements");
-    }
-
-    Base::InputStream str(inp);
-    str.setByteOrder(swapByteOrder ? Base::Stream::BigEndian : Base::Stream::LittleEndian);
-    for (std::size_t i=0; i<numPoints; i++) {
-        for (std::size_t j=0; j<numFields; j++) {
-            double value = converters[j]->toDouble(str);
-            data(i, j) = value;
-        }
-    }
-}
-
 // ----------------------------------------------------------------------------
 
 PcdReader::PcdReader()
@@ -952,162 +1171,116 @@ void PcdReader::read(const std::string& filename)
     this->width = -1;
     this->height = -1;
 
-    Base::FileInfo fi(filename);
-    Base::ifstream inp(fi, std::ios::in | std::ios::binary);
+    FileData file(filename);
+    Base::MemoryIStreambuf buf(file.data(), file.size());
+    std::istream inp(&buf);
 
     std::string format;
     std::vector<std::string> fields;
     std::vector<std::string> types;
     std::vector<int> sizes;
     std::size_t numPoints = readHeader(inp, format, fields, types, sizes);
+    std::size_t dataStart = buf.tell();
 
-    Eigen::MatrixXd data(numPoints, fields.size());
-    if (format == "ascii") {
-        readAscii(inp, data);
-    }
-    else if (format == "binary") {
-        readBinary(false, inp, types, sizes, data);
+    std::size_t numFields = fields.size();
+    std::size_t x = findField(fields, "x");
+    std::size_t y = findField(fields, "y");
+    std::size_t z = findField(fields, "z");
+    std::size_t normal_x = findField(fields, "normal_x", "nx");
+    std::size_t normal_y = findField(fields, "normal_y", "ny");
+    std::size_t normal_z = findField(fields, "normal_z", "nz");
+    std::size_t greyvalue = findField(fields, "intensity");
+    std::size_t rgba = findField(fields, "rgb", "rgba");
+
+    bool hasData = (x < numFields && y < numFields && z < numFields);
+    bool hasNormal = (normal_x < numFields && normal_y < numFields && normal_z < numFields);
+    bool hasIntensity = (greyvalue < numFields);
+    bool hasColor = (rgba < numFields && (types[rgba] == "U" || types[rgba] == "F"));
+
+    std::vector<Column> columns(numFields);
+    std::size_t recordSize = 0;
+    for (std::size_t i=0; i<numFields; i++) {
+        Column& col = columns[i];
+        col.type = types[i].empty() ? ' ' : types[i][0];
+        col.size = sizes[i];
+        col.start = recordSize;
+        col.token = i;
+        col.packed = (hasColor && i == rgba);
+        recordSize += static_cast<std::size_t>(sizes[i]);
+    }
+
+    // the binary data is either stored point by point or, if compressed, field by field
+    const char* data = file.data();
+    std::vector<char> uncompressed;
+    if (format == "binary") {
+        std::size_t available = dataStart < file.size() ? file.size() - dataStart : 0;
+        if (numPoints > 0 && (recordSize == 0 || numPoints > available / recordSize))
+            throw Base::BadFormatError("File expects too many elements");
+        for (std::vector<Column>::iterator it = columns.begin(); it != columns.end(); ++it) {
+            checkType(*it);
+            it->start += dataStart;
+            it->stride = recordSize;
+        }
     }
     else if (format == "binary_compressed") {
-        unsigned int c, u;
-        Base::InputStream str(inp);
-        str >> c >> u;
-
-        std::vector<char> compressed(c);
-        inp.read(&compressed[0], c);
-        std::vector<char> uncompressed(u);
-        if (lzfDecompress(&compressed[0], c, &uncompressed[0], u) == u) {
-            DataStreambuf ibuf(uncompressed);
-            std::istream istr(0);
-            istr.rdbuf(&ibuf);
-            readBinary(true, istr, types, sizes, data);
+        uint32_t c = 0, u = 0;
+        if (dataStart + 8 <= file.size()) {
+            std::memcpy(&c, data + dataStart, sizeof(c));
+            std::memcpy(&u, data + dataStart + 4, sizeof(u));
         }
-        else {
+
+        uncompressed.resize(u);
+        if (dataStart + 8 + c > file.size() || u == 0 ||
+            lzfDecompress(data + dataStart + 8, c, &uncompressed[0], u) != u) {
             throw Base::BadFormatError("Failed to decompress binary data");
         }
-    }
 
-    std::vector<std::string>::iterator it;
-    std::size_t max_size = std::numeric_limits<std::size_t>::max();
-
-    // x field
-    std::size_t x = max_size;
-    it = std::find(fields.begin(), fields.end(), "x");
-    if (it != fields.end())
-        x = std::distance(fields.begin(), it);
-
-    // y field
-    std::size_t y = max_size;
-    it = std::find(fields.begin(), fields.end(), "y");
-    if (it != fields.end())
-        y = std::distance(fields.begin(), it);
-
-    // z field
-    std::size_t z = max_size;
-    it = std::find(fields.begin(), fields.end(), "z");
-    if (it != fields.end())
-        z = std::distance(fields.begin(), it);
-
-    // normal x field
-    std::size_t normal_x = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_x");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nx");
-    if (it != fields.end())
-        normal_x = std::distance(fields.begin(), it);
-
-    // normal y field
-    std::size_t normal_y = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_y");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "ny");
-    if (it != fields.end())
-        normal_y = std::distance(fields.begin(), it);
-
-    // normal z field
-    std::size_t normal_z = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_z");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nz");
-    if (it != fields.end())
-        normal_z = std::distance(fields.begin(), it);
-
-    // intensity field
-    std::size_t greyvalue = max_size;
-    it = std::find(fields.begin(), fields.end(), "intensity");
-    if (it != fields.end())
-        greyvalue = std::distance(fields.begin(), it);
-
-    // rgb(a) field
-    std::size_t rgba = max_size;
-    it = std::find(fields.begin(), fields.end(), "rgb");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "rgba");
-    if (it != fields.end())
-        rgba = std::distance(fields.begin(), it);
-
-    // transfer the data
-    bool hasData = (x != max_size && y != max_size && z != max_size);
-    bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
-    bool hasIntensity = (greyvalue != max_size);
-    bool hasColor = (rgba != max_size);
-
-    if (hasData) {
-        points.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i,x),data(i,y),data(i,z)));
+        if (numPoints > 0 && (recordSize == 0 || numPoints > u / recordSize))
+            throw Base::BadFormatError("File expects too many elements");
+        data = &uncompressed[0];
+        for (std::vector<Column>::iterator it = columns.begin(); it != columns.end(); ++it) {
+            checkType(*it);
+            it->start *= numPoints;
+            it->stride = static_cast<std::size_t>(it->size);
         }
     }
 
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            normals.push_back(Base::Vector3f(data(i,normal_x),data(i,normal_y),data(i,normal_z)));
-        }
+    if (!hasData || numPoints == 0)
+        return;
+
+    // let the columns point directly to the arrays of the reader
+    const std::size_t vecStep = sizeof(Base::Vector3f) / sizeof(float);
+    std::vector<Base::Vector3f>& pts = points.getBasicPoints();
+    pts.resize(numPoints);
+    columns[x].target = &pts[0].x;
+    columns[y].target = &pts[0].y;
+    columns[z].target = &pts[0].z;
+    columns[x].step = columns[y].step = columns[z].step = vecStep;
+
+    if (hasNormal) {
+        normals.resize(numPoints);
+        columns[normal_x].target = &normals[0].x;
+        columns[normal_y].target = &normals[0].y;
+        columns[normal_z].target = &normals[0].z;
+        columns[normal_x].step = columns[normal_y].step = columns[normal_z].step = vecStep;
     }
 
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            intensity.push_back(data(i,greyvalue));
-        }
+    if (hasIntensity) {
+        intensity.resize(numPoints);
+        columns[greyvalue].target = &intensity[0];
     }
 
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        if (types[rgba] == "U") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                uint32_t packed = static_cast<uint32_t>(data(i,rgba));
-                uint32_t a = (packed >> 24) & 0xff;
-                uint32_t r = (packed >> 16) & 0xff;
-                uint32_t g = (packed >> 8) & 0xff;
-                uint32_t b = packed & 0xff;
-                colors.push_back(App::Color(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f));
-            }
-        }
-        else if (types[rgba] == "F") {
-            union RGBA {
-                uint32_t u;
-                float f;
-            };
+    if (hasColor) {
+        colors.resize(numPoints);
+        columns[rgba].target = &colors[0].r;
+        columns[rgba].step = sizeof(App::Color) / sizeof(float);
+    }
 
-            union RGBA v;
-            for (std::size_t i=0; i<numPoints; i++) {
-                v.f = static_cast<float>(data(i,rgba));
-                uint32_t packed = v.u;
-                uint32_t a = (packed >> 24) & 0xff;
-                uint32_t r = (packed >> 16) & 0xff;
-                uint32_t g = (packed >> 8) & 0xff;
-                uint32_t b = packed & 0xff;
-                colors.push_back(App::Color(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f));
-            }
-        }
+    if (format == "ascii") {
+        decodeAscii(data + dataStart, data + file.size(), usedColumns(columns), 0, numPoints);
+    }
+    else if (format == "binary" || format == "binary_compressed") {
+        decodeBinary(data, usedColumns(columns), numPoints, false);
     }
 }
 
@@ -1183,124 +1356,6 @@ std::size_t PcdReader::readHeader(std::istream& in,
     return points;
 }
 
-void PcdReader::readAscii(std::istream& inp, Eigen::MatrixXd& data)
-{
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
-}
-
-void PcdReader::readBinary(bool transpose,
-                           std::istream& inp,
-                           const std::vector<std::string>& types,
-                           const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
-{
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (std::size_t j=0; j<numFields; j++) {
-        char t = types[j][0];
-        switch (sizes[j]) {
-        case 1:
-            if (t == 'I')
-                converters.push_back(convert_int8);
-            else if (t == 'U')
-                converters.push_back(convert_uint8);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 2:
-            if (t == 'I')
-                converters.push_back(convert_int16);
-            else if (t == 'U')
-                converters.push_back(convert_uint16);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 4:
-            if (t == 'I')
-                converters.push_back(convert_int32);
-            else if (t == 'U')
-                converters.push_back(convert_uint32);
-            else if (t == 'F')
-                converters.push_back(convert_float32);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 8:
-            if (t == 'F')
-                converters.push_back(convert_float64);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        default:
-            throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
-    }
-
-    std::streamoff ulSize = 0;
-    std::streamoff ulCurr = 0;
-    std::streambuf* buf = inp.rdbuf();
-    if (buf) {
-        ulCurr = buf->pubseekoff(0, std::ios::cur, std::ios::in);
-        ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-        buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize*static_cast<std::streamoff>(numPoints) > ulSize)
-            throw Base::BadFormatError("File expects too many elements");
-    }
-
-    Base::InputStream str(inp);
-    if (transpose) {
-        for (std::size_t j=0; j<numFields; j++) {
-            for (std::size_t i=0; i<numPoints; i++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
-    }
-    else {
-        for (std::size_t i=0; i<numPoints; i++) {
-            for (std::size_t j=0; j<numFields; j++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
-    }
-}
-
 // ----------------------------------------------------------------------------
 
 Writer::Writer(const PointKernel& p) : points(p)
@@ -42,18 +42,45 @@ using namespace Points;
 TYPESYSTEM_SOURCE(Points::PropertyPointKernel , App::PropertyComplexGeoData)
 
 PropertyPointKernel::PropertyPointKernel()
-    : _cPoints(new PointKernel())
+    : _cPoints(new PointKernel()), pointsPyObject(0)
 {
 
 }
 
 PropertyPointKernel::~PropertyPointKernel()
 {
+    if (pointsPyObject) {
+        // Note: Do not call setInvalid() of the Python binding
+        // because the points should still be accessible afterwards.
+        Py_DECREF(pointsPyObject);
+    }
+}
+
+/**
+ * Makes sure that the points are not shared with a copy of this property
+ * before they get modified. If \a copy is false the caller replaces the
+ * points anyway, so only the transformation is kept.
+ */
+void PropertyPointKernel::detachPoints(bool copy)
+{
+    if (_cPoints.getRefCount() > 1) {
+        if (copy) {
+            _cPoints = new PointKernel(*_cPoints);
+        }
+        else {
+            Base::Matrix4D mat = _cPoints->getTransform();
+            _cPoints = new PointKernel();
+            _cPoints->setTransform(mat);
+        }
+        if (pointsPyObject)
+            pointsPyObject->_pcTwinPointer = static_cast<PointKernel*>(_cPoints);
+    }
 }
 
 void PropertyPointKernel::setValue(const PointKernel& m)
 {
     aboutToSetValue();
+    detachPoints(false);
     *_cPoints = m;
     hasSetValue();
 }
@@ -63,6 +90,14 @@ const PointKernel& PropertyPointKernel::getValue(void) const
     return *_cPoints;
 }
 
+void PropertyPointKernel::setTransform(const Base::Matrix4D& rclTrf)
+{
+    if (_cPoints->getTransform() != rclTrf) {
+        detachPoints(true);
+        _cPoints->setTransform(rclTrf);
+    }
+}
+
 const Data::ComplexGeoData* PropertyPointKernel::getComplexData() const
 {
     return _cPoints;
@@ -75,9 +110,13 @@ Base::BoundBox3d PropertyPointKernel::getBoundingBox() const
 
 PyObject *PropertyPointKernel::getPyObject(void)
 {
-    PointsPy* points = new PointsPy(&*_cPoints);
-    points->setConst(); // set immutable
-    return points;
+    if (!pointsPyObject) {
+        pointsPyObject = new PointsPy(&*_cPoints);
+        pointsPyObject->setConst(); // set immutable
+    }
+
+    Py_INCREF(pointsPyObject);
+    return pointsPyObject;
 }
 
 void PropertyPointKernel::setPyObject(PyObject *value)
@@ -114,6 +153,7 @@ void PropertyPointKernel::Restore(Base::XMLReader &reader)
         mtrx.fromString(Matrix);
 
         aboutToSetValue();
+        detachPoints(true);
         _cPoints->setTransform(mtrx);
         hasSetValue();
     }
@@ -128,14 +168,16 @@ void PropertyPointKernel::SaveDocFile (Base::Writer &writer) const
 void PropertyPointKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    detachPoints(false);
     _cPoints->RestoreDocFile(reader);
     hasSetValue();
 }
 
 App::Property *PropertyPointKernel::Copy(void) const 
 {
+    // Note: Reference the same points, they are copied on modification
     PropertyPointKernel* prop = new PropertyPointKernel();
-    (*prop->_cPoints) = (*this->_cPoints);
+    prop->_cPoints = this->_cPoints;
     return prop;
 }
 
@@ -143,18 +185,22 @@ void PropertyPointKernel::Paste(const App::Property &from)
 {
     aboutToSetValue();
     const PropertyPointKernel& prop = dynamic_cast<const PropertyPointKernel&>(from);
-    *(this->_cPoints) = *(prop._cPoints);
+    this->_cPoints = prop._cPoints;
+    if (pointsPyObject)
+        pointsPyObject->_pcTwinPointer = static_cast<PointKernel*>(_cPoints);
     hasSetValue();
 }
 
 unsigned int PropertyPointKernel::getMemSize (void) const
 {
-    return sizeof(Base::Vector3f) * this->_cPoints->size();
+    // points shared with copies of this property are accounted to each of them in parts
+    return sizeof(Base::Vector3f) * this->_cPoints->size() / std::max(_cPoints.getRefCount(), 1);
 }
 
 PointKernel* PropertyPointKernel::startEditing()
 {
     aboutToSetValue();
+    detachPoints(true);
     return static_cast<PointKernel*>(_cPoints);
 }
 
@@ -194,6 +240,7 @@ void PropertyPointKernel::removeIndices( const std::vector<unsigned long>& uIndi
 void PropertyPointKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
     aboutToSetValue();
+    detachPoints(true);
     _cPoints->transformGeometry(rclMat);
     hasSetValue();
 }
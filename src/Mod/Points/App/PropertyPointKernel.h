@@ -28,6 +28,7 @@
 
 namespace Points
 {
+class PointsPy;
 
 /** The point kernel property
  */
@@ -45,6 +46,8 @@ public:
     void setValue( const PointKernel& m);
     /// get the points (only const possible!)
     const PointKernel &getValue(void) const;
+    /// Sets the transformation of the points without notifying the container
+    void setTransform(const Base::Matrix4D& rclTrf);
     const Data::ComplexGeoData* getComplexData() const;
     //@}
 
@@ -63,6 +66,7 @@ public:
     /** @name Undo/Redo */
     //@{
     /// returns a new copy of the property (mainly for Undo/Redo and transactions)
+    /// that shares the points until one of both gets modified
     App::Property *Copy(void) const;
     /// paste the value from the property (mainly for Undo/Redo and transactions)
     void Paste(const App::Property &from);
@@ -86,8 +90,12 @@ public:
     void removeIndices( const std::vector<unsigned long>& );
     //@}
 
+private:
+    void detachPoints(bool copy);
+
 private:
     Base::Reference<PointKernel> _cPoints;
+    PointsPy* pointsPyObject;
 };
 
 } // namespace Points
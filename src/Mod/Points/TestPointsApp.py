@@ -0,0 +1,240 @@
+#**************************************************************************
+#   Copyright (c) 2026 FreeCAD Developers                                 *
+#                                                                         *
+#   This file is part of the FreeCAD CAx development system.              *
+#                                                                         *
+#   This program is free software; you can redistribute it and/or modify  *
+#   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#   as published by the Free Software Foundation; either version 2 of     *
+#   the License, or (at your option) any later version.                   *
+#   for detail see the LICENCE text file.                                 *
+#                                                                         *
+#   FreeCAD is distributed in the hope that it will be useful,            *
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#   GNU Library General Public License for more details.                  *
+#                                                                         *
+#   You should have received a copy of the GNU Library General Public     *
+#   License along with FreeCAD; if not, write to the Free Software        *
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#   USA                                                                   *
+#**************************************************************************
+
+import FreeCAD, os, struct, tempfile, unittest, Points
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FreeCAD Points module
+#---------------------------------------------------------------------------
+
+# enough points to split the data into several blocks
+NumPoints = 5000
+
+
+def makePoint(i):
+    return (i * 0.5, -i * 0.25, float(i % 7))
+
+def makeNormal(i):
+    return (0.0, 0.0, 1.0) if i % 2 else (1.0, 0.0, 0.0)
+
+def makeIntensity(i):
+    return (i % 64) / 4.0
+
+def makeColor(i):
+    return (i % 256, (3 * i) % 256, (7 * i) % 256)
+
+def lzfLiterals(data):
+    # a valid LZF stream that only consists of literal runs
+    out = bytearray()
+    for i in range(0, len(data), 32):
+        chunk = data[i:i+32]
+        out.append(len(chunk) - 1)
+        out += chunk
+    return bytes(out)
+
+
+class PointsReadCases(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("PointsTest")
+        self.Files = []
+
+    def writeFile(self, name, header, data):
+        fileName = os.path.join(tempfile.gettempdir(), name)
+        self.Files.append(fileName)
+        with open(fileName, "wb") as f:
+            f.write(header.encode("ascii"))
+            f.write(data)
+        return fileName
+
+    def importFile(self, fileName):
+        count = len(self.Doc.Objects)
+        Points.insert(fileName, self.Doc.Name)
+        self.assertEqual(len(self.Doc.Objects), count + 1)
+        return self.Doc.Objects[-1]
+
+    def checkCloud(self, obj, hasNormals=True, hasIntensity=True, hasColors=True):
+        pts = obj.Points.Points
+        self.assertEqual(len(pts), NumPoints)
+        for i in range(NumPoints):
+            self.assertEqual(tuple(pts[i]), makePoint(i))
+        if hasNormals:
+            nor = obj.Normal
+            self.assertEqual(len(nor), NumPoints)
+            for i in range(NumPoints):
+                self.assertEqual(tuple(nor[i]), makeNormal(i))
+        if hasIntensity:
+            grey = obj.Intensity
+            self.assertEqual(len(grey), NumPoints)
+            for i in range(NumPoints):
+                self.assertEqual(grey[i], makeIntensity(i))
+        if hasColors:
+            col = obj.Color
+            self.assertEqual(len(col), NumPoints)
+            for i in range(NumPoints):
+                rgb = tuple(int(round(c * 255.0)) for c in col[i][0:3])
+                self.assertEqual(rgb, makeColor(i))
+
+    def plyHeader(self, format, coord):
+        return ("ply\n"
+                "format {} 1.0\n"
+                "comment FreeCAD test\n"
+                "element vertex {}\n"
+                "property {} x\n"
+                "property {} y\n"
+                "property {} z\n"
+                "property float nx\n"
+                "property float ny\n"
+                "property float nz\n"
+                "property uchar red\n"
+                "property uchar green\n"
+                "property uchar blue\n"
+                "property float intensity\n"
+                "end_header\n").format(format, NumPoints, coord, coord, coord)
+
+    def plyBinary(self, byteorder, coord):
+        fmt = byteorder + 3 * coord + "fffBBBf"
+        data = bytearray()
+        for i in range(NumPoints):
+            data += struct.pack(fmt, *(makePoint(i) + makeNormal(i) + makeColor(i) + (makeIntensity(i),)))
+        return bytes(data)
+
+    def pcdHeader(self, format):
+        return ("# .PCD v0.7 - Point Cloud Data file format\n"
+                "VERSION 0.7\n"
+                "FIELDS x y z normal_x normal_y normal_z rgb intensity\n"
+                "SIZE 4 4 4 4 4 4 4 4\n"
+                "TYPE F F F F F F U F\n"
+                "COUNT 1 1 1 1 1 1 1 1\n"
+                "WIDTH {}\n"
+                "HEIGHT 1\n"
+                "VIEWPOINT 0 0 0 1 0 0 0\n"
+                "POINTS {}\n"
+                "DATA {}\n").format(NumPoints, NumPoints, format)
+
+    def pcdValues(self, i):
+        r, g, b = makeColor(i)
+        return makePoint(i) + makeNormal(i) + ((r << 16) | (g << 8) | b, makeIntensity(i))
+
+    def testPlyAscii(self):
+        lines = []
+        for i in range(NumPoints):
+            values = makePoint(i) + makeNormal(i) + makeColor(i) + (makeIntensity(i),)
+            lines.append(" ".join(repr(v) for v in values))
+        data = ("\n".join(lines) + "\n").encode("ascii")
+        fileName = self.writeFile("PointsTestAscii.ply", self.plyHeader("ascii", "float"), data)
+        self.checkCloud(self.importFile(fileName))
+
+    def testPlyBinaryLittleEndian(self):
+        data = self.plyBinary("<", "f")
+        fileName = self.writeFile("PointsTestLE.ply", self.plyHeader("binary_little_endian", "float"), data)
+        self.checkCloud(self.importFile(fileName))
+
+    def testPlyBinaryBigEndian(self):
+        data = self.plyBinary(">", "d")
+        fileName = self.writeFile("PointsTestBE.ply", self.plyHeader("binary_big_endian", "double"), data)
+        self.checkCloud(self.importFile(fileName))
+
+    def testPcdAscii(self):
+        lines = []
+        for i in range(NumPoints):
+            lines.append(" ".join(repr(v) for v in self.pcdValues(i)))
+        data = ("\n".join(lines) + "\n").encode("ascii")
+        fileName = self.writeFile("PointsTestAscii.pcd", self.pcdHeader("ascii"), data)
+        self.checkCloud(self.importFile(fileName))
+
+    def testPcdBinary(self):
+        data = bytearray()
+        for i in range(NumPoints):
+            data += struct.pack("<ffffffIf", *self.pcdValues(i))
+        fileName = self.writeFile("PointsTestBinary.pcd", self.pcdHeader("binary"), bytes(data))
+        self.checkCloud(self.importFile(fileName))
+
+    def testPcdBinaryCompressed(self):
+        # the compressed data is stored field by field
+        values = [self.pcdValues(i) for i in range(NumPoints)]
+        data = bytearray()
+        for field, code in enumerate("ffffffIf"):
+            data += struct.pack("<{}{}".format(NumPoints, code), *[v[field] for v in values])
+        compressed = lzfLiterals(bytes(data))
+        data = struct.pack("<II", len(compressed), len(data)) + compressed
+        fileName = self.writeFile("PointsTestCompressed.pcd", self.pcdHeader("binary_compressed"), data)
+        self.checkCloud(self.importFile(fileName))
+
+    def testExportImport(self):
+        pts = Points.Points()
+        pts.addPoints([FreeCAD.Vector(*makePoint(i)) for i in range(NumPoints)])
+        cloud = self.Doc.addObject("Points::FeatureCustom", "Cloud")
+        cloud.Points = pts
+        cloud.addProperty("Points::PropertyGreyValueList", "Intensity")
+        cloud.Intensity = [makeIntensity(i) for i in range(NumPoints)]
+        for ext in ("ply", "pcd"):
+            fileName = os.path.join(tempfile.gettempdir(), "PointsTestExport." + ext)
+            self.Files.append(fileName)
+            Points.export([cloud], fileName)
+            self.checkCloud(self.importFile(fileName), hasNormals=False, hasColors=False)
+
+    def testPythonObjectFollowsUndo(self):
+        # the Python object of the property must follow the points, which are
+        # shared with the undo steps
+        self.Doc.UndoMode = 1
+        cloud = self.Doc.addObject("Points::Feature", "Cloud")
+        pts = Points.Points()
+        pts.addPoints([FreeCAD.Vector(*makePoint(i)) for i in range(3)])
+        cloud.Points = pts
+        py = cloud.Points
+
+        self.Doc.openTransaction("Change")
+        pts.addPoints([FreeCAD.Vector(*makePoint(i)) for i in range(3, 5)])
+        cloud.Points = pts
+        self.Doc.commitTransaction()
+        self.assertEqual(py.CountPoints, 5)
+        self.Doc.undo()
+        self.assertEqual(py.CountPoints, 3)
+        self.Doc.redo()
+        self.assertEqual(py.CountPoints, 5)
+
+    def testPlacementUndo(self):
+        # moving the cloud must not move the points kept by the undo steps
+        self.Doc.UndoMode = 1
+        cloud = self.Doc.addObject("Points::Feature", "Cloud")
+        pts = Points.Points()
+        pts.addPoints([FreeCAD.Vector(*makePoint(i)) for i in range(3)])
+        cloud.Points = pts
+
+        self.Doc.openTransaction("Change")
+        pts.addPoints([FreeCAD.Vector(*makePoint(i)) for i in range(3, 5)])
+        cloud.Points = pts
+        self.Doc.commitTransaction()
+        self.Doc.undo()
+        cloud.Placement = FreeCAD.Placement(FreeCAD.Vector(10, 0, 0), FreeCAD.Rotation())
+        self.Doc.redo()
+        self.assertEqual(cloud.Points.CountPoints, 5)
+        self.assertEqual(cloud.Placement.Base, FreeCAD.Vector(0, 0, 0))
+        self.Doc.undo()
+        self.assertEqual(cloud.Points.CountPoints, 3)
+        self.assertEqual(cloud.Placement.Base, FreeCAD.Vector(10, 0, 0))
+
+    def tearDown(self):
+        FreeCAD.closeDocument("PointsTest")
+        for fileName in self.Files:
+            if os.path.exists(fileName):
+                os.remove(fileName)
@@ -68,7 +68,7 @@ Sketch::Sketch()
   : SolveTime(0)
   , RecalculateInitialSolutionWhileMovingPoint(false)
   , GCSsys(), ConstraintsCounter(0)
-  , isInitMove(false), isFine(true), moveStep(0)
+  , isInitMove(false), isMoveSolved(false), isFine(true), moveStep(0)
   , defaultSolver(GCS::DogLeg)
   , defaultSolverRedundant(GCS::DogLeg)
   , debugMode(GCS::Minimal)
@@ -114,6 +114,7 @@ void Sketch::clear(void)
 
     GCSsys.clear();
     isInitMove = false;
+    isMoveSolved = false;
     ConstraintsCounter = 0;
     Conflicting.clear();
 }
@@ -3108,7 +3109,12 @@ int Sketch::solve(void)
 
     if(isInitMove){
         solvername = "DogLeg"; // DogLeg is used for dragging (same as before)
-        ret = GCSsys.solve(isFine, GCS::DogLeg);
+        // once the whole sketch is solved for the move, the following steps of the
+        // drag only solve the dragged clusters, starting from the last solution
+        if (isMoveSolved)
+            ret = GCSsys.solveDragged(isFine, GCS::DogLeg);
+        else
+            ret = GCSsys.solve(isFine, GCS::DogLeg);
     }
     else{
         switch (defaultSolver) {
@@ -3141,6 +3147,8 @@ int Sketch::solve(void)
         }
         else {
             updateNonDrivingConstraints();
+            if (isInitMove)
+                isMoveSolved = true;
         }
     }
     else {
@@ -3248,6 +3256,7 @@ int Sketch::initMove(int geoId, PointPos pos, bool fine)
     // don't try to move sketches that contain conflicting constraints
     if (hasConflicts()) {
         isInitMove = false;
+        isMoveSolved = false;
         return -1;
     }
 
@@ -3514,12 +3523,14 @@ int Sketch::initMove(int geoId, PointPos pos, bool fine)
 
     GCSsys.initSolution();
     isInitMove = true;
+    isMoveSolved = false;
     return 0;
 }
 
 void Sketch::resetInitMove()
 {
     isInitMove = false;
+    isMoveSolved = false;
 }
 
 int Sketch::movePoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative)
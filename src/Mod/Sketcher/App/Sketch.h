@@ -425,6 +425,7 @@ protected:
     std::vector<GCS::BSpline> BSplines;
 
     bool isInitMove;
+    bool isMoveSolved; // the sketch has been solved once since initMove
     bool isFine;
     Base::Vector3d initToPoint;
     double moveStep;
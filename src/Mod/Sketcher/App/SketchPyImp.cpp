@@ -203,6 +203,24 @@ Py::Object SketchPy::getShape(void) const
     return Py::Object(new TopoShapePy(new TopoShape(getSketchPtr()->toShape())));
 }
 
+Py::Long SketchPy::getQRAlgorithm(void) const
+{
+    return Py::Long(static_cast<int>(getSketchPtr()->getQRAlgorithm()));
+}
+
+void SketchPy::setQRAlgorithm(Py::Long arg)
+{
+    #if PY_MAJOR_VERSION < 3
+    int alg = Py::Int(arg);
+    #else
+    int alg = arg;
+    #endif
+
+    if (alg != GCS::EigenDenseQR && alg != GCS::EigenSparseQR)
+        throw Py::ValueError("QR algorithm must be 0 (dense) or 1 (sparse)");
+    getSketchPtr()->setQRAlgorithm(static_cast<GCS::QRAlgorithm>(alg));
+}
+
 
 // +++ custom attributes implementer ++++++++++++++++++++++++++++++++++++++++
 
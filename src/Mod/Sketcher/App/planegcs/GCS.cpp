@@ -52,6 +52,14 @@
 #include <algorithm>
 #include <cfloat>
 #include <limits>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+#include <QRunnable>
+#include <QThreadPool>
 
 #include "GCS.h"
 #include "qp_eq.h"
@@ -1516,27 +1524,116 @@ int System::solve(VEC_pD &params, bool isFine, Algorithm alg, bool isRedundantso
     return solve(isFine, alg, isRedundantsolving);
 }
 
-int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
+namespace {
+
+// Thread pool job solving independent subsystems
+class SolveJob : public QRunnable
 {
-    if (!isInit)
-        return Failed;
+public:
+    SolveJob(std::function<void()> &&func)
+        : func(std::move(func))
+    {
+        setAutoDelete(true);
+    }
+    virtual void run() override {
+        func();
+    }
 
-    bool isReset = false;
+private:
+    std::function<void()> func;
+};
+
+} // namespace
+
+int System::solveCluster(int cid, bool isFine, Algorithm alg, bool isRedundantsolving)
+{
+    if (subSystems[cid] && subSystemsAux[cid])
+        return solve(subSystems[cid], subSystemsAux[cid], isFine, isRedundantsolving);
+    else if (subSystems[cid])
+        return solve(subSystems[cid], isFine, alg, isRedundantsolving);
+    else if (subSystemsAux[cid])
+        return solve(subSystemsAux[cid], isFine, alg, isRedundantsolving);
+    return Success;
+}
+
+int System::solveClusters(const VEC_I &cids, bool isFine, Algorithm alg, bool isRedundantsolving)
+{
     // return success by default in order to permit coincidence constraints to be applied
     // even if no other system has to be solved
-    int res = Success;
-    for (int cid=0; cid < int(subSystems.size()); cid++) {
-        if ((subSystems[cid] || subSystemsAux[cid]) && !isReset) {
-             resetToReference();
-             isReset = true;
+    VEC_I results(subSystems.size(), Success);
+
+    // The clusters share no parameters or constraints, so they can be solved
+    // concurrently. The iteration level debug output is kept sequential.
+    QThreadPool *pool = QThreadPool::globalInstance();
+    int threads = std::min(pool->maxThreadCount(), int(cids.size()));
+    bool concurrent = threads > 1 && debugMode != IterationLevel;
+#ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
+    concurrent = false;
+#endif
+    if (!concurrent) {
+        for (int cid : cids)
+            results[cid] = solveCluster(cid, isFine, alg, isRedundantsolving);
+    }
+    else {
+        // The calling thread takes part in the work, so that solving proceeds even if
+        // the pool is busy, e.g. when the sketch is recomputed in a pool thread itself.
+        // Exceptions are rethrown on the calling thread like in the sequential case.
+        std::vector<std::exception_ptr> errors(subSystems.size());
+        std::atomic<int> next(0);
+        auto work = [&]() {
+            for (int i=next++; i < int(cids.size()); i=next++) {
+                int cid = cids[i];
+                try {
+                    results[cid] = solveCluster(cid, isFine, alg, isRedundantsolving);
+                }
+                catch (...) {
+                    errors[cid] = std::current_exception();
+                    // do not start solving further clusters
+                    next = int(cids.size());
+                }
+            }
+        };
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        int running = 0;
+        for (int i=1; i < threads; ++i) {
+            SolveJob *job = new SolveJob([&]() {
+                work();
+                std::lock_guard<std::mutex> lock(mutex);
+                --running;
+                cond.notify_one();
+            });
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++running;
+            }
+            // do not queue the job behind other work, it would block this thread
+            if (!pool->tryStart(job)) {
+                delete job;
+                std::lock_guard<std::mutex> lock(mutex);
+                --running;
+                break;
+            }
+        }
+
+        work();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&running]() {return running == 0;});
+        lock.unlock();
+
+        for (int cid : cids) {
+            if (errors[cid])
+                std::rethrow_exception(errors[cid]);
         }
-        if (subSystems[cid] && subSystemsAux[cid])
-            res = std::max(res, solve(subSystems[cid], subSystemsAux[cid], isFine, isRedundantsolving));
-        else if (subSystems[cid])
-            res = std::max(res, solve(subSystems[cid], isFine, alg, isRedundantsolving));
-        else if (subSystemsAux[cid])
-            res = std::max(res, solve(subSystemsAux[cid], isFine, alg, isRedundantsolving));
     }
+
+    // merge the results in cluster order
+    int res = Success;
+    for (int cid=0; cid < int(results.size()); cid++)
+        res = std::max(res, results[cid]);
+
     if (res == Success) {
         for (std::set<Constraint *>::const_iterator constr=redundant.begin();
              constr != redundant.end(); ++constr){
@@ -1553,6 +1650,41 @@ int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
     return res;
 }
 
+int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
+{
+    if (!isInit)
+        return Failed;
+
+    VEC_I cids;
+    for (int cid=0; cid < int(subSystems.size()); cid++) {
+        if (subSystems[cid] || subSystemsAux[cid])
+            cids.push_back(cid);
+    }
+    if (!cids.empty())
+        resetToReference();
+
+    return solveClusters(cids, isFine, alg, isRedundantsolving);
+}
+
+int System::solveDragged(bool isFine, Algorithm alg)
+{
+    if (!isInit)
+        return Failed;
+
+    // Only the clusters holding the negatively tagged move constraints can change.
+    // They start from the current, i.e. the previous solution, which also becomes
+    // the reference restored by undoSolution().
+    setReference();
+
+    VEC_I cids;
+    for (int cid=0; cid < int(subSystemsAux.size()); cid++) {
+        if (subSystemsAux[cid])
+            cids.push_back(cid);
+    }
+
+    return solveClusters(cids, isFine, alg, false);
+}
+
 int System::solve(SubSystem *subsys, bool isFine, Algorithm alg, bool isRedundantsolving)
 {
     if (alg == BFGS)
@@ -1688,8 +1820,130 @@ int System::solve_BFGS(SubSystem *subsys, bool /*isFine*/, bool isRedundantsolvi
     return Failed;
 }
 
+// Large subsystems are solved with a sparse jacobi matrix by the Levenberg-Marquardt
+// and DogLeg solvers. A constraint depends on a few parameters only, so the dense
+// matrices mostly consist of zeros and become slow at some thousand parameters.
+static const int SparseSolverMinSize = 200;
+
+namespace {
+
+// The helpers below let the solvers work on dense and sparse matrices
+
+// Sets the diagonal of the normal equations A to diag+mu
+void setDiagonal(Eigen::MatrixXd &A, const Eigen::VectorXd &diag, double mu)
+{
+    for (int i=0; i < A.rows(); ++i)
+        A(i,i) = diag(i) + mu;
+}
+
+// Solves the augmented normal equations A*h=g of Levenberg-Marquardt
+void solveNormalEquations(const Eigen::MatrixXd &A, const Eigen::VectorXd &g, Eigen::VectorXd &h)
+{
+    h = A.fullPivLu().solve(g);
+}
+
+// Computes the Gauss-Newton step of DogLeg, i.e. solves J*h=-fx
+void solveGaussNewton(const Eigen::MatrixXd &J, const Eigen::VectorXd &fx,
+                      Eigen::VectorXd &h, DogLegGaussStep step)
+{
+    // http://forum.freecadweb.org/viewtopic.php?f=10&t=12769&start=50#p106220
+    // https://forum.kde.org/viewtopic.php?f=74&t=129439#p346104
+    switch (step){
+        case FullPivLU:
+            h = J.fullPivLu().solve(-fx);
+            break;
+        case LeastNormFullPivLU:
+            h = J.adjoint()*(J*J.adjoint()).fullPivLu().solve(-fx);
+            break;
+        case LeastNormLdlt:
+            h = J.adjoint()*(J*J.adjoint()).ldlt().solve(-fx);
+            break;
+    }
+}
+
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+void setDiagonal(Eigen::SparseMatrix<double> &A, const Eigen::VectorXd &diag, double mu)
+{
+    for (int i=0; i < A.rows(); ++i)
+        A.coeffRef(i,i) = diag(i) + mu;
+    A.makeCompressed();
+}
+
+void solveNormalEquations(const Eigen::SparseMatrix<double> &A, const Eigen::VectorXd &g, Eigen::VectorXd &h)
+{
+    // A is symmetric and positive definite due to the damping
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > ldlt(A);
+    if (ldlt.info() == Eigen::Success)
+        h = ldlt.solve(g);
+    else
+        h.setZero(A.cols());
+}
+
+void solveGaussNewton(const Eigen::SparseMatrix<double> &J, const Eigen::VectorXd &fx,
+                      Eigen::VectorXd &h, DogLegGaussStep step)
+{
+    if (step == LeastNormLdlt) {
+        Eigen::SparseMatrix<double> JJT = J*J.transpose();
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > ldlt(JJT);
+        h = J.transpose()*ldlt.solve(-fx);
+        return;
+    }
+
+    // Least norm solution with the QR decomposition J^T.P = Q.R, which also
+    // copes with redundant constraints: R^T.Q^T.h = P^T.(-fx)
+    Eigen::SparseMatrix<double> JT = J.transpose();
+    JT.makeCompressed();
+    Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > qr(JT);
+    if (qr.info() != Eigen::Success) {
+        h.setZero(J.cols());
+        return;
+    }
+
+    int rank = static_cast<int>(qr.rank());
+    Eigen::VectorXd b = qr.colsPermutation().transpose()*(-fx);
+
+    // R may have unsorted inner indices, so its leading block is copied by hand
+    const Eigen::SparseMatrix<double> &R = qr.matrixR();
+    std::vector<Eigen::Triplet<double> > triplets;
+    for (int k=0; k < R.outerSize(); ++k) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(R,k); it; ++it) {
+            if (it.row() < rank && it.col() < rank)
+                triplets.push_back(Eigen::Triplet<double>(it.col(), it.row(), it.value()));
+        }
+    }
+    Eigen::SparseMatrix<double> RT(rank, rank);
+    RT.setFromTriplets(triplets.begin(), triplets.end());
+
+    Eigen::VectorXd z = Eigen::VectorXd::Zero(J.cols());
+    z.head(rank) = RT.triangularView<Eigen::Lower>().solve(b.head(rank));
+    h = qr.matrixQ()*z;
+}
+#endif
+
+} // namespace
+
+bool System::useSparseSolver(SubSystem *subsys) const
+{
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    return qrAlgorithm == EigenSparseQR && subsys->pSize() >= SparseSolverMinSize;
+#else
+    (void)subsys;
+    return false;
+#endif
+}
+
 int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 {
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    if (useSparseSolver(subsys))
+        return solve_LM_impl<Eigen::SparseMatrix<double> >(subsys, isRedundantsolving);
+#endif
+    return solve_LM_impl<Eigen::MatrixXd>(subsys, isRedundantsolving);
+}
+
+template <class MatrixType>
+int System::solve_LM_impl(SubSystem* subsys, bool isRedundantsolving)
+{
 #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
     extractSubsystem(subsys, isRedundantsolving);
 #endif
@@ -1701,8 +1955,8 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         return Success;
 
     Eigen::VectorXd e(csize), e_new(csize); // vector of all function errors (every constraint is one function)
-    Eigen::MatrixXd J(csize, xsize);        // Jacobi of the subsystem
-    Eigen::MatrixXd A(xsize, xsize);
+    MatrixType J(csize, xsize);             // Jacobi of the subsystem
+    MatrixType A(xsize, xsize);
     Eigen::VectorXd x(xsize), h(xsize), x_new(xsize), g(xsize), diag_A(xsize);
 
     subsys->redirectParams();
@@ -1774,11 +2028,10 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         int k=0;
         while (k < 50) {
             // augment normal equations A = A+uI
-            for (int i=0; i < xsize; ++i)
-                A(i,i) += mu;
+            setDiagonal(A, diag_A, mu);
 
             //solve augmented functions A*h=-g
-            h = A.fullPivLu().solve(g);
+            solveNormalEquations(A, g, h);
             double rel_error = (A*h - g).norm() / g.norm();
 
             // check if solving works
@@ -1826,8 +2079,7 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 
             mu*=nu;
             nu*=2.0;
-            for (int i=0; i < xsize; ++i) // restore diagonal J^T J entries
-                A(i,i) = diag_A(i);
+            setDiagonal(A, diag_A, 0.); // restore diagonal J^T J entries
 
             k++;
         }
@@ -1860,6 +2112,16 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 
 int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
 {
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    if (useSparseSolver(subsys))
+        return solve_DL_impl<Eigen::SparseMatrix<double> >(subsys, isRedundantsolving);
+#endif
+    return solve_DL_impl<Eigen::MatrixXd>(subsys, isRedundantsolving);
+}
+
+template <class MatrixType>
+int System::solve_DL_impl(SubSystem* subsys, bool isRedundantsolving)
+{
 #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
     extractSubsystem(subsys, isRedundantsolving);
 #endif
@@ -1895,7 +2157,7 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
 
     Eigen::VectorXd x(xsize), x_new(xsize);
     Eigen::VectorXd fx(csize), fx_new(csize);
-    Eigen::MatrixXd Jx(csize, xsize), Jx_new(csize, xsize);
+    MatrixType Jx(csize, xsize), Jx_new(csize, xsize);
     Eigen::VectorXd g(xsize), h_sd(xsize), h_gn(xsize), h_dl(xsize);
 
     subsys->redirectParams();
@@ -1937,19 +2199,7 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
             h_sd  = alpha*g;
 
             // get the gauss-newton step
-            // http://forum.freecadweb.org/viewtopic.php?f=10&t=12769&start=50#p106220
-            // https://forum.kde.org/viewtopic.php?f=74&t=129439#p346104
-            switch (dogLegGaussStep){
-                case FullPivLU:
-                    h_gn = Jx.fullPivLu().solve(-fx);
-                    break;
-                case LeastNormFullPivLU:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).fullPivLu().solve(-fx);
-                    break;
-                case LeastNormLdlt:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).ldlt().solve(-fx);
-                    break;
-            }
+            solveGaussNewton(Jx, fx, h_gn, dogLegGaussStep);
 
             double rel_error = (Jx*h_gn + fx).norm() / fx.norm();
             if (rel_error > 1e15)
@@ -3779,22 +4029,25 @@ void System::undoSolution()
     resetToReference();
 }
 
-void System::makeReducedJacobian(Eigen::MatrixXd &J,
+void System::makeReducedJacobian(Eigen::SparseMatrix<double> &J,
                                  std::map<int,int> &jacobianconstraintmap,
                                  GCS::VEC_pD &pdiagnoselist,
                                  std::map< int , int> &tagmultiplicity)
 {
     // construct specific parameter list for diagonose ignoring driven constraint parameters
+    MAP_pD_I pdiagnoseindex;
     for (int j=0; j < int(plist.size()); j++) {
         auto result1 = std::find(std::begin(pdrivenlist), std::end(pdrivenlist), plist[j]);
 
         if (result1 == std::end(pdrivenlist)) {
+            pdiagnoseindex[plist[j]] = pdiagnoselist.size();
             pdiagnoselist.push_back(plist[j]);
         }
     }
 
-
-    J = Eigen::MatrixXd::Zero(clist.size(), pdiagnoselist.size());
+    // only the parameters of a constraint can have a non-zero gradient, so the
+    // matrix is assembled from the constraint parameters instead of all parameters
+    std::vector<Eigen::Triplet<double> > triplets;
 
     int jacobianconstraintcount=0;
     int allcount=0;
@@ -3803,8 +4056,15 @@ void System::makeReducedJacobian(Eigen::MatrixXd &J,
         ++allcount;
         if ((*constr)->getTag() >= 0 && (*constr)->isDriving()) {
             jacobianconstraintcount++;
-            for (int j=0; j < int(pdiagnoselist.size()); j++) {
-                J(jacobianconstraintcount-1,j) = (*constr)->grad(pdiagnoselist[j]);
+            VEC_pD cparams = (*constr)->params();
+            SET_pD visited;
+            for (VEC_pD::const_iterator param=cparams.begin(); param != cparams.end(); ++param) {
+                MAP_pD_I::const_iterator index = pdiagnoseindex.find(*param);
+                if (index == pdiagnoseindex.end() || !visited.insert(*param).second)
+                    continue;
+                double value = (*constr)->grad(*param);
+                if (value != 0.)
+                    triplets.push_back(Eigen::Triplet<double>(jacobianconstraintcount-1, index->second, value));
             }
 
             // parallel processing: create tag multiplicity map
@@ -3816,6 +4076,10 @@ void System::makeReducedJacobian(Eigen::MatrixXd &J,
             jacobianconstraintmap[jacobianconstraintcount-1] = allcount-1;
         }
     }
+
+    J.resize(clist.size(), pdiagnoselist.size());
+    J.setFromTriplets(triplets.begin(), triplets.end());
+    J.makeCompressed();
 }
 
 int System::diagnose(Algorithm alg)
@@ -3864,7 +4128,7 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
     // The Jacobian has been reduced to:
     // 1. only contain driving constraints, but keep a full size (zero padded).
     // 2. remove the parameters of the values of driven constraints.
-    Eigen::MatrixXd J;
+    Eigen::SparseMatrix<double> SJ;
 
     // maps the index of the rows of the reduced jacobian matrix (solver constraints) to
     // the index those constraints would have in a full size Jacobian matrix
@@ -3878,21 +4142,11 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
     std::map< int , int> tagmultiplicity;
 
 
-    makeReducedJacobian(J, jacobianconstraintmap, pdiagnoselist, tagmultiplicity);
+    makeReducedJacobian(SJ, jacobianconstraintmap, pdiagnoselist, tagmultiplicity);
 
     // QR decomposition method selection: SparseQR vs DenseQR
 
 #ifdef EIGEN_SPARSEQR_COMPATIBLE
-    Eigen::SparseMatrix<double> SJ;
-
-    if(qrAlgorithm==EigenSparseQR){
-        // this creation is not optimized (done using triplets)
-        // however the time this takes is negligible compared to the
-        // time the QR decomposition itself takes
-        SJ = J.sparseView();
-        SJ.makeCompressed();
-    }
-
     Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > SqrJT;
 #else
     if(qrAlgorithm==EigenSparseQR){
@@ -3904,7 +4158,7 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
 
 
 #ifdef _GCS_DEBUG
-    SolverReportingManager::Manager().LogMatrix("J",J);
+    SolverReportingManager::Manager().LogMatrix("J",Eigen::MatrixXd(SJ));
 #endif
 
     Eigen::MatrixXd R;
@@ -3921,7 +4175,8 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
     Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrJT;
 
     if(qrAlgorithm==EigenDenseQR){
-        if (J.rows() > 0) {
+        if (SJ.rows() > 0) {
+            Eigen::MatrixXd J = SJ;
             qrJT.compute(J.topRows(jacobianconstraintmap.size()).transpose());
             //Eigen::MatrixXd Q = qrJT.matrixQ ();
 
@@ -3983,7 +4238,7 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
         SolverReportingManager::Manager().LogQRSystemInformation(*this, paramsNum, constrNum, rank);
     }
 
-    if (J.rows() > 0) {
+    if (SJ.rows() > 0) {
 #ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
         SolverReportingManager::Manager().LogMatrix("R", R);
 
@@ -103,11 +103,21 @@ namespace GCS
         bool hasDiagnosis; // if dofs, conflictingTags, redundantTags are up to date
         bool isInit;       // if plists, clists, reductionmaps are up to date
 
+        // solves the subsystems of the cluster cid
+        int solveCluster(int cid, bool isFine, Algorithm alg, bool isRedundantsolving);
+        // solves the clusters cids, concurrently if possible, and merges their results
+        int solveClusters(const VEC_I &cids, bool isFine, Algorithm alg, bool isRedundantsolving);
         int solve_BFGS(SubSystem *subsys, bool isFine=true, bool isRedundantsolving=false);
         int solve_LM(SubSystem *subsys, bool isRedundantsolving=false);
         int solve_DL(SubSystem *subsys, bool isRedundantsolving=false);
+        // MatrixType is the dense or sparse type of the jacobi matrix
+        template <class MatrixType>
+        int solve_LM_impl(SubSystem *subsys, bool isRedundantsolving);
+        template <class MatrixType>
+        int solve_DL_impl(SubSystem *subsys, bool isRedundantsolving);
+        bool useSparseSolver(SubSystem *subsys) const;
 
-        void makeReducedJacobian(Eigen::MatrixXd &J, std::map<int,int> &jacobianconstraintmap, GCS::VEC_pD &pdiagnoselist, std::map< int , int> &tagmultiplicity);
+        void makeReducedJacobian(Eigen::SparseMatrix<double> &J, std::map<int,int> &jacobianconstraintmap, GCS::VEC_pD &pdiagnoselist, std::map< int , int> &tagmultiplicity);
 
         #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
         void extractSubsystem(SubSystem *subsys, bool isRedundantsolving);
@@ -264,6 +274,9 @@ namespace GCS
         int solve(VEC_pD &params, bool isFine=true, Algorithm alg=DogLeg, bool isRedundantsolving=false);
         int solve(SubSystem *subsys, bool isFine=true, Algorithm alg=DogLeg, bool isRedundantsolving=false);
         int solve(SubSystem *subsysA, SubSystem *subsysB, bool isFine=true, bool isRedundantsolving=false);
+        // solves only the clusters of a point or curve drag, warm-started from the
+        // current parameter values (see Sketch::movePoint)
+        int solveDragged(bool isFine=true, Algorithm alg=DogLeg);
 
         void applySolution();
         void undoSolution();
@@ -107,8 +107,10 @@ void SubSystem::initialize(VEC_pD &params, MAP_pD_pD &reductionmap)
 
     c2p.clear();
     p2c.clear();
+    c2r.clear();
     for (std::vector<Constraint *>::iterator constr=clist.begin();
          constr != clist.end(); ++constr) {
+        c2r[*constr] = static_cast<int>(constr - clist.begin());
         (*constr)->revertParams(); // ensure that the constraint points to the original parameters
         VEC_pD constr_params_orig = (*constr)->params();
         SET_pD constr_params;
@@ -260,13 +262,17 @@ void SubSystem::calcJacobi()
 
 void SubSystem::calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi)
 {
+    // only the constraints that depend on a parameter have a non-zero gradient
     jacobi.setZero(csize, params.size());
     for (int j=0; j < int(params.size()); j++) {
         MAP_pD_pD::const_iterator
           pmapfind = pmap.find(params[j]);
-        if (pmapfind != pmap.end())
-            for (int i=0; i < csize; i++)
-                jacobi(i,j) = clist[i]->grad(pmapfind->second);
+        if (pmapfind != pmap.end()) {
+            std::vector<Constraint *> &constrs=p2c[pmapfind->second];
+            for (std::vector<Constraint *>::const_iterator constr = constrs.begin();
+                 constr != constrs.end(); ++constr)
+                jacobi(c2r[*constr],j) = (*constr)->grad(pmapfind->second);
+        }
     }
 }
 
@@ -275,6 +281,30 @@ void SubSystem::calcJacobi(Eigen::MatrixXd &jacobi)
     calcJacobi(plist, jacobi);
 }
 
+void SubSystem::calcJacobi(VEC_pD &params, Eigen::SparseMatrix<double> &jacobi)
+{
+    std::vector<Eigen::Triplet<double> > triplets;
+    for (int j=0; j < int(params.size()); j++) {
+        MAP_pD_pD::const_iterator
+          pmapfind = pmap.find(params[j]);
+        if (pmapfind != pmap.end()) {
+            std::vector<Constraint *> &constrs=p2c[pmapfind->second];
+            for (std::vector<Constraint *>::const_iterator constr = constrs.begin();
+                 constr != constrs.end(); ++constr)
+                triplets.push_back(Eigen::Triplet<double>(c2r[*constr], j,
+                                                          (*constr)->grad(pmapfind->second)));
+        }
+    }
+
+    jacobi.resize(csize, params.size());
+    jacobi.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+void SubSystem::calcJacobi(Eigen::SparseMatrix<double> &jacobi)
+{
+    calcJacobi(plist, jacobi);
+}
+
 void SubSystem::calcGrad(VEC_pD &params, Eigen::VectorXd &grad)
 {
     assert(grad.size() == int(params.size()));
@@ -20,7 +20,7 @@
 #**************************************************************************
 
 
-import FreeCAD, os, sys, unittest, Part, Sketcher
+import FreeCAD, math, os, sys, unittest, Part, Sketcher
 App = FreeCAD
 
 def CreateRectangleSketch(SketchFeature, corner, lengths):
@@ -210,6 +210,101 @@ class SketcherSolverTestCases(unittest.TestCase):
 		self.failUnless(len(values) == 0)
 		FreeCAD.closeDocument("Issue3245")
 	
+	def testIndependentClusters(self):
+		# disconnected profiles are solved as separate clusters, possibly concurrently
+		sketch = self.Doc.addObject('Sketcher::SketchObject','SketchClusters')
+		for i in range(16):
+			CreateRectangleSketch(sketch, [30.0*i, 10.0*(i%4)], [20.0, 5.0+i])
+		self.assertEqual(sketch.solve(), 0)
+		self.Doc.recompute()
+		self.assertEqual(len(sketch.Shape.Edges), 64)
+		for i in range(16):
+			line = sketch.Geometry[4*i]
+			self.assertAlmostEqual(line.StartPoint.y, 10.0*(i%4)+5.0+i, 6)
+			self.assertAlmostEqual(line.EndPoint.x, 30.0*i+20.0, 6)
+
+	def testLargeSketchSparseSolver(self):
+		# a connected sketch with more than 200 parameters is solved with sparse
+		# matrices if the sparse QR algorithm is selected
+		numLines = 120
+		target = [FreeCAD.Vector(0,0,0)]
+		for i in range(numLines):
+			angle = 0.3 if i%2 else -0.3
+			target.append(target[-1] + FreeCAD.Vector(10.0*math.cos(angle), 10.0*math.sin(angle), 0))
+
+		def solveChain(qrAlgorithm):
+			sketch = Sketcher.Sketch()
+			sketch.QRAlgorithm = qrAlgorithm
+			points = [p + FreeCAD.Vector(0.2*((3*i)%5-2), 0.2*((7*i)%5-2), 0) for i, p in enumerate(target)]
+			for i in range(numLines):
+				sketch.addGeometry(Part.LineSegment(points[i], points[i+1]))
+			for i in range(numLines-1):
+				sketch.addConstraint(Sketcher.Constraint('Coincident',i,2,i+1,1))
+			for i in range(numLines):
+				sketch.addConstraint(Sketcher.Constraint('Distance',i,10.0))
+				sketch.addConstraint(Sketcher.Constraint('Angle',i,0.3 if i%2 else -0.3))
+			sketch.addConstraint(Sketcher.Constraint('DistanceX',0,1,0.0))
+			sketch.addConstraint(Sketcher.Constraint('DistanceY',0,1,0.0))
+			self.assertEqual(sketch.solve(), 0)
+			return [line.EndPoint for line in sketch.Geometries]
+
+		dense = solveChain(0)
+		sparse = solveChain(1)
+		for i in range(numLines):
+			self.assertAlmostEqual(sparse[i].x, dense[i].x, 6)
+			self.assertAlmostEqual(sparse[i].y, dense[i].y, 6)
+			self.assertAlmostEqual(sparse[i].x, target[i+1].x, 6)
+			self.assertAlmostEqual(sparse[i].y, target[i+1].y, 6)
+
+	def testDragCluster(self):
+		# dragging a profile only solves its cluster, starting from the previous step
+		sketch = Sketcher.Sketch()
+		# the dragged profile: two lines of fixed length hinged at the origin
+		sketch.addGeometry(Part.LineSegment(FreeCAD.Vector(0,0,0),FreeCAD.Vector(10,0,0)))
+		sketch.addGeometry(Part.LineSegment(FreeCAD.Vector(10,0,0),FreeCAD.Vector(10,10,0)))
+		sketch.addConstraint(Sketcher.Constraint('Coincident',0,2,1,1))
+		sketch.addConstraint(Sketcher.Constraint('DistanceX',0,1,0.0))
+		sketch.addConstraint(Sketcher.Constraint('DistanceY',0,1,0.0))
+		sketch.addConstraint(Sketcher.Constraint('Distance',0,10.0))
+		sketch.addConstraint(Sketcher.Constraint('Distance',1,10.0))
+		# two other underconstrained profiles
+		sketch.addGeometry(Part.LineSegment(FreeCAD.Vector(50,0,0),FreeCAD.Vector(60,0,0)))
+		sketch.addConstraint(Sketcher.Constraint('Horizontal',2))
+		sketch.addConstraint(Sketcher.Constraint('Distance',2,10.0))
+		sketch.addGeometry(Part.LineSegment(FreeCAD.Vector(0,50,0),FreeCAD.Vector(0,60,0)))
+		sketch.addConstraint(Sketcher.Constraint('Vertical',3))
+		sketch.addConstraint(Sketcher.Constraint('Distance',3,10.0))
+		self.assertEqual(sketch.solve(), 0)
+
+		def points():
+			return [(line.StartPoint, line.EndPoint) for line in sketch.Geometries]
+
+		def assertPointsEqual(pts1, pts2):
+			for (s1, e1), (s2, e2) in zip(pts1, pts2):
+				for v1, v2 in ((s1, s2), (e1, e2)):
+					self.assertAlmostEqual(v1.x, v2.x, 9)
+					self.assertAlmostEqual(v1.y, v2.y, 9)
+
+		others = points()[2:]
+		for k in range(1, 6):
+			self.assertEqual(sketch.movePoint(1,2,FreeCAD.Vector(10+k,10+0.5*k,0)), 0)
+			pts = points()
+			self.assertAlmostEqual(pts[0][0].Length, 0.0, 6)
+			self.assertAlmostEqual((pts[0][1]-pts[0][0]).Length, 10.0, 6)
+			self.assertAlmostEqual((pts[1][1]-pts[1][0]).Length, 10.0, 6)
+			self.assertAlmostEqual((pts[1][0]-pts[0][1]).Length, 0.0, 6)
+			assertPointsEqual(pts[2:], others)
+
+		# a failed step keeps the previous frame and the drag goes on from there
+		previous = points()
+		nan = float('nan')
+		self.assertNotEqual(sketch.movePoint(1,2,FreeCAD.Vector(nan,nan,0)), 0)
+		assertPointsEqual(points(), previous)
+		self.assertEqual(sketch.movePoint(1,2,FreeCAD.Vector(14,11,0)), 0)
+		pts = points()
+		self.assertAlmostEqual((pts[1][1]-pts[1][0]).Length, 10.0, 6)
+		assertPointsEqual(pts[2:], others)
+
 	def tearDown(self):
 		#closing doc
 		FreeCAD.closeDocument("SketchSolverTest")
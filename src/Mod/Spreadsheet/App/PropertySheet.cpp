@@ -71,6 +71,8 @@ void PropertySheet::clear()
     cellToPropertyNameMap.clear();
     documentObjectToCellMap.clear();
     cellToDocumentObjectMap.clear();
+    addressToCellMap.clear();
+    cellToAddressMap.clear();
     aliasProp.clear();
     revAliasProp.clear();
 
@@ -198,6 +200,8 @@ PropertySheet::PropertySheet(const PropertySheet &other)
     , cellToPropertyNameMap(other.cellToPropertyNameMap)
     , documentObjectToCellMap(other.documentObjectToCellMap)
     , cellToDocumentObjectMap(other.cellToDocumentObjectMap)
+    , addressToCellMap(other.addressToCellMap)
+    , cellToAddressMap(other.cellToAddressMap)
     , aliasProp(other.aliasProp)
     , revAliasProp(other.revAliasProp)
     , updateCount(other.updateCount)
@@ -986,8 +990,16 @@ void PropertySheet::addDependencies(CellAddress key)
             propertyNameToCellMap[propName].insert(key);
             cellToPropertyNameMap[key].insert(propName);
 
-            // Also an alias?
             if (docObj==owner && props.first.size()) {
+                // A cell of this sheet?
+                CellAddress addr = stringToAddress(props.first.c_str(), true);
+
+                if (addr.isValid()) {
+                    addressToCellMap[addr].insert(key);
+                    cellToAddressMap[key].insert(addr);
+                }
+
+                // Also an alias?
                 std::map<std::string, CellAddress>::const_iterator j = revAliasProp.find(props.first);
 
                 if (j != revAliasProp.end()) {
@@ -997,6 +1009,8 @@ void PropertySheet::addDependencies(CellAddress key)
                     // Insert into maps
                     propertyNameToCellMap[propName].insert(key);
                     cellToPropertyNameMap[key].insert(propName);
+                    addressToCellMap[j->second].insert(key);
+                    cellToAddressMap[key].insert(j->second);
                 }
             }
         }
@@ -1032,6 +1046,29 @@ void PropertySheet::removeDependencies(CellAddress key)
         cellToPropertyNameMap.erase(i1);
     }
 
+    /* Remove from cell <-> Key maps */
+
+    std::map<CellAddress, std::set< CellAddress > >::iterator i3 = cellToAddressMap.find(key);
+
+    if (i3 != cellToAddressMap.end()) {
+        std::set< CellAddress >::const_iterator j = i3->second.begin();
+
+        while (j != i3->second.end()) {
+            std::map<CellAddress, std::set< CellAddress > >::iterator k = addressToCellMap.find(*j);
+
+            if (k != addressToCellMap.end()) {
+                k->second.erase(key);
+
+                if (k->second.size() == 0)
+                    addressToCellMap.erase(k);
+            }
+
+            ++j;
+        }
+
+        cellToAddressMap.erase(i3);
+    }
+
     /* Remove from DocumentObject <-> Key maps */
 
     std::map<CellAddress, std::set< std::string > >::iterator i2 = cellToDocumentObjectMap.find(key);
@@ -1222,6 +1259,22 @@ const std::set<std::string> &PropertySheet::getDeps(CellAddress pos) const
         return empty;
 }
 
+/**
+  * Get the cells of this sheet that depend on the cell at \a pos, either
+  * through its address or its alias.
+  */
+
+const std::set<CellAddress> &PropertySheet::getDependentCells(CellAddress pos) const
+{
+    static std::set<CellAddress> empty;
+    std::map<CellAddress, std::set< CellAddress > >::const_iterator i = addressToCellMap.find(pos);
+
+    if (i != addressToCellMap.end())
+        return i->second;
+    else
+        return empty;
+}
+
 void PropertySheet::recomputeDependencies(CellAddress key)
 {
     AtomicPropertyChange signaller(*this);
@@ -154,6 +154,8 @@ public:
 
     const std::set<std::string> &getDeps(App::CellAddress pos) const;
 
+    const std::set<App::CellAddress> &getDependentCells(App::CellAddress pos) const;
+
     void recomputeDependencies(App::CellAddress key);
 
     PyObject *getPyObject(void) override;
@@ -242,6 +244,14 @@ private:
     /*! DocumentObject this cell depends on */
     std::map<App::CellAddress, std::set< std::string > > cellToDocumentObjectMap;
 
+    /*! Cell dependencies inside this sheet, i.e when the cell given in key
+      changes, the set of addresses needs to be recomputed.
+      */
+    std::map<App::CellAddress, std::set< App::CellAddress > > addressToCellMap;
+
+    /*! Cells of this sheet this cell depends on */
+    std::map<App::CellAddress, std::set< App::CellAddress > > cellToAddressMap;
+
     /*! Mapping of cell position to alias property */
     std::map<App::CellAddress, std::string> aliasProp;
 
@@ -54,6 +54,9 @@
 #include <boost/regex.hpp>
 #include <boost/bind.hpp>
 #include <deque>
+#include <numeric>
+#include <QThread>
+#include <QtConcurrentMap>
 
 FC_LOG_LEVEL_INIT("Spreadsheet",true,true);
 
@@ -662,20 +665,28 @@ struct CurrentAddressLock {
   * Update the Property given by \a key. This will also eventually trigger recomputations of cells depending on \a key.
   *
   * @param key The address of the cell we want to recompute.
+  * @param value The value of the cell expression, if it has already been computed.
   *
   */
 
-void Sheet::updateProperty(CellAddress key)
+void Sheet::updateProperty(CellAddress key, const Base::Quantity *value)
 {
     Cell * cell = getCell(key);
 
     if (cell != 0) {
         std::unique_ptr<Expression> output;
+        NumberExpression result(this);
         const Expression * input = cell->getExpression();
 
         if (input) {
             CurrentAddressLock lock(currentRow,currentCol,key);
-            output.reset(input->eval());
+            Base::Quantity quantity;
+            if (value)
+                result.setUnit(*value);
+            else if (input->evalQuantity(quantity))
+                result.setUnit(quantity);
+            else
+                output.reset(input->eval());
         }
         else {
             std::string s;
@@ -688,7 +699,7 @@ void Sheet::updateProperty(CellAddress key)
 
         /* Eval returns either NumberExpression or StringExpression, or
          * PyObjectExpression objects */
-        auto number = freecad_dynamic_cast<NumberExpression>(output.get());
+        auto number = output ? freecad_dynamic_cast<NumberExpression>(output.get()) : &result;
         if(number) {
             long l;
             if (!number->getUnit().isEmpty())
@@ -751,9 +762,10 @@ void Sheet::touchCells(Range range) {
 /**
  * @brief Recompute cell at address \a p.
  * @param p Address of cell.
+ * @param value Value of the cell expression, if it has already been computed.
  */
 
-void Sheet::recomputeCell(CellAddress p)
+void Sheet::recomputeCell(CellAddress p, const Base::Quantity *value)
 {
     Cell * cell = cells.getValue(p);
 
@@ -764,7 +776,7 @@ void Sheet::recomputeCell(CellAddress p)
             cell->setContent(content.c_str());
         }
 
-        updateProperty(p);
+        updateProperty(p, value);
 
         if(!cell || !cell->hasException()) {
             cells.clearDirty(p);
@@ -794,6 +806,50 @@ void Sheet::recomputeCell(CellAddress p)
         cellSpanChanged(p);
 }
 
+/**
+ * @brief Recompute the cells of one level of the dependency graph, i.e cells
+ * that do not depend on each other. For large levels, numeric expressions are
+ * evaluated in parallel first; the properties and aliases are then updated in
+ * order, as they may add or remove dynamic properties.
+ * @param level Addresses of the cells.
+ */
+
+void Sheet::recomputeCells(const std::vector<CellAddress> &level)
+{
+    static const std::size_t minParallelCells = 256;
+
+    std::vector<Base::Quantity> values;
+    std::vector<char> computed(level.size(), 0);
+
+    if (level.size() >= minParallelCells && QThread::idealThreadCount() > 1) {
+        values.resize(level.size());
+        std::vector<std::size_t> indices(level.size());
+        std::iota(indices.begin(), indices.end(), 0);
+
+        // Only properties that have been resolved before are read, so that
+        // nothing in the document is looked up or changed by the threads
+        QtConcurrent::blockingMap(indices, [&](std::size_t i) {
+            const Cell * cell = cells.getValue(level[i]);
+            if (!cell || cell->hasException())
+                return;
+
+            const Expression * input = cell->getExpression();
+            if (!input)
+                return;
+
+            try {
+                computed[i] = input->evalQuantity(values[i], true) ? 1 : 0;
+            }
+            catch (...) {
+                // evaluated again below to report the error
+            }
+        });
+    }
+
+    for (std::size_t i = 0; i < level.size(); ++i)
+        recomputeCell(level[i], computed[i] ? &values[i] : 0);
+}
+
 /**
   * Update the document properties.
   *
@@ -813,55 +869,68 @@ DocumentObjectExecReturn *Sheet::execute(void)
          dirtyCells.insert(*i);
     }
 
-    DependencyList graph;
-    std::map<CellAddress, Vertex> VertexList;
-    std::map<Vertex, CellAddress> VertexIndexList;
-    std::deque<CellAddress> workQueue(dirtyCells.begin(),dirtyCells.end());
-    while(workQueue.size()) {
-        CellAddress currPos = workQueue.front();
-        workQueue.pop_front();
-
-        // Insert into map of CellPos -> Index, if it doesn't exist already
-        auto res = VertexList.emplace(currPos,Vertex());
-        if(res.second) {
-            res.first->second = add_vertex(graph);
-            VertexIndexList[res.first->second] = currPos;
+    // Collect the cells depending on the dirty cells, with the edges between them
+    std::vector<CellAddress> nodes(dirtyCells.begin(), dirtyCells.end());
+    std::map<CellAddress, std::size_t> nodeIndex;
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+        nodeIndex[nodes[i]] = i;
+
+    std::vector<std::vector<std::size_t> > dependents;
+    std::vector<int> pending(nodes.size(), 0);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        std::vector<std::size_t> deps;
+        for(auto &dep : cells.getDependentCells(nodes[i])) {
+            auto res = nodeIndex.emplace(dep, nodes.size());
+            if(res.second) {
+                nodes.push_back(dep);
+                pending.push_back(0);
+                dirtyCells.insert(dep);
+            }
+            ++pending[res.first->second];
+            deps.push_back(res.first->second);
         }
+        dependents.push_back(std::move(deps));
+    }
 
-        // Process cells that depend on the current cell
-        for(auto &dep : providesTo(currPos)) {
-            auto resDep = VertexList.emplace(dep,Vertex());
-            if(resDep.second) {
-                resDep.first->second = add_vertex(graph);
-                VertexIndexList[resDep.first->second] = dep;
-                if(dirtyCells.insert(dep).second)
-                    workQueue.push_back(dep);
+    // Sort the cells topologically into levels of cells that do not depend
+    // on each other
+    std::vector<std::vector<CellAddress> > levels;
+    std::vector<std::size_t> level;
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (pending[i] == 0)
+            level.push_back(i);
+    }
+
+    std::size_t sorted = 0;
+    while (!level.empty()) {
+        std::vector<std::size_t> next;
+        levels.push_back(std::vector<CellAddress>());
+        for (auto i : level) {
+            levels.back().push_back(nodes[i]);
+            for (auto j : dependents[i]) {
+                if (--pending[j] == 0)
+                    next.push_back(j);
             }
-            // Add edge to graph to signal dependency
-            add_edge(res.first->second, resDep.first->second, graph);
         }
+        sorted += level.size();
+        level.swap(next);
     }
-    // Compute cells
-    std::list<Vertex> make_order;
-    // Sort graph topologically to find evaluation order
-    try {
-        boost::topological_sort(graph, std::front_inserter(make_order));
+
+    if (sorted == nodes.size()) {
         // Recompute cells
         FC_LOG("recomputing " << getFullName());
-        for(auto &pos : make_order) {
-            const auto &addr = VertexIndexList[pos];
-            FC_LOG(addr.toString());
-            recomputeCell(addr);
-        }
-    } catch (std::exception&) {
-        for(auto &v : VertexList) {
-            Cell * cell = cells.getValue(v.first);
+        for(auto &cellLevel : levels)
+            recomputeCells(cellLevel);
+    }
+    else {
+        for(auto &addr : nodes) {
+            Cell * cell = cells.getValue(addr);
             // Mark as erroneous
-            cellErrors.insert(v.first);
+            cellErrors.insert(addr);
             if (cell)
                 cell->setException("Pending computation due to cyclic dependency");
-            updateProperty(v.first);
-            updateAlias(v.first);
+            updateProperty(addr);
+            updateAlias(addr);
         }
 
         // Try to be more user friendly by finding individual loops
@@ -888,7 +957,7 @@ DocumentObjectExecReturn *Sheet::execute(void)
                 }
 
                 // Process cells that depend on the current cell
-                for(auto &dep : providesTo(currPos)) {
+                for(auto &dep : cells.getDependentCells(currPos)) {
                     auto resDep = VertexList.emplace(dep,Vertex());
                     if(resDep.second) {
                         resDep.first->second = add_vertex(graph);
@@ -1348,7 +1417,7 @@ std::set<std::string> Sheet::dependsOn(CellAddress address) const
 void Sheet::providesTo(CellAddress address, std::set<std::string> & result) const
 {
     std::string fullName = getFullName() + ".";
-    std::set<CellAddress> tmpResult = cells.getDeps(fullName + address.toString());
+    const std::set<CellAddress> &tmpResult = cells.getDependentCells(address);
 
     for (std::set<CellAddress>::const_iterator i = tmpResult.begin(); i != tmpResult.end(); ++i)
         result.insert(fullName + i->toString());
@@ -1362,7 +1431,7 @@ void Sheet::providesTo(CellAddress address, std::set<std::string> & result) cons
 
 std::set<CellAddress>  Sheet::providesTo(CellAddress address) const
 {
-    return cells.getDeps(getFullName()+"."+address.toString());
+    return cells.getDependentCells(address);
 }
 
 void Sheet::onDocumentRestored()
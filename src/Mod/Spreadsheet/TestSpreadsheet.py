@@ -870,6 +870,26 @@ class SpreadsheetCases(unittest.TestCase):
         self.doc.recompute()
         self.assertEqual(sheet.get('C1'), Units.Quantity('3 mm'))
 
+    def testRecomputeLevels(self):
+        """ Cells depending on each other are recomputed in order, also when many cells are on the same level """
+        sheet = self.doc.addObject('Spreadsheet::Sheet','Spreadsheet')
+        sheet.set('A1', '2mm')
+        sheet.setAlias('A1', 'length')
+        for i in range(1, 301):
+            sheet.set('B{}'.format(i), '=length * {}'.format(i))
+            sheet.set('C{}'.format(i), '=B{} + A1'.format(i))
+        sheet.set('D1', '=sum(C1:C300)')
+        self.doc.recompute()
+        self.assertEqual(sheet.B300, Units.Quantity('600 mm'))
+        self.assertEqual(sheet.C300, Units.Quantity('602 mm'))
+        self.assertEqual(sheet.D1, Units.Quantity('90900 mm'))
+
+        sheet.set('A1', '3mm')
+        self.doc.recompute()
+        self.assertEqual(sheet.B300, Units.Quantity('900 mm'))
+        self.assertEqual(sheet.C300, Units.Quantity('903 mm'))
+        self.assertEqual(sheet.D1, Units.Quantity('136350 mm'))
+
 
     def tearDown(self):
         #closing doc
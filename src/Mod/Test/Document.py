@@ -608,6 +608,198 @@ class DocumentRecomputeCases(unittest.TestCase):
     self.Doc.removeObject(L7.Name)
     self.Doc.removeObject(L8.Name)
 
+  def testParallelRecompute(self):
+    # same graph as testRecompute, but scheduled by the parallel recompute
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    parallel = param.GetBool("ParallelRecompute",False)
+    param.SetBool("ParallelRecompute",True)
+    try:
+      L1 = self.Doc.addObject("App::FeatureTest","Label_1")
+      L2 = self.Doc.addObject("App::FeatureTest","Label_2")
+      L3 = self.Doc.addObject("App::FeatureTest","Label_3")
+      L4 = self.Doc.addObject("App::FeatureTest","Label_4")
+      L5 = self.Doc.addObject("App::FeatureTest","Label_5")
+      L6 = self.Doc.addObject("App::FeatureTest","Label_6")
+      L1.LinkList = [L2,L3,L6]
+      L2.Link = L4
+      L2.LinkList = [L5]
+      L3.LinkList = [L5,L6]
+
+      self.failUnless(self.Doc.recompute()==6)
+      self.failUnless((1, 1, 1, 1, 1, 1)==(L1.ExecCount,L2.ExecCount,L3.ExecCount,L4.ExecCount,L5.ExecCount,L6.ExecCount))
+      L5.enforceRecompute()
+      self.failUnless(self.Doc.recompute()==4)
+      self.failUnless((2, 2, 2, 1, 2, 1)==(L1.ExecCount,L2.ExecCount,L3.ExecCount,L4.ExecCount,L5.ExecCount,L6.ExecCount))
+      L6.enforceRecompute()
+      self.failUnless(self.Doc.recompute()==3)
+      self.failUnless((3, 2, 3, 1, 2, 2)==(L1.ExecCount,L2.ExecCount,L3.ExecCount,L4.ExecCount,L5.ExecCount,L6.ExecCount))
+
+      # an error must stop the recompute of the dependent objects only
+      L4.ExceptionType = 2
+      L6.enforceRecompute()
+      self.failUnless(self.Doc.recompute()==3)
+      self.failUnless((3, 2, 4, 1, 2, 3)==(L1.ExecCount,L2.ExecCount,L3.ExecCount,L4.ExecCount,L5.ExecCount,L6.ExecCount))
+      L4.ExceptionType = 0
+    finally:
+      param.SetBool("ParallelRecompute",parallel)
+
+  def testParallelRecomputeWorker(self):
+    # FeatureTestConcurrent is recomputed on the worker threads, FeatureTest
+    # on the main thread in between
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    parallel = param.GetBool("ParallelRecompute",False)
+    threads = param.GetInt("RecomputeThreads",0)
+    param.SetBool("ParallelRecompute",True)
+    param.SetInt("RecomputeThreads",4)
+    try:
+      L1 = self.Doc.addObject("App::FeatureTestConcurrent","Worker_1")
+      L2 = self.Doc.addObject("App::FeatureTestConcurrent","Worker_2")
+      L3 = self.Doc.addObject("App::FeatureTestConcurrent","Worker_3")
+      L4 = self.Doc.addObject("App::FeatureTestConcurrent","Worker_4")
+      L5 = self.Doc.addObject("App::FeatureTest","Main_5")
+      L1.LinkList = [L2,L3]
+      L2.Link = L4
+      L3.Link = L4
+      L3.LinkList = [L5]
+
+      self.failUnless(self.Doc.recompute()==5)
+      self.failUnless((1, 1, 1, 1, 1)==(L1.ExecCount,L2.ExecCount,L3.ExecCount,L4.ExecCount,L5.ExecCount))
+      self.failUnless((True, True, True, True)==(L1.ExecOnWorker,L2.ExecOnWorker,L3.ExecOnWorker,L4.ExecOnWorker))
+
+      # an error on a worker must stop the recompute of the dependent objects only
+      L2.ExceptionType = 2
+      L4.enforceRecompute()
+      self.failUnless(self.Doc.recompute()==3)
+      self.failUnless((1, 1, 2, 2, 1)==(L1.ExecCount,L2.ExecCount,L3.ExecCount,L4.ExecCount,L5.ExecCount))
+      L2.ExceptionType = 0
+      self.failUnless(self.Doc.recompute()==2)
+      self.failUnless((2, 2, 2, 2, 1)==(L1.ExecCount,L2.ExecCount,L3.ExecCount,L4.ExecCount,L5.ExecCount))
+    finally:
+      param.SetBool("ParallelRecompute",parallel)
+      param.SetInt("RecomputeThreads",threads)
+
+  def testRecomputeOrder(self):
+    # objects linking to objects created later must be reordered
+    L1 = self.Doc.addObject("App::FeatureTest","Label_1")
+    L2 = self.Doc.addObject("App::FeatureTest","Label_2")
+    L3 = self.Doc.addObject("App::FeatureTest","Label_3")
+    L4 = self.Doc.addObject("App::FeatureTest","Label_4")
+    L5 = self.Doc.addObject("App::FeatureTest","Label_5")
+    L3.Link = L4
+    L1.Link = L2
+    L2.LinkList = [L3]
+    deps = FreeCAD.getDependentObjects(L1,1)
+    self.failUnless([o.Name for o in deps]==[L4.Name,L3.Name,L2.Name,L1.Name])
+
+    self.failUnless(self.Doc.recompute()==5)
+    self.failUnless((1, 1, 1, 1, 1)==(L1.ExecCount,L2.ExecCount,L3.ExecCount,L4.ExecCount,L5.ExecCount))
+    # only the touched object and its dependent objects are recomputed
+    L3.enforceRecompute()
+    self.failUnless(self.Doc.recompute()==3)
+    self.failUnless((2, 2, 2, 1, 1)==(L1.ExecCount,L2.ExecCount,L3.ExecCount,L4.ExecCount,L5.ExecCount))
+
+    # relink to an object ordered after all others
+    L2.LinkList = []
+    L4.Link = L5
+    L5.LinkList = [L1]
+    deps = FreeCAD.getDependentObjects(L5,1)
+    self.failUnless([o.Name for o in deps]==[L2.Name,L1.Name,L5.Name])
+    deps = FreeCAD.getDependentObjects(L3,1)
+    self.failUnless([o.Name for o in deps]==[L2.Name,L1.Name,L5.Name,L4.Name,L3.Name])
+    self.failUnless(self.Doc.recompute()==5)
+
+  def testRecomputeSideEffectTouch(self):
+    class Toucher():
+      def __init__(self, obj):
+        obj.addProperty("App::PropertyString","Target")
+        obj.Proxy = self
+      def execute(self, obj):
+        if obj.Target:
+          obj.Document.getObject(obj.Target).touch()
+
+    T = self.Doc.addObject("App::FeaturePython","Toucher")
+    Toucher(T)
+    L1 = self.Doc.addObject("App::FeatureTest","Label_1")
+    L2 = self.Doc.addObject("App::FeatureTest","Label_2")
+    L2.Link = L1
+    self.Doc.recompute()
+    self.failUnless((1, 1)==(L1.ExecCount,L2.ExecCount))
+
+    # L1 does not depend on T, but is touched while T executes
+    T.Target = L1.Name
+    self.failUnless(self.Doc.recompute()==3)
+    self.failUnless((2, 2)==(L1.ExecCount,L2.ExecCount))
+    for obj in (T,L1,L2):
+      self.failUnless(not 'Touched' in obj.State)
+
+  def testRecomputeListSize(self):
+    class Toucher():
+      def __init__(self, obj):
+        obj.addProperty("App::PropertyString","Target")
+        obj.Proxy = self
+      def execute(self, obj):
+        if obj.Target:
+          obj.Document.getObject(obj.Target).touch()
+
+    others = [self.Doc.addObject("App::FeatureTest","Other") for i in range(20)]
+    T = self.Doc.addObject("App::FeaturePython","Toucher")
+    Toucher(T)
+    L1 = self.Doc.addObject("App::FeatureTest","Label_1")
+    L2 = self.Doc.addObject("App::FeatureTest","Label_2")
+    L2.Link = L1
+    self.Doc.recompute()
+
+    # only the changed object is queued
+    others[0].Integer = 1
+    self.failUnless(self.Doc.recompute()==1)
+    self.failUnless(self.Doc.RecomputeListSize == 1)
+
+    # an object touched as a side effect only adds itself and its dependent
+    # objects instead of queuing the whole document
+    T.Target = L1.Name
+    self.failUnless(self.Doc.recompute()==3)
+    self.failUnless(self.Doc.RecomputeListSize == 3)
+    self.failUnless((2, 2)==(L1.ExecCount,L2.ExecCount))
+    for obj in others + [T,L1,L2]:
+      self.failUnless(not 'Touched' in obj.State)
+
+  def testRecomputeProfile(self):
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    profile = param.GetBool("RecomputeProfile",False)
+    param.SetBool("RecomputeProfile",True)
+    try:
+      L1 = self.Doc.addObject("App::FeatureTest","Label_1")
+      L2 = self.Doc.addObject("App::FeatureTest","Label_2")
+      L3 = self.Doc.addObject("App::FeatureTest","Label_3")
+      L4 = self.Doc.addObject("App::FeatureTest","Label_4")
+      L1.LinkList = [L2,L3]
+      L2.Link = L4
+      self.Doc.recompute()
+      records = self.Doc.getRecomputeProfile()
+      self.failUnless(len(records) == 4)
+      names = [r["object"].split('#')[-1] for r in records]
+      self.failUnless(names.index(L4.Name) < names.index(L2.Name) < names.index(L1.Name))
+      # the critical path ends at the root and contains one leaf only
+      critical = [r["object"].split('#')[-1] for r in records if r["critical"]]
+      self.failUnless(L1.Name in critical)
+      self.failUnless((L3.Name in critical) != (L4.Name in critical))
+
+      L3.Integer = 5
+      self.Doc.recompute()
+      records = self.Doc.getRecomputeProfile()
+      self.failUnless(len(records) == 2)
+      self.failUnless("Integer" in records[0]["reason"])
+
+      import json
+      fn = os.path.join(tempfile.gettempdir(),"RecomputeProfile.json")
+      self.Doc.saveRecomputeProfile(fn)
+      with open(fn) as f:
+        trace = json.load(f)
+      os.remove(fn)
+      self.failUnless(len(trace["traceEvents"]) == 2)
+    finally:
+      param.SetBool("RecomputeProfile",profile)
+
   def tearDown(self):
     #closing doc
     FreeCAD.closeDocument("RecomputeTests")
@@ -908,6 +1100,59 @@ class UndoRedoCases(unittest.TestCase):
     self.Doc.undo()
     self.failUnless(self.Doc.recompute() >= 0)
 
+  def testUndoListDelta(self):
+    # undo steps of lists only keep the changed elements
+    self.Doc.UndoMode = 1
+    obj = self.Doc.getObject("Base")
+    values = [float(i) for i in range(10000)]
+    obj.FloatList = values
+    obj.IntegerList = list(range(10000))
+
+    self.Doc.openTransaction("Change")
+    changed = list(values)
+    changed[5] = -1.0
+    obj.FloatList = changed
+    obj.IntegerList = list(range(9990))
+    self.Doc.commitTransaction()
+    self.failUnless(self.Doc.UndoRedoMemSize < 10000 * 8)
+
+    self.Doc.undo()
+    self.assertEqual(obj.FloatList, values)
+    self.assertEqual(obj.IntegerList, list(range(10000)))
+    self.Doc.redo()
+    self.assertEqual(obj.FloatList, changed)
+    self.assertEqual(obj.IntegerList, list(range(9990)))
+    self.Doc.undo()
+    self.assertEqual(obj.FloatList, values)
+
+  def testUndoListDeltaChangedSince(self):
+    # a list changed outside of a transaction must still be undone
+    self.Doc.UndoMode = 1
+    obj = self.Doc.getObject("Base")
+    values = [float(i) for i in range(10000)]
+    obj.FloatList = values
+
+    self.Doc.openTransaction("Change1")
+    changed1 = list(values)
+    changed1[5] = -1.0
+    obj.FloatList = changed1
+    self.Doc.commitTransaction()
+    self.Doc.openTransaction("Change2")
+    changed2 = list(changed1)
+    changed2[6] = -2.0
+    obj.FloatList = changed2
+    self.Doc.commitTransaction()
+
+    changed3 = list(changed2)
+    changed3[7] = -3.0
+    obj.FloatList = changed3
+    self.Doc.undo()
+    self.assertEqual(obj.FloatList, changed1)
+    self.Doc.undo()
+    self.assertEqual(obj.FloatList, values)
+    self.Doc.redo()
+    self.assertEqual(obj.FloatList, changed1)
+
   def tearDown(self):
     # closing doc
     FreeCAD.closeDocument("UndoTest")
@@ -1393,6 +1638,27 @@ class DocumentExpressionCases(unittest.TestCase):
     # must not raise a topological error
     self.assertEqual(self.Doc.recompute(), 2)
 
+  def testNumericExpression(self):
+    p1 = self.Doc.addObject("App::FeaturePython", "params1")
+    p1.addProperty("App::PropertyFloat", "a")
+    p1.addProperty("App::PropertyLength", "l")
+    p1.addProperty("App::PropertyFloat", "b")
+    p1.a = 2
+    p1.l = 3
+    p1.setExpression('b', u'a > 1 ? hypot(l / 1mm, 4) + a ^ 2 : -1')
+    self.Doc.recompute()
+    self.assertAlmostEqual(p1.b, 9)
+    p1.a = 1
+    self.Doc.recompute()
+    self.assertAlmostEqual(p1.b, -1)
+
+    # the property must be looked up again after it was replaced
+    p1.removeProperty('a')
+    p1.addProperty("App::PropertyInteger", "a")
+    p1.a = 3
+    self.Doc.recompute()
+    self.assertAlmostEqual(p1.b, 14)
+
   def tearDown(self):
     #closing doc
     FreeCAD.closeDocument(self.Doc.Name)
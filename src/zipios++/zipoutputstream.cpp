@@ -56,6 +56,12 @@ void ZipOutputStream::putNextEntry(const std::string& entryName) {
 }
 
 
+void ZipOutputStream::putRawEntry( const std::string &entryName, const std::string &data,
+                                   uint32 crc, uint32 size ) {
+  ozf->putRawEntry( ZipCDirEntry( entryName ), data, crc, size ) ;
+}
+
+
 void ZipOutputStream::setComment( const std::string &comment ) {
   ozf->setComment( comment ) ;
 }
@@ -66,11 +72,21 @@ void ZipOutputStream::setLevel( int level ) {
 }
 
 
+int ZipOutputStream::getLevel() const {
+  return ozf->getLevel() ;
+}
+
+
 void ZipOutputStream::setMethod( StorageMethod method ) {
   ozf->setMethod( method ) ;
 }
 
 
+StorageMethod ZipOutputStream::getMethod() const {
+  return ozf->getMethod() ;
+}
+
+
 ZipOutputStream::~ZipOutputStream() {
   // It's ok to call delete with a Null pointer.
   delete ozf ;
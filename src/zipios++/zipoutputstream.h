@@ -54,16 +54,27 @@ public:
   */
   void putNextEntry(const std::string& entryName);
 
+  /** Writes an entry whose data has already been compressed, see
+      ZipOutputStreambuf::putRawEntry(). */
+  void putRawEntry( const std::string &entryName, const std::string &data,
+                    uint32 crc, uint32 size ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const std::string& comment ) ;
 
   /** Sets the compression level to be used for subsequent entries. */
   void setLevel( int level ) ;
 
+  /** Returns the compression level. */
+  int getLevel() const ;
+
   /** Sets the compression method to be used. only STORED and DEFLATED are
       supported. */
   void setMethod( StorageMethod method ) ;
 
+  /** Returns the compression method. */
+  StorageMethod getMethod() const ;
+
   /** Destructor. */
   virtual ~ZipOutputStream() ;
 
@@ -81,6 +81,29 @@ void ZipOutputStreambuf::putNextEntry( const ZipCDirEntry &entry ) {
 }
 
 
+void ZipOutputStreambuf::putRawEntry( const ZipCDirEntry &entry, const string &data,
+                                      uint32 crc, uint32 size ) {
+  if ( _open_entry )
+    closeEntry() ;
+
+  _entries.push_back( entry ) ;
+  ZipCDirEntry &ent = _entries.back() ;
+
+  ostream os( _outbuf ) ;
+
+  // The sizes are known in advance, so the header is written only once
+  ent.setLocalHeaderOffset( os.tellp() ) ;
+  ent.setMethod( _method ) ;
+  ent.setSize( size ) ;
+  ent.setCrc( crc ) ;
+  ent.setCompressedSize( static_cast< uint32 >( data.size() ) ) ;
+  ent.setTime( currentDosTime() ) ;
+
+  os << static_cast< ZipLocalEntry >( ent ) ;
+  os.write( data.data(), data.size() ) ;
+}
+
+
 void ZipOutputStreambuf::setComment( const string &comment ) {
   _zip_comment = comment ;
 }
@@ -91,6 +114,16 @@ void ZipOutputStreambuf::setLevel( int level ) {
 }
 
 
+int ZipOutputStreambuf::getLevel() const {
+  return _level ;
+}
+
+
+StorageMethod ZipOutputStreambuf::getMethod() const {
+  return _method ;
+}
+
+
 void ZipOutputStreambuf::setMethod( StorageMethod method ) {
   _method = method ;
   if( method == STORED )
@@ -146,6 +179,16 @@ void ZipOutputStreambuf::updateEntryHeaderInfo() {
   entry.setCompressedSize( curr_pos - entry.getLocalHeaderOffset() 
 			   - entry.getLocalHeaderSize() ) ;
 
+  entry.setTime( currentDosTime() ) ;
+
+  // write ZipLocalEntry header to header position
+  os.seekp( entry.getLocalHeaderOffset() ) ;
+  os << static_cast< ZipLocalEntry >( entry ) ;
+  os.seekp( curr_pos ) ;
+}
+
+
+int ZipOutputStreambuf::currentDosTime() {
   // Mark Donszelmann: added current date and time
   time_t ltime;
   time( &ltime );
@@ -153,12 +196,7 @@ void ZipOutputStreambuf::updateEntryHeaderInfo() {
   now = localtime( &ltime );
   int dosTime = (now->tm_year - 80) << 25 | (now->tm_mon + 1) << 21 | now->tm_mday << 16 |
               now->tm_hour << 11 | now->tm_min << 5 | now->tm_sec >> 1;
-  entry.setTime(dosTime);
-
-  // write ZipLocalEntry header to header position
-  os.seekp( entry.getLocalHeaderOffset() ) ;
-  os << static_cast< ZipLocalEntry >( entry ) ;
-  os.seekp( curr_pos ) ;
+  return dosTime ;
 }
 
 
@@ -49,16 +49,31 @@ public:
       entry. */
   void putNextEntry( const ZipCDirEntry &entry ) ;
 
+  /** Writes an entry whose data has already been compressed with the
+      current method and level, e.g. on another thread.
+      @param entry the entry to write.
+      @param data the raw deflated (or stored) data of the entry.
+      @param crc the CRC-32 of the uncompressed data.
+      @param size the size of the uncompressed data. */
+  void putRawEntry( const ZipCDirEntry &entry, const string &data,
+                    uint32 crc, uint32 size ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const string &comment ) ;
 
   /** Sets the compression level to be used for subsequent entries. */
   void setLevel( int level ) ;
 
+  /** Returns the compression level. */
+  int getLevel() const ;
+
   /** Sets the compression method to be used. only STORED and DEFLATED are
       supported. */
   void setMethod( StorageMethod method ) ;
 
+  /** Returns the compression method. */
+  StorageMethod getMethod() const ;
+
   /** Destructor. */
   virtual ~ZipOutputStreambuf() ;
 
@@ -68,6 +83,7 @@ protected:
 
   void setEntryClosedState() ;
   void updateEntryHeaderInfo() ;
+  static int currentDosTime() ;
 
   // Should/could be moved to zipheadio.h ?!
   static void writeCentralDirectory( const vector< ZipCDirEntry > &entries, 